@@ -0,0 +1,13 @@
+using ScriptBox.Core.Runtime;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Host API whose handler does no work, so host call benchmarks measure the round trip.
+/// </summary>
+[SandboxApi("bench")]
+public static class BenchApi
+{
+    [SandboxMethod("add")]
+    public static int Add(int a, int b) => a + b;
+}
@@ -0,0 +1,50 @@
+using ScriptBox.Core.Configuration;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Builders shared by the benchmarks, so every suite measures the same configuration.
+/// </summary>
+internal static class BenchmarkSetup
+{
+    private static readonly Lazy<WasmBuildProfile[]> EmbeddedProfiles = new(FindEmbeddedProfiles);
+
+    /// <summary>
+    /// The embedded module builds (-O0 debug, optimized release) this package contains.
+    /// Release is only embedded when the module was built with <c>build.sh --release</c>.
+    /// </summary>
+    public static IEnumerable<WasmBuildProfile> Profiles => EmbeddedProfiles.Value;
+
+    /// <summary>
+    /// A builder without startup scripts, so runs measure ScriptBox rather than the SDK bootstrap.
+    /// </summary>
+    public static ScriptBoxBuilder CreateBuilder(WasmBuildProfile profile) =>
+        ScriptBoxBuilder
+            .Create()
+            .WithBuildProfile(profile)
+            .WithSandboxConfiguration(new SandboxConfiguration
+            {
+                SandboxDirectory = Path.Combine(Path.GetTempPath(), "scriptbox-benchmarks"),
+                StartupScripts = new List<string>()
+            })
+            .WithExecutionTimeout(TimeSpan.FromMinutes(1));
+
+    private static WasmBuildProfile[] FindEmbeddedProfiles()
+    {
+        var profiles = new List<WasmBuildProfile>();
+        foreach (var profile in Enum.GetValues<WasmBuildProfile>())
+        {
+            try
+            {
+                CreateBuilder(profile).Build().DisposeAsync().AsTask().GetAwaiter().GetResult();
+                profiles.Add(profile);
+            }
+            catch (InvalidOperationException)
+            {
+                // Profile not embedded in this build of the package.
+            }
+        }
+
+        return profiles.ToArray();
+    }
+}
@@ -0,0 +1,30 @@
+using BenchmarkDotNet.Attributes;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Cost of <see cref="ScriptBoxBuilder.Build"/> (module compile, startup bootstrap) and of
+/// the first script on a fresh box, which also instantiates the first WASM instance.
+/// </summary>
+[MemoryDiagnoser]
+public class ColdStartBenchmarks
+{
+    public static IEnumerable<WasmBuildProfile> Profiles => BenchmarkSetup.Profiles;
+
+    [ParamsSource(nameof(Profiles))]
+    public WasmBuildProfile Profile { get; set; }
+
+    [Benchmark(Baseline = true)]
+    public async Task Build()
+    {
+        await using var scriptBox = BenchmarkSetup.CreateBuilder(Profile).Build();
+    }
+
+    [Benchmark]
+    public async Task<object?> BuildAndRunFirstScript()
+    {
+        await using var scriptBox = BenchmarkSetup.CreateBuilder(Profile).Build();
+        await using var session = scriptBox.CreateSession();
+        return await session.RunAsync("return 1;");
+    }
+}
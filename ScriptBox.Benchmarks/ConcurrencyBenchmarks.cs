@@ -0,0 +1,58 @@
+using BenchmarkDotNet.Attributes;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Throughput of one box serving <see cref="Parallelism"/> callers at once. Each invocation
+/// runs <see cref="Scripts"/> short scripts, so times compare directly across parallelism levels.
+/// </summary>
+[MemoryDiagnoser]
+public class ConcurrencyBenchmarks
+{
+    private const int Scripts = 256;
+
+    private const string Script =
+        "let sum = 0; for (let i = 0; i < 1000; i++) sum += i; return sum;";
+
+    private static readonly string[] Batch = Enumerable.Repeat(Script, Scripts).ToArray();
+
+    private IScriptBox _scriptBox = null!;
+
+    public static IEnumerable<WasmBuildProfile> Profiles => BenchmarkSetup.Profiles;
+
+    [ParamsSource(nameof(Profiles))]
+    public WasmBuildProfile Profile { get; set; }
+
+    [Params(1, 8, 64)]
+    public int Parallelism { get; set; }
+
+    [GlobalSetup]
+    public async Task Setup()
+    {
+        _scriptBox = BenchmarkSetup.CreateBuilder(Profile)
+            .WithInstancePool(Parallelism, Parallelism)
+            .Build();
+        await Sessions();
+    }
+
+    [GlobalCleanup]
+    public Task Cleanup() => _scriptBox.DisposeAsync().AsTask();
+
+    /// <summary>
+    /// Independent callers, each with its own session, as concurrent requests would be.
+    /// </summary>
+    [Benchmark(Baseline = true, OperationsPerInvoke = Scripts)]
+    public Task Sessions() =>
+        Task.WhenAll(Enumerable.Range(0, Parallelism).Select(async worker =>
+        {
+            await using var session = _scriptBox.CreateSession();
+            for (var i = worker; i < Scripts; i += Parallelism)
+            {
+                await session.RunAsync(Script);
+            }
+        }));
+
+    [Benchmark(OperationsPerInvoke = Scripts)]
+    public Task<IReadOnlyList<ScriptExecutionResult>> Batched() =>
+        _scriptBox.ExecuteBatchAsync(Batch, Parallelism);
+}
@@ -0,0 +1,57 @@
+using BenchmarkDotNet.Attributes;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Scripts on a warm box: a trivial script shows the fixed cost of a run (context, bootstrap,
+/// result), a CPU-heavy one the speed of the interpreter in each module build.
+/// </summary>
+[MemoryDiagnoser]
+public class EvaluationBenchmarks
+{
+    private const string CpuHeavyScript = @"
+function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+let primes = 0;
+for (let i = 2; i < 20000; i++) {
+    let prime = true;
+    for (let j = 2; j * j <= i; j++) {
+        if (i % j === 0) { prime = false; break; }
+    }
+    if (prime) primes++;
+}
+return fib(22) + primes;";
+
+    private IScriptBox _scriptBox = null!;
+    private ScriptSession _session = null!;
+    private PreparedScript _prepared = null!;
+
+    public static IEnumerable<WasmBuildProfile> Profiles => BenchmarkSetup.Profiles;
+
+    [ParamsSource(nameof(Profiles))]
+    public WasmBuildProfile Profile { get; set; }
+
+    [GlobalSetup]
+    public async Task Setup()
+    {
+        _scriptBox = BenchmarkSetup.CreateBuilder(Profile).Build();
+        _session = _scriptBox.CreateSession();
+        _prepared = _scriptBox.Prepare("return input.a + input.b;");
+        await _session.RunAsync(CpuHeavyScript);
+    }
+
+    [GlobalCleanup]
+    public async Task Cleanup()
+    {
+        await _session.DisposeAsync();
+        await _scriptBox.DisposeAsync();
+    }
+
+    [Benchmark(Baseline = true)]
+    public Task<object?> Trivial() => _session.RunAsync("return 1 + 1;");
+
+    [Benchmark]
+    public Task<object?> Prepared() => _session.RunAsync(_prepared, new { a = 1, b = 2 });
+
+    [Benchmark]
+    public Task<object?> CpuHeavy() => _session.RunAsync(CpuHeavyScript);
+}
@@ -0,0 +1,51 @@
+using BenchmarkDotNet.Attributes;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Host call round trips: one script makes <see cref="CallsPerScript"/> calls to a handler
+/// that does no work, so the reported time per operation is one guest-to-host-and-back call.
+/// </summary>
+[MemoryDiagnoser]
+public class HostCallBenchmarks
+{
+    private const int CallsPerScript = 1000;
+
+    private static readonly string Script =
+        $"let sum = 0; for (let i = 0; i < {CallsPerScript}; i++) sum = bench.add(sum, 1); return sum;";
+
+    private IScriptBox _scriptBox = null!;
+    private ScriptSession _session = null!;
+
+    public static IEnumerable<WasmBuildProfile> Profiles => BenchmarkSetup.Profiles;
+
+    [ParamsSource(nameof(Profiles))]
+    public WasmBuildProfile Profile { get; set; }
+
+    /// <summary>
+    /// Binary (MessagePack) host call frames instead of JSON.
+    /// </summary>
+    [Params(false, true)]
+    public bool BinaryHostCalls { get; set; }
+
+    [GlobalSetup]
+    public async Task Setup()
+    {
+        _scriptBox = BenchmarkSetup.CreateBuilder(Profile)
+            .WithBinaryHostCalls(BinaryHostCalls)
+            .RegisterApisFrom(typeof(BenchApi))
+            .Build();
+        _session = _scriptBox.CreateSession();
+        await _session.RunAsync(Script);
+    }
+
+    [GlobalCleanup]
+    public async Task Cleanup()
+    {
+        await _session.DisposeAsync();
+        await _scriptBox.DisposeAsync();
+    }
+
+    [Benchmark(OperationsPerInvoke = CallsPerScript)]
+    public Task<object?> RoundTrip() => _session.RunAsync(Script);
+}
@@ -0,0 +1,60 @@
+using BenchmarkDotNet.Attributes;
+
+namespace ScriptBox.Benchmarks;
+
+/// <summary>
+/// Returning results from 1KB to 10MB, either as one string or as an array of records,
+/// which exercises JSON or structured (MessagePack) result encoding.
+/// </summary>
+[MemoryDiagnoser]
+public class PayloadBenchmarks
+{
+    private IScriptBox _scriptBox = null!;
+    private ScriptSession _session = null!;
+    private string _stringScript = null!;
+    private string _recordsScript = null!;
+
+    public static IEnumerable<WasmBuildProfile> Profiles => BenchmarkSetup.Profiles;
+
+    [ParamsSource(nameof(Profiles))]
+    public WasmBuildProfile Profile { get; set; }
+
+    [Params(1024, 64 * 1024, 1024 * 1024, 10 * 1024 * 1024)]
+    public int Bytes { get; set; }
+
+    [Params(false, true)]
+    public bool StructuredResults { get; set; }
+
+    [GlobalSetup]
+    public async Task Setup()
+    {
+        _scriptBox = BenchmarkSetup.CreateBuilder(Profile)
+            .WithStructuredResults(StructuredResults)
+            .Build();
+        _session = _scriptBox.CreateSession();
+
+        _stringScript = $"return 'x'.repeat({Bytes});";
+
+        // About 32 bytes of JSON per record.
+        _recordsScript = $@"
+const rows = new Array({Math.Max(1, Bytes / 32)});
+for (let i = 0; i < rows.length; i++) rows[i] = {{ id: i, name: 'row' + i }};
+return rows;";
+
+        await _session.RunAsync(_stringScript);
+        await _session.RunAsync(_recordsScript);
+    }
+
+    [GlobalCleanup]
+    public async Task Cleanup()
+    {
+        await _session.DisposeAsync();
+        await _scriptBox.DisposeAsync();
+    }
+
+    [Benchmark(Baseline = true)]
+    public Task<object?> String() => _session.RunAsync(_stringScript);
+
+    [Benchmark]
+    public Task<object?> Records() => _session.RunAsync(_recordsScript);
+}
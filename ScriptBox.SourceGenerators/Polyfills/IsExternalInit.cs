@@ -0,0 +1,6 @@
+#if NETSTANDARD2_0 || NETSTANDARD2_1
+namespace System.Runtime.CompilerServices
+{
+    internal static class IsExternalInit { }
+}
+#endif
@@ -0,0 +1,373 @@
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace ScriptBox.SourceGenerators;
+
+/// <summary>
+/// Emits typed handlers and the JS proxy for every <c>[SandboxApi]</c> class, plus a module
+/// initializer that registers them with <c>GeneratedSandboxApiRegistry</c>. Types the generator
+/// cannot bind (generic, inaccessible, by-ref parameters, <c>HostCallContext</c> parameters)
+/// are skipped and keep using the reflection scanner.
+/// </summary>
+[Generator(LanguageNames.CSharp)]
+public sealed class SandboxApiGenerator : IIncrementalGenerator
+{
+    private const string SandboxApiAttribute = "ScriptBox.Core.Runtime.SandboxApiAttribute";
+    private const string SandboxMethodAttribute = "ScriptBox.Core.Runtime.SandboxMethodAttribute";
+    private const string HostCallContext = "ScriptBox.Core.Runtime.HostCallContext";
+    private const string Registry = "ScriptBox.Core.Runtime.GeneratedSandboxApiRegistry";
+    private const string ModuleInitializerAttribute = "System.Runtime.CompilerServices.ModuleInitializerAttribute";
+    private const string RuntimeNamespace = "global::ScriptBox.Core.Runtime.";
+
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        var enabled = context.CompilationProvider.Select(static (compilation, _) =>
+            compilation.GetTypeByMetadataName(Registry) is not null &&
+            compilation.GetTypeByMetadataName(ModuleInitializerAttribute) is not null &&
+            compilation is CSharpCompilation { LanguageVersion: >= LanguageVersion.CSharp9 });
+
+        var apis = context.SyntaxProvider
+            .ForAttributeWithMetadataName(
+                SandboxApiAttribute,
+                static (node, _) => node is ClassDeclarationSyntax,
+                static (ctx, ct) => CreateModel(ctx, ct))
+            .Where(static model => model is not null)
+            .Select(static (model, _) => model!);
+
+        context.RegisterSourceOutput(apis.Combine(enabled), static (spc, pair) =>
+        {
+            if (pair.Right)
+            {
+                spc.AddSource(pair.Left.ClassName + ".g.cs", EmitApi(pair.Left));
+            }
+        });
+
+        context.RegisterSourceOutput(apis.Collect().Combine(enabled), static (spc, pair) =>
+        {
+            if (pair.Right && pair.Left.Length > 0)
+            {
+                spc.AddSource("SandboxApiModuleInitializer.g.cs", EmitModuleInitializer(pair.Left));
+            }
+        });
+    }
+
+    private static ApiModel? CreateModel(GeneratorAttributeSyntaxContext ctx, CancellationToken ct)
+    {
+        if (ctx.TargetSymbol is not INamedTypeSymbol type ||
+            ctx.Attributes.Length == 0 ||
+            ctx.Attributes[0].ConstructorArguments.Length != 1 ||
+            ctx.Attributes[0].ConstructorArguments[0].Value is not string jsNamespace ||
+            string.IsNullOrWhiteSpace(jsNamespace) ||
+            !IsBindable(type))
+        {
+            return null;
+        }
+
+        var compilation = ctx.SemanticModel.Compilation;
+        var taskType = compilation.GetTypeByMetadataName("System.Threading.Tasks.Task");
+        var taskOfTType = compilation.GetTypeByMetadataName("System.Threading.Tasks.Task`1");
+        var valueTaskType = compilation.GetTypeByMetadataName("System.Threading.Tasks.ValueTask");
+        var valueTaskOfTType = compilation.GetTypeByMetadataName("System.Threading.Tasks.ValueTask`1");
+        var cancellationTokenType = compilation.GetTypeByMetadataName("System.Threading.CancellationToken");
+
+        // Same order as the reflection scanner: static methods, then instance methods
+        var candidates = type.GetMembers()
+            .OfType<IMethodSymbol>()
+            .Where(m => m.MethodKind == MethodKind.Ordinary &&
+                        m.DeclaredAccessibility == Accessibility.Public &&
+                        (m.IsStatic || !type.IsStatic))
+            .OrderBy(m => m.IsStatic ? 0 : 1);
+
+        var methods = ImmutableArray.CreateBuilder<MethodModel>();
+        foreach (var method in candidates)
+        {
+            ct.ThrowIfCancellationRequested();
+
+            var attribute = method.GetAttributes().FirstOrDefault(a =>
+                a.AttributeClass?.ToDisplayString() == SandboxMethodAttribute);
+            if (attribute is null)
+            {
+                continue;
+            }
+
+            if (attribute.ConstructorArguments.Length != 1 ||
+                attribute.ConstructorArguments[0].Value is not string jsName ||
+                string.IsNullOrWhiteSpace(jsName) ||
+                method.IsGenericMethod ||
+                method.ReturnsByRef ||
+                method.ReturnsByRefReadonly ||
+                method.ReturnType.IsRefLikeType)
+            {
+                return null;
+            }
+
+            var parameters = ImmutableArray.CreateBuilder<ParameterModel>();
+            foreach (var parameter in method.Parameters)
+            {
+                if (parameter.RefKind != RefKind.None ||
+                    parameter.Type.IsRefLikeType ||
+                    parameter.Type.TypeKind is TypeKind.Pointer or TypeKind.FunctionPointer or TypeKind.Error ||
+                    parameter.Type.ToDisplayString() == HostCallContext)
+                {
+                    return null;
+                }
+
+                var isToken = SymbolEqualityComparer.Default.Equals(parameter.Type, cancellationTokenType);
+                parameters.Add(new ParameterModel(
+                    parameter.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat),
+                    isToken));
+            }
+
+            methods.Add(new MethodModel(
+                method.Name,
+                jsName,
+                method.IsStatic,
+                GetReturnKind(method, taskType, taskOfTType, valueTaskType, valueTaskOfTType),
+                new EquatableArray<ParameterModel>(parameters.ToImmutable())));
+        }
+
+        if (methods.Count == 0)
+        {
+            return null;
+        }
+
+        var hasDefaultConstructor = !type.IsStatic && type.InstanceConstructors.Any(c =>
+            c.Parameters.Length == 0 &&
+            c.DeclaredAccessibility is Accessibility.Public or Accessibility.Internal or Accessibility.ProtectedOrInternal);
+
+        var fullName = type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        var className = new string(type.ToDisplayString()
+            .Select(c => char.IsLetterOrDigit(c) ? c : '_')
+            .ToArray()) + "_SandboxApi";
+
+        return new ApiModel(
+            fullName,
+            className,
+            jsNamespace,
+            type.IsStatic,
+            hasDefaultConstructor,
+            new EquatableArray<MethodModel>(methods.ToImmutable()));
+    }
+
+    private static bool IsBindable(INamedTypeSymbol type)
+    {
+        if (type.IsAbstract && !type.IsStatic)
+        {
+            return false;
+        }
+
+        for (var current = type; current is not null; current = current.ContainingType)
+        {
+            if (current.IsGenericType ||
+                current.IsFileLocal ||
+                current.DeclaredAccessibility is not (Accessibility.Public or Accessibility.Internal or Accessibility.ProtectedOrInternal))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    private static ReturnKind GetReturnKind(
+        IMethodSymbol method,
+        INamedTypeSymbol? taskType,
+        INamedTypeSymbol? taskOfTType,
+        INamedTypeSymbol? valueTaskType,
+        INamedTypeSymbol? valueTaskOfTType)
+    {
+        if (method.ReturnsVoid)
+        {
+            return ReturnKind.Void;
+        }
+
+        var returnType = method.ReturnType.OriginalDefinition;
+        if (SymbolEqualityComparer.Default.Equals(returnType, taskType))
+        {
+            return ReturnKind.Task;
+        }
+
+        if (SymbolEqualityComparer.Default.Equals(returnType, taskOfTType))
+        {
+            return ReturnKind.TaskOfT;
+        }
+
+        if (SymbolEqualityComparer.Default.Equals(returnType, valueTaskType))
+        {
+            return ReturnKind.ValueTask;
+        }
+
+        if (SymbolEqualityComparer.Default.Equals(returnType, valueTaskOfTType))
+        {
+            return ReturnKind.ValueTaskOfT;
+        }
+
+        return ReturnKind.Value;
+    }
+
+    private static string EmitApi(ApiModel api)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine("// <auto-generated/>");
+        sb.AppendLine("#pragma warning disable CS1998");
+        sb.AppendLine();
+        sb.AppendLine("namespace ScriptBox.Generated");
+        sb.AppendLine("{");
+        sb.AppendLine($"    internal static class {api.ClassName}");
+        sb.AppendLine("    {");
+        sb.AppendLine($"        public static {RuntimeNamespace}GeneratedSandboxApi Create()");
+        sb.AppendLine("        {");
+        sb.AppendLine($"            return new {RuntimeNamespace}GeneratedSandboxApi(");
+        sb.AppendLine($"                typeof({api.FullName}),");
+        sb.AppendLine($"                {Literal(api.JsNamespace)},");
+        sb.AppendLine($"                {(api.IsStatic ? "false" : "true")},");
+        sb.AppendLine(api.HasDefaultConstructor ? $"                () => new {api.FullName}()," : "                null,");
+        sb.AppendLine($"                new {RuntimeNamespace}GeneratedSandboxMethod[]");
+        sb.AppendLine("                {");
+        for (var i = 0; i < api.Methods.Length; i++)
+        {
+            var method = api.Methods[i];
+            var argumentCount = method.Parameters.Count(p => !p.IsCancellationToken);
+            sb.AppendLine($"                    new {RuntimeNamespace}GeneratedSandboxMethod({Literal(method.JsName)}, {argumentCount}, {method.Parameters.Length}, Invoke{i}),");
+        }
+
+        sb.AppendLine("                },");
+        sb.AppendLine($"                {Literal(BuildBootstrap(api))});");
+        sb.AppendLine("        }");
+
+        for (var i = 0; i < api.Methods.Length; i++)
+        {
+            var method = api.Methods[i];
+            sb.AppendLine();
+            sb.AppendLine($"        private static async global::System.Threading.Tasks.Task<object> Invoke{i}(object target, {RuntimeNamespace}GeneratedSandboxArguments args)");
+            sb.AppendLine("        {");
+
+            var call = new StringBuilder();
+            call.Append(method.IsStatic ? api.FullName : $"(({api.FullName})target)");
+            call.Append('.').Append(method.Name).Append('(');
+            var argumentIndex = 0;
+            for (var p = 0; p < method.Parameters.Length; p++)
+            {
+                if (p > 0)
+                {
+                    call.Append(", ");
+                }
+
+                var parameter = method.Parameters[p];
+                call.Append(parameter.IsCancellationToken
+                    ? "args.CancellationToken"
+                    : $"args.Get<{parameter.Type}>({argumentIndex++})");
+            }
+
+            call.Append(')');
+
+            switch (method.ReturnKind)
+            {
+                case ReturnKind.Void:
+                    sb.AppendLine($"            {call};");
+                    sb.AppendLine("            return null;");
+                    break;
+                case ReturnKind.Task:
+                case ReturnKind.ValueTask:
+                    sb.AppendLine($"            await {call}.ConfigureAwait(false);");
+                    sb.AppendLine("            return null;");
+                    break;
+                case ReturnKind.TaskOfT:
+                case ReturnKind.ValueTaskOfT:
+                    sb.AppendLine($"            return await {call}.ConfigureAwait(false);");
+                    break;
+                default:
+                    sb.AppendLine($"            return {call};");
+                    break;
+            }
+
+            sb.AppendLine("        }");
+        }
+
+        sb.AppendLine("    }");
+        sb.AppendLine("}");
+        return sb.ToString();
+    }
+
+    /// <summary>
+    /// Mirrors <c>AttributedSandboxApiRegistry.BuildApiBootstrap</c>.
+    /// </summary>
+    private static string BuildBootstrap(ApiModel api)
+    {
+        var sb = new StringBuilder();
+        sb.Append("(function(root){\n");
+        sb.Append("  if (typeof __scriptbox === 'undefined') {\n");
+        sb.Append("    throw new Error('Missing __scriptbox helper.');\n");
+        sb.Append("  }\n");
+        sb.Append("  var api = {};\n");
+        foreach (var method in api.Methods)
+        {
+            sb.Append($"  api.{method.JsName} = __scriptbox.createMethod('{api.JsNamespace}.{method.JsName}');\n");
+        }
+
+        sb.Append($"  root.{api.JsNamespace} = api;\n");
+        sb.Append("})(");
+        sb.Append("typeof globalThis !== 'undefined' ? globalThis : ");
+        sb.Append("typeof global !== 'undefined' ? global : ");
+        sb.Append("typeof self !== 'undefined' ? self : this");
+        sb.Append(");\n");
+        return sb.ToString();
+    }
+
+    private static string EmitModuleInitializer(ImmutableArray<ApiModel> apis)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine("// <auto-generated/>");
+        sb.AppendLine();
+        sb.AppendLine("namespace ScriptBox.Generated");
+        sb.AppendLine("{");
+        sb.AppendLine("    internal static class SandboxApiModuleInitializer");
+        sb.AppendLine("    {");
+        sb.AppendLine("        [global::System.Runtime.CompilerServices.ModuleInitializer]");
+        sb.AppendLine("        internal static void Initialize()");
+        sb.AppendLine("        {");
+        foreach (var api in apis.OrderBy(a => a.ClassName, System.StringComparer.Ordinal))
+        {
+            sb.AppendLine($"            {RuntimeNamespace}GeneratedSandboxApiRegistry.Register({api.ClassName}.Create());");
+        }
+
+        sb.AppendLine("        }");
+        sb.AppendLine("    }");
+        sb.AppendLine("}");
+        return sb.ToString();
+    }
+
+    private static string Literal(string value) => SymbolDisplay.FormatLiteral(value, quote: true);
+
+    private enum ReturnKind
+    {
+        Void,
+        Value,
+        Task,
+        TaskOfT,
+        ValueTask,
+        ValueTaskOfT
+    }
+
+    private sealed record ParameterModel(string Type, bool IsCancellationToken);
+
+    private sealed record MethodModel(
+        string Name,
+        string JsName,
+        bool IsStatic,
+        ReturnKind ReturnKind,
+        EquatableArray<ParameterModel> Parameters);
+
+    private sealed record ApiModel(
+        string FullName,
+        string ClassName,
+        string JsNamespace,
+        bool IsStatic,
+        bool HasDefaultConstructor,
+        EquatableArray<MethodModel> Methods);
+}
@@ -0,0 +1,43 @@
+namespace ScriptBox.Tests;
+
+using global::ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// A <see cref="FactAttribute"/> that is skipped when the embedded module does not report
+/// <c>features</c> in <c>get_abi_features</c>, i.e. when ScriptBox.Wasm/scriptbox.wasm was built
+/// from an older scriptbox_wrapper.c. Rebuild it with ScriptBox.Wasm/build.sh to run these tests.
+/// </summary>
+internal sealed class RequiresAbiFactAttribute : FactAttribute
+{
+    private static readonly Lazy<WasmAbiFeatures> EmbeddedFeatures = new(ReadEmbeddedFeatures);
+
+    public RequiresAbiFactAttribute(WasmAbiFeatures features)
+    {
+        var missing = features & ~EmbeddedFeatures.Value;
+        if (missing != WasmAbiFeatures.None)
+        {
+            Skip = $"The embedded WASM module does not support {missing}; rebuild it with ScriptBox.Wasm/build.sh";
+        }
+    }
+
+    private static WasmAbiFeatures ReadEmbeddedFeatures()
+    {
+        try
+        {
+            var executor = new WasmScriptExecutor(options: new WasmExecutorOptions { MaxIdleInstances = 1 });
+            try
+            {
+                return executor.AbiFeatures;
+            }
+            finally
+            {
+                executor.DisposeAsync().AsTask().GetAwaiter().GetResult();
+            }
+        }
+        catch (Exception)
+        {
+            // Run the tests anyway, so they fail with the load error instead of being skipped
+            return (WasmAbiFeatures)(-1);
+        }
+    }
+}
@@ -126,6 +126,42 @@ public class SandboxSecurityTests : IDisposable
         Assert.Equal(content, result);
     }
 
+    [Fact]
+    public void FileSystemOpenRead_PathTraversal_ThrowsSecurityException()
+    {
+        // Act & Assert
+        var exception = Assert.Throws<SecurityException>(() =>
+            _hostApi.FileSystemOpenRead("../../../etc/passwd"));
+
+        Assert.Contains("Path traversal detected", exception.Message);
+    }
+
+    [Fact]
+    public void FileSystemOpenRead_ChunkedReads_KeepMultiByteCharactersWhole()
+    {
+        // Arrange - "é" and "€" are 2 and 3 bytes, so 2-byte reads split them
+        var content = "aé€b";
+        File.WriteAllText(Path.Combine(_testSandboxPath, "utf8.txt"), content);
+        using var streams = new HostStreamTable(maxOpen: 1, maxChunkBytes: 2);
+        var handle = streams.Add(_hostApi.FileSystemOpenRead("utf8.txt"));
+
+        // Act
+        var chunks = new List<string>();
+        string? chunk;
+        while ((chunk = streams.Read(handle, 1024)) != null)
+        {
+            chunks.Add(chunk);
+        }
+
+        // Assert
+        Assert.Equal(content, string.Concat(chunks));
+        Assert.True(chunks.Count > 1);
+        Assert.Null(streams.Read(handle, 2));
+        Assert.Throws<InvalidOperationException>(() => streams.Add(new MemoryStream()));
+        Assert.True(streams.Close(handle));
+        Assert.Throws<InvalidOperationException>(() => streams.Read(handle, 2));
+    }
+
     [Fact]
     public void FileSystemListFiles_ValidDirectory_ReturnsFiles()
     {
@@ -342,6 +378,51 @@ public class SandboxSecurityTests : IDisposable
         Assert.Contains("Invalid URL", exception.Message);
     }
 
+    [Fact]
+    public async Task HttpGet_SharedHandler_ReusesConnectionAcrossHostApis()
+    {
+        // Arrange - a unique connection limit gives this test its own shared handler
+        var options = new SharedHttpHandlerOptions { MaxConnectionsPerServer = 4321 };
+        var probe = new System.Net.Sockets.TcpListener(System.Net.IPAddress.Loopback, 0);
+        probe.Start();
+        var port = ((System.Net.IPEndPoint)probe.LocalEndpoint).Port;
+        probe.Stop();
+
+        using var listener = new System.Net.HttpListener();
+        listener.Prefixes.Add($"http://127.0.0.1:{port}/");
+        listener.Start();
+        var server = Task.Run(async () =>
+        {
+            for (var i = 0; i < 2; i++)
+            {
+                var context = await listener.GetContextAsync();
+                var body = System.Text.Encoding.UTF8.GetBytes("ok" + i);
+                context.Response.ContentLength64 = body.Length;
+                await context.Response.OutputStream.WriteAsync(body, 0, body.Length);
+                context.Response.Close();
+            }
+        });
+
+        HostApiImpl CreateHostApi() => new(new SandboxConfiguration
+        {
+            SandboxDirectory = _testSandboxPath,
+            SharedHttpHandler = options
+        });
+
+        // Act
+        var first = await CreateHostApi().HttpGetAsync($"http://127.0.0.1:{port}/a");
+        var second = await CreateHostApi().HttpGetAsync($"http://127.0.0.1:{port}/b");
+        await server;
+
+        // Assert
+        Assert.Equal("ok0", first);
+        Assert.Equal("ok1", second);
+        var metrics = SharedHttpHandlers.GetMetrics(options);
+        Assert.Equal(2, metrics.Requests);
+        Assert.Equal(1, metrics.ConnectionsOpened);
+        Assert.Equal(1, metrics.ReusedRequests);
+    }
+
     #endregion
 
     #region Configuration Tests
@@ -391,6 +472,54 @@ public class SandboxSecurityTests : IDisposable
         Assert.Contains("MaxHttpResponseSize must be positive", exception.Message);
     }
 
+    [Fact]
+    public void SandboxConfiguration_Validate_InvalidSharedHttpHandler_Throws()
+    {
+        // Arrange
+        var config = new SandboxConfiguration
+        {
+            SharedHttpHandler = new SharedHttpHandlerOptions { MaxConnectionsPerServer = 0 }
+        };
+
+        // Act & Assert
+        var exception = Assert.Throws<InvalidOperationException>(() =>
+            config.Validate());
+
+        Assert.Contains("MaxConnectionsPerServer must be positive", exception.Message);
+    }
+
+    [Fact]
+    public void SandboxConfiguration_Validate_ScriptHeapLimitAboveGuestRange_Throws()
+    {
+        // Arrange
+        var config = new SandboxConfiguration
+        {
+            ScriptHeapLimitBytes = (long)uint.MaxValue + 1
+        };
+
+        // Act & Assert
+        var exception = Assert.Throws<InvalidOperationException>(() =>
+            config.Validate());
+
+        Assert.Contains("ScriptHeapLimitBytes must be between 1 and", exception.Message);
+    }
+
+    [Fact]
+    public void SandboxConfiguration_Validate_NonPositiveLogSampleRate_Throws()
+    {
+        // Arrange
+        var config = new SandboxConfiguration
+        {
+            LogSampleRate = 0
+        };
+
+        // Act & Assert
+        var exception = Assert.Throws<InvalidOperationException>(() =>
+            config.Validate());
+
+        Assert.Contains("LogSampleRate must be greater than 0", exception.Message);
+    }
+
     [Fact]
     public void SandboxConfiguration_GetOrCreateSandboxDirectory_CreatesDirectory()
     {
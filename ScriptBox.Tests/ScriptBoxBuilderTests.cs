@@ -1,6 +1,13 @@
 using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text.Json;
+using System.Threading;
 using System.Threading.Tasks;
 using global::ScriptBox;
+using global::ScriptBox.Core.Configuration;
+using global::ScriptBox.Core.Runtime;
+using global::ScriptBox.Core.WasmExecution;
 using ScriptBox.Tests.TestApis;
 
 namespace ScriptBox.Tests;
@@ -78,6 +85,32 @@ if (result !== 5) {
         await session.RunAsync("const sum = calculator.add(4, 6); if (sum !== 10) throw new Error('unexpected sum ' + sum);");
     }
 
+    [Fact]
+    public async Task SharedModule_TenantsKeepTheirOwnApis()
+    {
+        var calculatorBox = ScriptBoxBuilder
+            .Create()
+            .RegisterApisFrom(typeof(AttributedCalculatorApi))
+            .Build();
+        await using var instanceBox = ScriptBoxBuilder
+            .Create()
+            .RegisterApisFrom<InstanceCalculatorApi>()
+            .Build();
+
+        await using (var session = calculatorBox.CreateSession())
+        {
+            var result = await session.ExecuteAsync("return [typeof calculator, typeof instanceCalc];");
+            Assert.Equal("[\"object\",\"undefined\"]", result.Result);
+        }
+
+        // The other box keeps the shared module alive
+        await calculatorBox.DisposeAsync();
+
+        await using var instanceSession = instanceBox.CreateSession();
+        var instanceResult = await instanceSession.ExecuteAsync("return [typeof calculator, instanceCalc.add(1, 4)];");
+        Assert.Equal("[\"undefined\",5]", instanceResult.Result);
+    }
+
     [Fact]
     public async Task RegisterApisFrom_InstanceType_UsesActivatorByDefault()
     {
@@ -132,4 +165,897 @@ if (result !== 15) {
     throw new Error('my_calc.add returned ' + result);
 }");
     }
+
+    [Fact]
+    public async Task RegisterApisFrom_GeneratedBindings_HonourNamespaceOverride()
+    {
+        Assert.True(GeneratedSandboxApiRegistry.TryGet(typeof(InstanceCalculatorApi), out var generated));
+        Assert.Equal("instanceCalc", generated.JsNamespace);
+
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .RegisterApisFrom<InstanceCalculatorApi>("renamed")
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync("return typeof instanceCalc + ':' + renamed.add(3, 4);");
+
+        Assert.Equal("undefined:7", result);
+    }
+
+    [Fact]
+    public async Task WithPreinitializedWasmModuleFromPath_RegularModule_ThrowsOnRun()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"scriptbox-{Guid.NewGuid():N}.wasm");
+        File.WriteAllBytes(path, DefaultRuntimeResources.LoadEmbeddedWasm().ToArray());
+
+        try
+        {
+            await using var scriptBox = ScriptBoxBuilder
+                .Create()
+                .WithPreinitializedWasmModuleFromPath(path)
+                .Build();
+
+            await using var session = scriptBox.CreateSession();
+            var ex = await Assert.ThrowsAsync<InvalidOperationException>(() => session.RunAsync("return 1;"));
+            Assert.Contains("not pre-initialized", ex.Message);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public async Task Session_ReusedInstance_DoesNotLeakGlobalsBetweenScripts()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        await session.RunAsync("globalThis.leaked = 42; Array.prototype.extra = 1; return 1;");
+        var result = await session.RunAsync("return typeof leaked + ',' + typeof [].extra;");
+
+        Assert.Equal("undefined,undefined", result);
+    }
+
+    [Fact]
+    public async Task Logs_AreCappedAndSampledPerRun()
+    {
+        await using var capped = ScriptBoxBuilder
+            .Create()
+            .WithSandboxConfiguration(new SandboxConfiguration { MaxLogEntries = 10 })
+            .Build();
+        await using var cappedSession = capped.CreateSession();
+        var result = await cappedSession.ExecuteAsync("for (let i = 0; i < 100; i++) console.log('line ' + i);");
+
+        Assert.Equal(11, result.Logs.Count);
+        Assert.Equal("line 9", result.Logs[9]);
+        Assert.Contains("90 log entries dropped", result.Logs[10]);
+
+        await using var sampled = ScriptBoxBuilder
+            .Create()
+            .WithSandboxConfiguration(new SandboxConfiguration { LogSampleRate = 0.25 })
+            .Build();
+        await using var sampledSession = sampled.CreateSession();
+        result = await sampledSession.ExecuteAsync("for (let i = 0; i < 8; i++) console.log(String(i));");
+
+        Assert.Equal(new[] { "0", "4" }, result.Logs.Take(2));
+        Assert.Contains("6 log entries dropped", result.Logs[2]);
+    }
+
+    [Fact]
+    public async Task ConsoleLog_JoinsAllArguments()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        var result = await session.ExecuteAsync("console.log('sum', 1 + 2, { ok: true });");
+
+        // Modules built before buffered logging print only the first argument
+        Assert.Contains(result.Logs.Single(), new[] { "sum", "sum 3 {\"ok\":true}" });
+    }
+
+    [Fact]
+    public async Task Session_ReusedInstance_CapturesLogsPerExecution()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        await session.ExecuteAsync("console.log('first');");
+        var second = await session.ExecuteAsync("console.log('second');");
+
+        Assert.Equal(new[] { "second" }, second.Logs);
+    }
+
+    [Fact]
+    public async Task Session_RecoversAfterScriptError()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        await Assert.ThrowsAsync<InvalidOperationException>(() => session.RunAsync("throw new Error('boom');"));
+        var result = await session.RunAsync("return 2 + 2;");
+
+        Assert.Equal("4", result);
+    }
+
+    [Fact]
+    public async Task WithInstanceReuse_Disabled_ExecutesScripts()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithInstanceReuse(false)
+            .Build();
+        await using var session = scriptBox.CreateSession();
+
+        Assert.Equal("3", await session.RunAsync("return 1 + 2;"));
+        Assert.Equal("7", await session.RunAsync("return 3 + 4;"));
+    }
+
+    [Fact]
+    public async Task WithInstancePool_PrewarmedInstances_ExecuteConcurrentScripts()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithInstancePool(minSize: 2, maxSize: 4)
+            .Build();
+
+        var runs = Enumerable.Range(0, 8).Select(async i =>
+        {
+            await using var session = scriptBox.CreateSession();
+            return await session.RunAsync($"return {i} * 2;");
+        });
+
+        var results = await Task.WhenAll(runs);
+
+        Assert.Equal(Enumerable.Range(0, 8).Select(i => (object?)(i * 2).ToString()), results);
+    }
+
+    [Theory]
+    [InlineData(-1, 4)]
+    [InlineData(3, 2)]
+    [InlineData(0, 0)]
+    public void WithInstancePool_InvalidSizes_Throws(int minSize, int maxSize)
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => ScriptBoxBuilder.Create().WithInstancePool(minSize, maxSize));
+    }
+
+    [Fact]
+    public async Task Session_RepeatedScript_UsesCachedBytecode()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        const string script = "const xs = [1, 2, 3]; return xs.map(x => x * 2).join(',');";
+        var first = await session.RunAsync(script);
+        var second = await session.RunAsync(script);
+
+        Assert.Equal("2,4,6", first);
+        Assert.Equal(first, second);
+    }
+
+    [Fact]
+    public async Task WithBytecodeCache_Disabled_StillRejectsSyntaxErrors()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithBytecodeCache(0)
+            .Build();
+        await using var session = scriptBox.CreateSession();
+
+        var ex = await Assert.ThrowsAsync<InvalidOperationException>(() => session.RunAsync("return (;"));
+        Assert.Contains("eval_js failed", ex.Message);
+        Assert.Equal("5", await session.RunAsync("return 2 + 3;"));
+    }
+
+    [Fact]
+    public async Task WithPrecompiledWasmModuleFromPath_IncompatibleArtifact_FallsBackToEmbeddedModule()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"scriptbox-{Guid.NewGuid():N}.cwasm");
+        File.WriteAllBytes(path, new byte[] { 0x7f, 0x45, 0x4c, 0x46, 0x00, 0x00 });
+        try
+        {
+            await using var scriptBox = ScriptBoxBuilder
+                .Create()
+                .WithPrecompiledWasmModuleFromPath(path)
+                .Build();
+            await using var session = scriptBox.CreateSession();
+
+            Assert.Equal("6", await session.RunAsync("return 2 * 3;"));
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public void WithCompilationCache_MissingConfigFile_Throws()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"scriptbox-{Guid.NewGuid():N}.toml");
+
+        Assert.Throws<FileNotFoundException>(() => ScriptBoxBuilder.Create().WithCompilationCache(path));
+    }
+
+    [Fact]
+    public async Task WithBuildProfile_Debug_ExecutesScripts()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithBuildProfile(WasmBuildProfile.Debug)
+            .Build();
+        await using var session = scriptBox.CreateSession();
+
+        Assert.Equal("10", await session.RunAsync("let s = 0; for (let i = 0; i < 5; i++) s += i; return s;"));
+    }
+
+    [Fact]
+    public async Task WithBuildProfile_Release_UsesEmbeddedModuleOrThrows()
+    {
+        var builder = ScriptBoxBuilder.Create().WithBuildProfile(WasmBuildProfile.Release);
+
+        if (!DefaultRuntimeResources.TryLoadEmbeddedWasm(WasmBuildProfile.Release, out _))
+        {
+            var ex = Assert.Throws<InvalidOperationException>(() => builder.Build());
+            Assert.Contains("build.sh --release", ex.Message);
+            return;
+        }
+
+        await using var scriptBox = builder.Build();
+        await using var session = scriptBox.CreateSession();
+        Assert.Equal("3", await session.RunAsync("return 1 + 2;"));
+    }
+
+    [Fact]
+    public async Task Session_DeepRecursion_ThrowsScriptErrorAndRecovers()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        await Assert.ThrowsAsync<InvalidOperationException>(
+            () => session.RunAsync("function f(n) { return f(n + 1) + 1; } return f(0);"));
+        Assert.Equal("ok", await session.RunAsync("return 'ok';"));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.AsyncHostCalls)]
+    public async Task Session_HostCallAsync_AwaitsHandlerWithoutBlocking()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureHostApi(api => api.RegisterJsonHandler(
+                "assistant.slowDouble",
+                async ctx =>
+                {
+                    await Task.Delay(50);
+                    return Convert.ToInt32(ctx.Args[0]) * 2;
+                }))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync(@"
+const [a, b] = await Promise.all([
+  __scriptbox.hostCallAsync('assistant.slowDouble', [2]),
+  __scriptbox.hostCallAsync('assistant.slowDouble', [5])
+]);
+return a + b;");
+
+        Assert.Equal("14", result);
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.AsyncHostCalls)]
+    public async Task Session_HostCallAsyncNeverCompletes_TimesOutAndRecovers()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithExecutionTimeout(TimeSpan.FromMilliseconds(200))
+            .ConfigureHostApi(api => api.RegisterJsonHandler(
+                "assistant.hang",
+                async ctx =>
+                {
+                    await Task.Delay(System.Threading.Timeout.Infinite, ctx.CancellationToken);
+                    return null;
+                }))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        await Assert.ThrowsAsync<TimeoutException>(
+            () => session.RunAsync("return await __scriptbox.hostCallAsync('assistant.hang', []);"));
+        Assert.Equal("1", await session.RunAsync("return 1;"));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.AsyncHostCalls)]
+    public async Task Session_HostCallAll_RunsCallsConcurrently()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureHostApi(api => api.RegisterJsonHandler(
+                "assistant.slowEcho",
+                async ctx =>
+                {
+                    await Task.Delay(200);
+                    return ctx.Args[0];
+                }))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        await session.RunAsync("return 1;");
+
+        var stopwatch = System.Diagnostics.Stopwatch.StartNew();
+        var result = await session.RunAsync(@"
+const calls = [];
+for (let i = 0; i < 5; i++) {
+  calls.push({ method: 'assistant.slowEcho', args: ['v' + i] });
+}
+const values = await __scriptbox.hostCallAll(calls);
+return values.join(',');");
+        stopwatch.Stop();
+
+        Assert.Equal("v0,v1,v2,v3,v4", result);
+        Assert.True(stopwatch.ElapsedMilliseconds < 800, $"Batch took {stopwatch.ElapsedMilliseconds}ms");
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.AsyncHostCalls)]
+    public async Task Session_HostCallAll_RejectsWithFirstError()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        var result = await session.RunAsync(@"
+try {
+  await __scriptbox.hostCallAll([{ method: 'Add', args: [1, 2] }, { method: 'NoSuchMethod', args: [] }]);
+  return 'resolved';
+} catch (e) {
+  return e.message;
+}");
+
+        Assert.Contains("Unknown method: NoSuchMethod", result?.ToString());
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.AsyncHostCalls)]
+    public async Task Session_HostCallAll_RejectsWithErrorThatNeedsEscaping()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureHostApi(api => api
+                .RegisterJsonHandler("assistant.fail", _ => throw new InvalidOperationException("bad \"path\" C:\\tmp\nline two")))
+            .Build();
+        await using var session = scriptBox.CreateSession();
+
+        var result = await session.RunAsync(@"
+try {
+  await __scriptbox.hostCallAll([{ method: 'Add', args: [1, 2] }, { method: 'assistant.fail', args: [] }]);
+  return 'resolved';
+} catch (e) {
+  return e.message;
+}");
+
+        Assert.Contains("bad \"path\" C:\\tmp\nline two", result?.ToString());
+    }
+
+    [Fact]
+    public async Task Session_HostCallsById_ResolveRegisteredHandlers()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureHostApi(api => api
+                .RegisterJsonHandler("assistant.add", ctx => Task.FromResult<object?>(
+                    Convert.ToInt32(ctx.Args[0]) + Convert.ToInt32(ctx.Args[1])))
+                .RegisterJsonHandler("assistant.echo", ctx => Task.FromResult<object?>(ctx.Method)))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync(@"
+const add = __scriptbox.createMethod('Assistant.Add');
+const unknown = JSON.parse(__host.bridge('{""id"":9999,""args"":[]}'));
+return [add(2, 3), __scriptbox.hostCall('assistant.echo', []), unknown.error].join('|');");
+
+        Assert.Equal("5|assistant.echo|Unknown method id: 9999", result);
+    }
+
+    [Fact]
+    public async Task Session_HostCalls_PassArgumentsAndThrowHostErrors()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureHostApi(api => api.RegisterJsonHandler(
+                "assistant.count",
+                ctx => Task.FromResult<object?>(ctx.Args.Count)))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync(@"
+const count = __scriptbox.createMethod('assistant.count');
+let error = '';
+try { __scriptbox.hostCall('assistant.missing', []); } catch (e) { error = (e instanceof Error) + ':' + e.message; }
+return [count('a""b', { x: 1 }, undefined), __scriptbox.hostCall('assistant.count', ['\u00e9']), error].join('|');");
+
+        Assert.StartsWith("3|1|true:", result?.ToString());
+        Assert.Contains("Unknown method", result?.ToString());
+    }
+
+    [Fact]
+    public async Task Session_HostCallUnknownMethod_ThrowsHostErrorForAnyName()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+
+        var result = await session.RunAsync(@"
+try { __scriptbox.hostCall('a""b\\c\nd', []); return 'returned'; } catch (e) { return e.name + ':' + e.message; }");
+
+        Assert.DoesNotContain("SyntaxError", result?.ToString());
+        Assert.Contains("Unknown method: a\"b\\c\nd", result?.ToString());
+    }
+
+    [Fact]
+    public async Task Session_ToolInvoke_AcceptsRequestObject()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureHostApi(api => api.RegisterJsonHandler(
+                "assistant.add",
+                ctx => Task.FromResult<object?>(Convert.ToInt32(ctx.Args[0]) + Convert.ToInt32(ctx.Args[1]))))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync(@"
+const request = { kind: 'tool.invoke', toolId: 'assistant.add', args: [4, 5] };
+const direct = __scriptbox.hostCall('tool.invoke', [request]);
+const encoded = __scriptbox.hostCall('tool.invoke', [JSON.stringify(request)]);
+return direct + ',' + encoded;");
+
+        Assert.Equal("9,9", result);
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.BinaryHostCalls)]
+    public async Task WithBinaryHostCalls_RegisteredHandlersReturnSameValues()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithBinaryHostCalls()
+            .RegisterApisFrom(typeof(AttributedCalculatorApi))
+            .ConfigureHostApi(api => api.RegisterJsonHandler(
+                "assistant.describe",
+                ctx => Task.FromResult<object?>(new { name = ctx.Args[0], tags = new[] { "a", "\u00e9" }, score = 1.5 })))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync(@"
+const sum = calculator.add(2, 3);
+const info = __scriptbox.createMethod('assistant.describe')('box');
+let error = '';
+try { calculator.add(1); } catch (e) { error = e.message; }
+return [sum, info.name, info.tags.join('+'), info.score, error].join('|');");
+
+        Assert.StartsWith("5|box|a+\u00e9|1.5|", result?.ToString());
+        Assert.Contains("Not enough arguments", result?.ToString());
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.ContextApi | WasmAbiFeatures.Bytecode)]
+    public async Task CreateSession_PersistState_KeepsGlobalsBetweenScripts()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .RegisterApisFrom(typeof(AttributedCalculatorApi))
+            .Build();
+
+        await using var session = scriptBox.CreateSession(new ScriptSessionOptions { PersistState = true });
+        Assert.True(session.PersistsState);
+        await session.RunAsync("globalThis.total = calculator.add(2, 3);");
+
+        await Assert.ThrowsAsync<InvalidOperationException>(() => session.RunAsync("total += 1; throw new Error('step failed');"));
+        var result = await session.RunAsync("return calculator.add(total, 10);");
+        Assert.Equal("16", result);
+
+        await using var fresh = scriptBox.CreateSession();
+        Assert.Equal("undefined", await fresh.RunAsync("return typeof total;"));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.ContextApi | WasmAbiFeatures.Bytecode)]
+    public async Task CreateSession_PersistStateWithoutInstanceReuse_KeepsGlobals()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithInstanceReuse(false)
+            .Build();
+
+        await using var session = scriptBox.CreateSession(new ScriptSessionOptions { PersistState = true });
+        await session.RunAsync("globalThis.count = 1;");
+        await session.RunAsync("count += 1;");
+        Assert.Equal("3", await session.RunAsync("return count + 1;"));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.ContextApi | WasmAbiFeatures.Bytecode)]
+    public async Task CreateSession_PersistState_MemoryLimitDiscardsState()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        Assert.Throws<ArgumentOutOfRangeException>(() =>
+            scriptBox.CreateSession(new ScriptSessionOptions { PersistState = true, MaxMemoryBytes = 0 }));
+
+        // Any instance is larger than one byte, so the first script already exceeds the limit
+        await using var session = scriptBox.CreateSession(new ScriptSessionOptions { PersistState = true, MaxMemoryBytes = 1 });
+        var error = await Assert.ThrowsAsync<InvalidOperationException>(() => session.RunAsync("globalThis.kept = 1;"));
+        Assert.Contains("memory limit", error.Message);
+    }
+
+    [Fact]
+    public void MessagePack_RoundTripsArgumentsAndTypedBinders()
+    {
+        var writer = new MessagePackWriter();
+        writer.WriteRaw(WasmConfiguration.BinaryHostCallMarker);
+        writer.WriteArrayHeader(2);
+        writer.WriteInt64(0);
+        writer.WriteObject(new object?[] { 42, "h\u00e9llo", true, 2.25, null, new Dictionary<string, object?> { ["Key"] = -7L } }, new JsonSerializerOptions());
+
+        var payload = writer.WrittenSpan.ToArray();
+        var context = HostCallContext.FromMessagePack("test", payload, argsOffset: 3, CancellationToken.None);
+
+        Assert.Equal(6, context.ArgumentCount);
+        Assert.Equal(42, HostArgumentBinder.Bind<int>(context, 0));
+        Assert.Equal("h\u00e9llo", HostArgumentBinder.Bind<string>(context, 1));
+        Assert.True(HostArgumentBinder.Bind<bool>(context, 2));
+        Assert.Equal(2.25, HostArgumentBinder.Bind<double>(context, 3));
+        Assert.Null(context.Arguments[4]);
+        var map = Assert.IsType<Dictionary<string, object?>>(context.Arguments[5]);
+        Assert.Equal(-7L, map["key"]);
+    }
+
+    [Fact]
+    public async Task Session_InfiniteLoop_IsInterruptedAndRecovers()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithExecutionTimeout(TimeSpan.FromMilliseconds(100))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var stopwatch = System.Diagnostics.Stopwatch.StartNew();
+        await Assert.ThrowsAsync<TimeoutException>(() => session.RunAsync("while (true) {}"));
+        Assert.True(stopwatch.ElapsedMilliseconds < 2000, "The loop should be interrupted near the deadline");
+        Assert.Equal("1", await session.RunAsync("return 1;"));
+    }
+
+    [Fact]
+    public void WithFuelLimit_Zero_Throws()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => ScriptBoxBuilder.Create().WithFuelLimit(0));
+    }
+
+    [Fact]
+    public void WithEpochInterruption_ZeroTick_Throws()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() =>
+            ScriptBoxBuilder.Create().WithEpochInterruption(tickInterval: TimeSpan.Zero));
+    }
+
+    [Fact]
+    public async Task ConfigureMemory_Limits_StillExecuteScripts()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .ConfigureMemory(memory => memory
+                .WithMaxGuestMemory(256L * 1024 * 1024)
+                .WithScriptHeapLimit(64L * 1024 * 1024)
+                .WithGcThreshold(1024 * 1024))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        Assert.Equal("3", await session.RunAsync("return [1, 2].reduce((a, b) => a + b);"));
+    }
+
+    [Fact]
+    public void ConfigureMemory_InvalidHeapLimit_Throws()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() =>
+            ScriptBoxBuilder.Create().ConfigureMemory(memory => memory.WithScriptHeapLimit(0)));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.BinaryResults)]
+    public async Task WithStructuredResults_ReturnsDecodedRecords()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithStructuredResults()
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.RunAsync("return [{ id: 1, name: 'a' }, { id: 2.5, name: null, skipped: undefined }];");
+
+        var rows = Assert.IsType<List<object?>>(result);
+        Assert.Equal(2, rows.Count);
+        var first = Assert.IsType<Dictionary<string, object?>>(rows[0]);
+        Assert.Equal(1L, first["id"]);
+        Assert.Equal("a", first["name"]);
+        var second = Assert.IsType<Dictionary<string, object?>>(rows[1]);
+        Assert.Equal(2.5, second["id"]);
+        Assert.Null(second["name"]);
+        Assert.False(second.ContainsKey("skipped"));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.MemoryStats)]
+    public async Task WithGuestMemoryStats_ReportsHeapOfTheRun()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithGuestMemoryStats()
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.ExecuteAsync("const rows = []; for (let i = 0; i < 1000; i++) rows.push({ i }); return rows.length;");
+
+        Assert.Equal("1000", result.Result);
+        Assert.NotNull(result.Memory);
+        var memory = result.Memory.Value;
+        Assert.True(memory.PeakHeapBytes >= memory.HeapBytesInUse);
+        Assert.True(memory.HeapBytesInUse > 0);
+        Assert.True(memory.ObjectCount > 0);
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.Profiler)]
+    public async Task WithProfiling_SamplesTheStacksOfTheRun()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithProfiling(sampleInterval: TimeSpan.FromMilliseconds(1))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.ExecuteAsync(@"
+function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+return fib(24);");
+
+        Assert.Equal("46368", result.Result);
+        var profile = Assert.IsType<ScriptProfile>(result.Profile);
+        Assert.True(profile.SampleCount > 0);
+        Assert.Equal(profile.SampleCount, profile.Stacks.Values.Sum());
+        Assert.True(profile.Stacks.Keys.Any(stack => stack.Contains("fib (")));
+        Assert.All(
+            profile.ToFoldedString().Split('\n', StringSplitOptions.RemoveEmptyEntries),
+            line => Assert.True(int.TryParse(line.Substring(line.LastIndexOf(' ') + 1).TrimEnd('\r'), out _)));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.Profiler)]
+    public async Task WithProfiling_ReplacedErrorDoesNotReachSampling()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithProfiling(sampleInterval: TimeSpan.FromMilliseconds(1))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.ExecuteAsync(@"
+let touched = 0;
+globalThis.Error = function () { touched++; return { stack: '    at forged (evil:1:1)' }; };
+Object.defineProperty(Error.prototype, 'stack', { get() { touched++; return '    at forged (evil:1:1)'; } });
+function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+return fib(24) + ':' + touched;");
+
+        Assert.Equal("46368:0", result.Result);
+        var profile = Assert.IsType<ScriptProfile>(result.Profile);
+        Assert.True(profile.Stacks.Keys.Any(stack => stack.Contains("fib (")));
+        Assert.False(profile.Stacks.Keys.Any(stack => stack.Contains("forged")));
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.Profiler)]
+    public async Task WithProfiling_StackHooksAreNeverCalledBySampling()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithProfiling(sampleInterval: TimeSpan.FromMilliseconds(1))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        var result = await session.ExecuteAsync(@"
+let touched = 0;
+Error.prepareStackTrace = () => { touched++; return '    at forged (evil:1:1)'; };
+function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+return fib(24) + ':' + touched;");
+
+        Assert.Equal("46368:0", result.Result);
+        var profile = Assert.IsType<ScriptProfile>(result.Profile);
+        Assert.False(profile.Stacks.Keys.Any(stack => stack.Contains("forged")));
+    }
+
+    [Fact]
+    public void ScriptProfile_FoldsBacktracesOutermostFirst()
+    {
+        var records = System.Text.Encoding.UTF8.GetBytes(
+            "    at fib (eval:1:30)\n    at fib (eval:1:30)\n    at <anonymous> (eval:2:8)\n\0\0    at run; (eval:5)\n\0");
+
+        var profile = ScriptProfile.Parse(records, TimeSpan.FromMilliseconds(1), droppedSamples: 3);
+
+        Assert.Equal(3, profile.SampleCount);
+        Assert.Equal(3, profile.DroppedSamples);
+        Assert.Equal(2, profile.Stacks["<anonymous> (eval:2);fib (eval:1);fib (eval:1)"]);
+        Assert.Equal(1, profile.Stacks["run, (eval:5)"]);
+    }
+
+    [Fact]
+    public async Task Timeout_CannotBeCaughtByTheScript()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithExecutionTimeout(TimeSpan.FromMilliseconds(100))
+            .Build();
+
+        await using var session = scriptBox.CreateSession();
+        await Assert.ThrowsAsync<TimeoutException>(
+            () => session.RunAsync("for (;;) { try { for (;;) {} } catch (e) { } }"));
+        Assert.Equal("2", await session.RunAsync("return 2;"));
+    }
+
+    [Fact]
+    public void WithProfiling_ZeroInterval_Throws()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(
+            () => ScriptBoxBuilder.Create().WithProfiling(sampleInterval: TimeSpan.Zero));
+    }
+
+    [Fact]
+    public async Task Diagnostics_RecordScriptOutcomesAndActivities()
+    {
+        var outcomes = new System.Collections.Concurrent.ConcurrentBag<string?>();
+        using var meterListener = new System.Diagnostics.Metrics.MeterListener();
+        meterListener.InstrumentPublished = (instrument, listener) =>
+        {
+            if (instrument.Meter.Name == ScriptBoxDiagnostics.MeterName && instrument.Name == "scriptbox.script.duration")
+            {
+                listener.EnableMeasurementEvents(instrument);
+            }
+        };
+        meterListener.SetMeasurementEventCallback<double>((_, _, tags, _) =>
+        {
+            foreach (var tag in tags)
+            {
+                if (tag.Key == "outcome")
+                {
+                    outcomes.Add(tag.Value as string);
+                }
+            }
+        });
+        meterListener.Start();
+
+        var activities = new System.Collections.Concurrent.ConcurrentBag<string>();
+        using var activityListener = new System.Diagnostics.ActivityListener
+        {
+            ShouldListenTo = source => source.Name == ScriptBoxDiagnostics.ActivitySourceName,
+            Sample = (ref System.Diagnostics.ActivityCreationOptions<System.Diagnostics.ActivityContext> _) =>
+                System.Diagnostics.ActivitySamplingResult.AllData,
+            ActivityStopped = activity => activities.Add(activity.OperationName)
+        };
+        System.Diagnostics.ActivitySource.AddActivityListener(activityListener);
+
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+        await session.RunAsync("return 1;");
+        await Assert.ThrowsAnyAsync<Exception>(() => session.RunAsync("throw new Error('boom');"));
+
+        Assert.Contains("success", outcomes);
+        Assert.Contains("error", outcomes);
+        Assert.Contains("scriptbox.script", activities);
+        Assert.Contains("scriptbox.evaluate", activities);
+    }
+
+    [Fact]
+    public async Task Diagnostics_TagUnknownHostMethodsAsUnknown()
+    {
+        var methods = new System.Collections.Concurrent.ConcurrentBag<string?>();
+        using var meterListener = new System.Diagnostics.Metrics.MeterListener();
+        meterListener.InstrumentPublished = (instrument, listener) =>
+        {
+            if (instrument.Meter.Name == ScriptBoxDiagnostics.MeterName && instrument.Name == "scriptbox.host_call.duration")
+            {
+                listener.EnableMeasurementEvents(instrument);
+            }
+        };
+        meterListener.SetMeasurementEventCallback<double>((_, _, tags, _) =>
+        {
+            foreach (var tag in tags)
+            {
+                if (tag.Key == "method")
+                {
+                    methods.Add(tag.Value as string);
+                }
+            }
+        });
+        meterListener.Start();
+
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await using var session = scriptBox.CreateSession();
+        await session.RunAsync(@"
+__scriptbox.hostCall('Add', [1, 2]);
+for (let i = 0; i < 3; i++) {
+  try { __scriptbox.hostCall('made.up.' + i, []); } catch (e) { }
+}");
+
+        Assert.Contains("Add", methods);
+        Assert.Contains("unknown", methods);
+        Assert.Empty(methods.Where(method => method?.StartsWith("made.up.", StringComparison.Ordinal) == true));
+    }
+
+    [Fact]
+    public async Task ExecuteBatchAsync_ReturnsResultsInOrderAndCapturesErrors()
+    {
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .Build();
+
+        var scripts = Enumerable.Range(0, 20)
+            .Select(i => i == 7 ? "throw new Error('row 7');" : $"console.log('row {i}'); return {i} * 2;")
+            .ToList();
+
+        var results = await scriptBox.ExecuteBatchAsync(scripts, maxParallelism: 4);
+
+        Assert.Equal(scripts.Count, results.Count);
+        for (var i = 0; i < scripts.Count; i++)
+        {
+            if (i == 7)
+            {
+                Assert.NotNull(results[i].Error);
+                Assert.Null(results[i].Result);
+                continue;
+            }
+
+            Assert.Null(results[i].Error);
+            Assert.Equal((i * 2).ToString(), results[i].Result);
+            Assert.Equal(new[] { $"row {i}" }, results[i].Logs);
+        }
+    }
+
+    [Fact]
+    public async Task ExecuteBatchAsync_InvalidParallelism_Throws()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        await Assert.ThrowsAsync<ArgumentOutOfRangeException>(() => scriptBox.ExecuteBatchAsync(new[] { "return 1;" }, 0));
+    }
+
+    [Fact]
+    public async Task Prepare_RunsWithDifferentInputs()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        var prepared = scriptBox.Prepare("return input.a + input.b + input.label.length;");
+        await using var session = scriptBox.CreateSession();
+
+        Assert.Equal("3", await session.RunAsync(prepared, new { a = 1, b = 2, label = "" }));
+        Assert.Equal("15", await session.RunAsync(prepared, new { a = 4, b = 5, label = "quote\"" }));
+
+        var result = await session.ExecuteAsync(scriptBox.Prepare("console.log(row.id); return row.id;", "row"), new { id = 7 });
+        Assert.Equal("7", result.Result);
+        Assert.Equal(new[] { "7" }, result.Logs);
+    }
+
+    [Fact]
+    public async Task Prepare_InvalidParameterName_Throws()
+    {
+        await using var scriptBox = ScriptBoxBuilder.Create().Build();
+        Assert.Throws<ArgumentException>(() => scriptBox.Prepare("return 1;", "a) { evil(); } (function b"));
+    }
+
+    [Fact]
+    public async Task StartupScript_IsLoadedOnceAndReplayedInFreshContexts()
+    {
+        var loads = 0;
+        await using var scriptBox = ScriptBoxBuilder
+            .Create()
+            .WithStartupScript(_ =>
+            {
+                Interlocked.Increment(ref loads);
+                return Task.FromResult("globalThis.counter = 0;");
+            })
+            .Build();
+
+        for (var i = 0; i < 3; i++)
+        {
+            await using var session = scriptBox.CreateSession();
+            Assert.Equal("1", await session.RunAsync("counter++; return counter;"));
+            Assert.Equal("1", await session.RunAsync("counter++; return counter;"));
+        }
+
+        Assert.Equal(1, loads);
+    }
+
+    [Fact]
+    public void WithBytecodeCache_NegativeSize_Throws()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => ScriptBoxBuilder.Create().WithBytecodeCache(-1));
+    }
 }
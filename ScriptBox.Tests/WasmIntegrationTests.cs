@@ -626,6 +626,28 @@ console.log('Name: ' + parsed.name + ', Value: ' + parsed.value);
         _mockHostApi.Verify(api => api.Log("Name: test, Value: 42"), Times.Once);
     }
 
+    [RequiresAbiFact(WasmAbiFeatures.GrowResponseBuffer)]
+    public void ExecuteScript_FileSystemReadLargeFile_ReturnsWholeContent()
+    {
+        // Arrange: far larger than the guest's initial 4KB response buffer
+        var content = string.Concat(Enumerable.Repeat("line ü\n", 40000));
+        _mockHostApi.Setup(api => api.FileSystemReadFile("big.txt"))
+                    .Returns(content);
+
+        var executor = new WasmScriptExecutor(_mockHostApi.Object);
+        var code = @"
+const first = scriptbox.fs.readFile('big.txt');
+const second = scriptbox.fs.readFile('big.txt');
+return first.length + ':' + (first === second) + ':' + first.slice(-7);
+";
+
+        // Act
+        var result = executor.ExecuteScript(code);
+
+        // Assert
+        Assert.Equal($"{content.Length}:true:line ü\n", result.Result);
+    }
+
     [Fact]
     public void ExecuteScript_FileSystemListFiles_WorksCorrectly()
     {
@@ -927,4 +949,97 @@ throw new Error('Should not reach here');
     }
 
     #endregion
+
+    #region Result Transfer Tests
+
+    [RequiresAbiFact(WasmAbiFeatures.ResultRegion)]
+    public void ExecuteScript_ResultLargerThan64KB_IsNotTruncated()
+    {
+        // Arrange
+        var executor = new WasmScriptExecutor(_mockHostApi.Object);
+        var code = "return 'x'.repeat(300000) + 'end';";
+
+        // Act
+        var result = executor.ExecuteScript(code);
+
+        // Assert
+        Assert.Equal(300003, result.Result.Length);
+        Assert.EndsWith("end", result.Result);
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.ResultRegion)]
+    public void ExecuteScript_LargeJsonResult_RoundTrips()
+    {
+        // Arrange
+        var executor = new WasmScriptExecutor(_mockHostApi.Object);
+        var code = @"
+const rows = [];
+for (let i = 0; i < 20000; i++) rows.push({ id: i, name: 'row-' + i, tag: 'ü€' });
+return rows;
+";
+
+        // Act
+        var result = executor.ExecuteScript(code);
+
+        // Assert
+        using var document = System.Text.Json.JsonDocument.Parse(result.Result);
+        Assert.Equal(20000, document.RootElement.GetArrayLength());
+        Assert.Equal("ü€", document.RootElement[19999].GetProperty("tag").GetString());
+    }
+
+    [Fact]
+    public void ExecuteScript_LargeNonAsciiScript_IsTransferredIntact()
+    {
+        // Arrange
+        var executor = new WasmScriptExecutor(_mockHostApi.Object);
+        var literal = new string('é', 200000) + "🎉";
+        var code = $"const s = '{literal}'; console.log(s.slice(-3)); return s.length;";
+
+        // Act
+        var result = executor.ExecuteScript(code);
+
+        // Assert
+        Assert.Equal("200002", result.Result);
+        Assert.Equal(new[] { "é🎉" }, result.Logs);
+    }
+
+    [RequiresAbiFact(WasmAbiFeatures.InputAlloc)]
+    public void ExecuteScript_ScriptLargerThanLegacyBuffer_Executes()
+    {
+        // Arrange: beyond the old fixed 1MB script buffer
+        var executor = new WasmScriptExecutor(_mockHostApi.Object);
+        var literal = new string('x', 3 * 1024 * 1024);
+        var code = $"const s = '{literal}'; return s.length;";
+
+        // Act
+        var first = executor.ExecuteScript(code);
+        var second = executor.ExecuteScript("return 'small';");
+
+        // Assert
+        Assert.Equal((3 * 1024 * 1024).ToString(), first.Result);
+        Assert.Equal("small", second.Result);
+    }
+
+    [Fact]
+    public void WasmRuntime_SameModuleAndSettings_SharesOneCompile()
+    {
+        // Arrange
+        var source = WasmModuleSource.FromBytes(DefaultRuntimeResources.LoadEmbeddedWasm());
+        var options = WasmExecutorOptions.CreateDefault();
+        var fuelOptions = new WasmExecutorOptions { FuelPerScript = 1_000_000 };
+        var unsharedOptions = new WasmExecutorOptions { ShareModule = false };
+
+        // Act
+        using var first = WasmRuntime.Acquire(source, options);
+        using var second = WasmRuntime.Acquire(WasmModuleSource.FromBytes(DefaultRuntimeResources.LoadEmbeddedWasm()), options);
+        using var fuel = WasmRuntime.Acquire(source, fuelOptions);
+        using var unshared = WasmRuntime.Acquire(source, unsharedOptions);
+
+        // Assert
+        Assert.Same(first, second);
+        Assert.NotSame(first, fuel);
+        Assert.NotSame(first, unshared);
+    }
+
+    #endregion
 }
@@ -2,12 +2,66 @@
 
 # QuickJS WASM Module Build Script
 # Compiles QuickJS + scriptbox_wrapper.c to WebAssembly
+#
+# Usage:
+#   ./build.sh              Build scriptbox.wasm (debug profile: -O0)
+#   ./build.sh --release    Also build scriptbox.release.wasm (-O3, LTO, wasm-opt when available).
+#                           The host embeds both and prefers the release module. With --snapshot the
+#                           snapshot is built with the release profile too.
+#   ./build.sh --snapshot   Also build scriptbox.snapshot.wasm, a Wizer snapshot taken
+#                           after the runtime, host bridge and core bootstrap
+#                           (scripts/sdk/scriptbox.js + bootstrap-utils.js) are initialized.
+#                           Requires wizer (https://github.com/bytecodealliance/wizer) on PATH
+#                           or in $WIZER.
+#   ./build.sh --precompile Also emit Wasmtime-precompiled native code (precompiled/scriptbox.<triple>.cwasm,
+#                           plus scriptbox.snapshot.<triple>.cwasm with --snapshot) for every triple in
+#                           $PRECOMPILE_TARGETS. Requires the wasmtime CLI (on PATH or in $WASMTIME) of the
+#                           same version as the Wasmtime NuGet package, otherwise the host falls back to
+#                           compiling the .wasm at startup. Artifacts are compiled with epoch interruption,
+#                           matching the host default; set PRECOMPILE_FLAGS to match other engine settings
+#                           (e.g. "-W epoch-interruption=y,consume-fuel=y" with WithFuelLimit).
 
 set -e
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="${SCRIPT_DIR}/build"
 OUTPUT="${SCRIPT_DIR}/scriptbox.wasm"
+RELEASE_OUTPUT="${SCRIPT_DIR}/scriptbox.release.wasm"
+SNAPSHOT_OUTPUT="${SCRIPT_DIR}/scriptbox.snapshot.wasm"
+SCRIPTS_DIR="${SCRIPT_DIR}/../scripts"
+PRECOMPILED_DIR="${SCRIPT_DIR}/precompiled"
+
+# Keep in sync with the Wasmtime PackageReference in ScriptBox/ScriptBox.csproj
+WASMTIME_VERSION="34"
+PRECOMPILE_TARGETS="${PRECOMPILE_TARGETS:-x86_64-unknown-linux-gnu aarch64-unknown-linux-gnu x86_64-apple-darwin aarch64-apple-darwin x86_64-pc-windows-msvc}"
+# Codegen flags the host engine must match (WasmExecutorOptions.EpochInterruption / FuelPerScript)
+PRECOMPILE_FLAGS="${PRECOMPILE_FLAGS:--W epoch-interruption=y}"
+
+# Shadow stack for the C/QuickJS call stack. wasm-ld defaults to 64KB, which deep recursion
+# overflows; scriptbox_wrapper.c caps QuickJS's own stack limit just below this value.
+STACK_SIZE="${STACK_SIZE:-4194304}"
+
+BUILD_SNAPSHOT=0
+BUILD_RELEASE=0
+PRECOMPILE=0
+for arg in "$@"; do
+    case "$arg" in
+        --snapshot)
+            BUILD_SNAPSHOT=1
+            ;;
+        --release)
+            BUILD_RELEASE=1
+            ;;
+        --precompile)
+            PRECOMPILE=1
+            ;;
+        *)
+            echo "❌ Unknown option: $arg"
+            echo "Usage: $0 [--release] [--snapshot] [--precompile]"
+            exit 1
+            ;;
+    esac
+done
 
 echo "=========================================="
 echo "QuickJS WASM Module Builder"
@@ -102,7 +156,9 @@ echo "🔧 Applying WASI compatibility fixes..."
 cd "$QUICKJS_DIR"
 
 # Fix 1: Add __wasi__ conditional to js_def_malloc_usable_size
-# This prevents WASI builds from trying to use platform-specific malloc_size functions
+# This prevents WASI builds from trying to use platform-specific malloc_size functions.
+# The default allocator is only compiled, not used: scriptbox_wrapper.c creates every
+# runtime with its own allocator that tracks block sizes, so memory limits still work
 if ! grep -q "__wasi__" quickjs.c; then
     # Use sed to find the _WIN32 section and add __wasi__ case after it
     # Note: Using printf for cross-platform newline handling
@@ -129,40 +185,114 @@ echo ""
 echo "🔨 Compiling QuickJS + scriptbox_wrapper.c to WASM..."
 echo ""
 
-# Compile to WASM with minimal optimizations for stable build
+# Build profiles. Debug keeps -O0 for readable stack traces when diagnosing the guest;
+# release is what production should run. Both reserve an explicit shadow stack.
+DEBUG_FLAGS=(-O0)
+RELEASE_FLAGS=(-O3 -flto -Wl,--lto-O3)
+
 # Use -Wno-error to convert errors to warnings for compatibility
-# NOTE: Using -O0 to diagnose if aggressive size optimization (-Oz) is causing stack overflow
-$CLANG \
-    --target=wasm32-wasi \
-    -I "$QUICKJS_DIR" \
-    -I "$WASI_SDK_PATH/include" \
-    -O0 \
-    -Wall \
-    -Wno-error=implicit-function-declaration \
-    -Wno-error=format \
-    -Wno-format-pedantic \
-    -mllvm -wasm-enable-sjlj \
-    -D_WASI_EMULATED_MMAN \
-    -D_WASI_EMULATED_SIGNAL \
-    -D_WASI_EMULATED_GETPID \
-    "$QUICKJS_DIR/quickjs.c" \
-    "$QUICKJS_DIR/libregexp.c" \
-    "$QUICKJS_DIR/libunicode.c" \
-    "$QUICKJS_DIR/cutils.c" \
-    "$QUICKJS_DIR/dtoa.c" \
-    "$SCRIPT_DIR/scriptbox_wrapper.c" \
-    -o "$OUTPUT" \
-    -Wl,--export=eval_js \
-    -Wl,--export=quickjs_selftest \
-    -Wl,--export=get_last_error_ptr \
-    -Wl,--export=get_last_error_len \
-    -Wl,--export=get_result_ptr \
-    -Wl,--export=get_result_len \
-    -Wl,--export=get_script_buffer_ptr \
-    -Wl,--export=get_script_buffer_len \
-    -Wl,--no-entry \
-    -Wl,--strip-all
+# Usage: compile_module <output> [extra clang args...]
+compile_module() {
+    local output="$1"
+    shift
+
+    $CLANG \
+        --target=wasm32-wasi \
+        -I "$QUICKJS_DIR" \
+        -I "$WASI_SDK_PATH/include" \
+        -DSCRIPTBOX_STACK_SIZE="$STACK_SIZE" \
+        -Wl,-z,stack-size="$STACK_SIZE" \
+        -Wall \
+        -Wno-error=implicit-function-declaration \
+        -Wno-error=format \
+        -Wno-format-pedantic \
+        -mllvm -wasm-enable-sjlj \
+        -D_WASI_EMULATED_MMAN \
+        -D_WASI_EMULATED_SIGNAL \
+        -D_WASI_EMULATED_GETPID \
+        "$@" \
+        "$QUICKJS_DIR/quickjs.c" \
+        "$QUICKJS_DIR/libregexp.c" \
+        "$QUICKJS_DIR/libunicode.c" \
+        "$QUICKJS_DIR/cutils.c" \
+        "$QUICKJS_DIR/dtoa.c" \
+        "$SCRIPT_DIR/scriptbox_wrapper.c" \
+        -o "$output" \
+        -Wl,--export=eval_js \
+        -Wl,--export=quickjs_selftest \
+        -Wl,--export=get_last_error_ptr \
+        -Wl,--export=get_last_error_len \
+        -Wl,--export=get_result_ptr \
+        -Wl,--export=get_result_len \
+        -Wl,--export=get_result_region \
+        -Wl,--export=free_result \
+        -Wl,--export=grow_response_buffer \
+        -Wl,--export=alloc_input \
+        -Wl,--export=free_input \
+        -Wl,--export=get_script_buffer_ptr \
+        -Wl,--export=get_script_buffer_len \
+        -Wl,--export=is_preinitialized \
+        -Wl,--export=eval_js_shared \
+        -Wl,--export=get_abi_features \
+        -Wl,--export=context_create \
+        -Wl,--export=context_eval \
+        -Wl,--export=context_free \
+        -Wl,--export=compile_js \
+        -Wl,--export=get_bytecode_ptr \
+        -Wl,--export=get_bytecode_len \
+        -Wl,--export=context_eval_bytecode \
+        -Wl,--export=complete_host_call \
+        -Wl,--export=set_memory_limits \
+        -Wl,--export=get_heap_in_use \
+        -Wl,--export=context_call_bytecode \
+        -Wl,--export=get_memory_stats \
+        -Wl,--export=set_interrupt_deadline \
+        -Wl,--export=was_interrupted \
+        -Wl,--export=set_profiler \
+        -Wl,--export=get_profile \
+        -Wl,--no-entry \
+        -Wl,--strip-all
+}
+
+# Embed the given files as one NUL-terminated C array (SCRIPTBOX_BOOTSTRAP_SOURCE).
+# Uses od so the build does not depend on xxd being installed.
+# Usage: generate_bootstrap_header <output.h> <file>...
+generate_bootstrap_header() {
+    local output="$1"
+    shift
+
+    {
+        echo "// Generated by build.sh --snapshot. Do not edit."
+        echo "static const char SCRIPTBOX_BOOTSTRAP_SOURCE[] = {"
+        for file in "$@"; do
+            od -An -v -tx1 "$file" | sed -e 's/\([0-9a-f][0-9a-f]\)/0x\1,/g'
+            echo "0x0a, 0x0a,"
+        done
+        echo "0x00 };"
+        echo "#define SCRIPTBOX_BOOTSTRAP_SOURCE_LEN (sizeof(SCRIPTBOX_BOOTSTRAP_SOURCE) - 1)"
+    } > "$output"
+}
+
+# Post-process with Binaryen when installed. The feature flags must cover what wasi-sdk
+# emits (sjlj lowers to exception handling); override them via WASM_OPT_FLAGS if needed.
+# Usage: optimize_module <file>
+optimize_module() {
+    local file="$1"
+    WASM_OPT="${WASM_OPT:-wasm-opt}"
+
+    if ! command -v "$WASM_OPT" &> /dev/null; then
+        echo "⚠️  wasm-opt not found (set WASM_OPT or install binaryen); skipping post-processing of $(basename "$file")"
+        return 0
+    fi
 
+    "$WASM_OPT" -O3 \
+        ${WASM_OPT_FLAGS:---enable-bulk-memory --enable-sign-ext --enable-mutable-globals --enable-nontrapping-float-to-int --enable-exception-handling} \
+        -o "$file.opt" "$file"
+    mv "$file.opt" "$file"
+    echo "   ✓ wasm-opt: $(basename "$file")"
+}
+
+compile_module "$OUTPUT" "${DEBUG_FLAGS[@]}"
 if [ $? -eq 0 ]; then
     SIZE=$(stat -f%z "$OUTPUT" 2>/dev/null || stat -c%s "$OUTPUT" 2>/dev/null)
     SIZE_KB=$((SIZE / 1024))
@@ -172,11 +302,95 @@ if [ $? -eq 0 ]; then
     echo "📊 Size: ${SIZE_KB}KB"
     echo "🔧 WASI SDK: $WASI_SDK_PATH"
     echo ""
-    echo "Next steps:"
-    echo "  1. Rebuild ScriptBox: dotnet build ScriptBox/ScriptBox.csproj"
-    echo "  2. Run the demo: dotnet run --project ScriptBox.Demo/ScriptBox.Demo.csproj"
 else
     echo ""
     echo "❌ Build failed!"
     exit 1
 fi
+
+if [ "$BUILD_RELEASE" -eq 1 ]; then
+    echo "🚀 Building release profile..."
+    compile_module "$RELEASE_OUTPUT" "${RELEASE_FLAGS[@]}"
+    optimize_module "$RELEASE_OUTPUT"
+
+    RELEASE_SIZE=$(stat -f%z "$RELEASE_OUTPUT" 2>/dev/null || stat -c%s "$RELEASE_OUTPUT" 2>/dev/null)
+    echo "✅ Release: $RELEASE_OUTPUT ($((RELEASE_SIZE / 1024))KB)"
+    echo ""
+fi
+
+if [ "$BUILD_SNAPSHOT" -eq 1 ]; then
+    WIZER="${WIZER:-wizer}"
+    if ! command -v "$WIZER" &> /dev/null; then
+        echo "❌ wizer not found (set WIZER or install it with: cargo install wizer --all-features)"
+        exit 1
+    fi
+
+    echo "📸 Building pre-initialized snapshot..."
+
+    # Same bootstrap the host would otherwise prepend (DefaultRuntimeResources.LoadCoreBootstrap)
+    generate_bootstrap_header "$BUILD_DIR/snapshot_bootstrap.h" \
+        "$SCRIPTS_DIR/sdk/scriptbox.js" \
+        "$SCRIPTS_DIR/dist/sdk/bootstrap-utils.js"
+
+    SNAPSHOT_FLAGS=("${DEBUG_FLAGS[@]}")
+    if [ "$BUILD_RELEASE" -eq 1 ]; then
+        SNAPSHOT_FLAGS=("${RELEASE_FLAGS[@]}")
+    fi
+
+    compile_module "$BUILD_DIR/scriptbox.pre-snapshot.wasm" \
+        "${SNAPSHOT_FLAGS[@]}" \
+        -DSCRIPTBOX_SNAPSHOT \
+        -I "$BUILD_DIR"
+
+    # wizer.initialize runs the bootstrap once; its linear memory becomes the module's data segments.
+    # Extra flags (e.g. for wasm proposals used by -wasm-enable-sjlj) can be passed via WIZER_FLAGS.
+    "$WIZER" \
+        --allow-wasi \
+        --wasm-bulk-memory true \
+        ${WIZER_FLAGS:-} \
+        -o "$SNAPSHOT_OUTPUT" \
+        "$BUILD_DIR/scriptbox.pre-snapshot.wasm"
+
+    SNAPSHOT_SIZE=$(stat -f%z "$SNAPSHOT_OUTPUT" 2>/dev/null || stat -c%s "$SNAPSHOT_OUTPUT" 2>/dev/null)
+    echo "✅ Snapshot: $SNAPSHOT_OUTPUT ($((SNAPSHOT_SIZE / 1024))KB)"
+    echo ""
+fi
+
+if [ "$PRECOMPILE" -eq 1 ]; then
+    WASMTIME="${WASMTIME:-wasmtime}"
+    if ! command -v "$WASMTIME" &> /dev/null; then
+        echo "❌ wasmtime CLI not found (set WASMTIME or install Wasmtime ${WASMTIME_VERSION}.x)"
+        exit 1
+    fi
+
+    # Precompiled artifacts only load into the exact Wasmtime version that produced them
+    WASMTIME_CLI_VERSION=$("$WASMTIME" --version | awk '{print $2}')
+    if [ "${WASMTIME_CLI_VERSION%%.*}" != "$WASMTIME_VERSION" ]; then
+        echo "⚠️  wasmtime CLI is ${WASMTIME_CLI_VERSION}, the host uses ${WASMTIME_VERSION}.x; artifacts will be rejected at load time"
+    fi
+
+    echo "⚙️  Precompiling for: $PRECOMPILE_TARGETS"
+    mkdir -p "$PRECOMPILED_DIR"
+
+    # Precompile the module the host would load by default
+    PRECOMPILE_INPUT="$OUTPUT"
+    if [ "$BUILD_RELEASE" -eq 1 ]; then
+        PRECOMPILE_INPUT="$RELEASE_OUTPUT"
+    fi
+
+    for target in $PRECOMPILE_TARGETS; do
+        "$WASMTIME" compile $PRECOMPILE_FLAGS --target "$target" -o "$PRECOMPILED_DIR/scriptbox.${target}.cwasm" "$PRECOMPILE_INPUT"
+        echo "   ✓ scriptbox.${target}.cwasm"
+
+        if [ "$BUILD_SNAPSHOT" -eq 1 ]; then
+            "$WASMTIME" compile $PRECOMPILE_FLAGS --target "$target" -o "$PRECOMPILED_DIR/scriptbox.snapshot.${target}.cwasm" "$SNAPSHOT_OUTPUT"
+            echo "   ✓ scriptbox.snapshot.${target}.cwasm"
+        fi
+    done
+
+    echo "✅ Precompiled modules: $PRECOMPILED_DIR"
+    echo ""
+fi
+
+echo "Next step:"
+echo "  Rebuild ScriptBox: dotnet build ScriptBox/ScriptBox.csproj"
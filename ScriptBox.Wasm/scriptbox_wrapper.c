@@ -2,10 +2,27 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
 
-#define NULL_LITERAL_SIZE 5  // "null" + trailing '\0'
 static const char LITERAL_NULL[] = "null";
 
+// Shadow stack reserved by the linker; build.sh passes the same value to -Wl,-z,stack-size.
+// QuickJS is limited to the stack minus a margin for the C frames outside the interpreter,
+// so runaway recursion raises a RangeError instead of overrunning the stack into the heap.
+#ifndef SCRIPTBOX_STACK_SIZE
+#define SCRIPTBOX_STACK_SIZE 0
+#endif
+#define SCRIPTBOX_STACK_MARGIN (256 * 1024)
+#if SCRIPTBOX_STACK_SIZE > SCRIPTBOX_STACK_MARGIN
+#define SCRIPTBOX_JS_MAX_STACK (SCRIPTBOX_STACK_SIZE - SCRIPTBOX_STACK_MARGIN)
+#else
+#define SCRIPTBOX_JS_MAX_STACK 0  // Unknown stack size: no limit, as before
+#endif
+
 // ============================================================================
 // QuickJS WASM ScriptBox Bridge - Error Handling and Evaluation Infrastructure
 // ============================================================================
@@ -26,23 +43,231 @@ int host_call(const char* in_ptr, int in_len,
 __attribute__((import_module("host"), import_name("log")))
 void host_log(const char* ptr, int len);
 
+// Several console entries at once: [uint32 length, little endian][length bytes of UTF-8], repeated
+__attribute__((import_module("host"), import_name("log_batch")))
+void host_log_batch(const char* ptr, int len);
+
+// ---------- Log buffer ----------
+//
+// console.log appends entries here instead of crossing into the host for each
+// one. The buffer is flushed when full, before every host call (so host side
+// effects and logs stay in order) and when an evaluation returns to the host.
+
+#define LOG_BUFFER_SIZE (16 * 1024) // 16KB
+#define LOG_ENTRY_HEADER_SIZE 4
+
+static char g_log_buffer[LOG_BUFFER_SIZE];
+static size_t g_log_len = 0;
+
+static void flush_logs(void) {
+    if (g_log_len == 0) {
+        return;
+    }
+
+    size_t len = g_log_len;
+    g_log_len = 0;
+    host_log_batch(g_log_buffer, (int)len);
+}
+
+static void append_log(const char* text, size_t len) {
+    if (len > LOG_BUFFER_SIZE - LOG_ENTRY_HEADER_SIZE) {
+        // Entries that could never fit go out on their own, after the ones before them
+        flush_logs();
+        host_log(text, (int)len);
+        return;
+    }
+
+    if (LOG_ENTRY_HEADER_SIZE + len > LOG_BUFFER_SIZE - g_log_len) {
+        flush_logs();
+    }
+
+    unsigned char* entry = (unsigned char*)g_log_buffer + g_log_len;
+    entry[0] = (unsigned char)(len & 0xff);
+    entry[1] = (unsigned char)((len >> 8) & 0xff);
+    entry[2] = (unsigned char)((len >> 16) & 0xff);
+    entry[3] = (unsigned char)((len >> 24) & 0xff);
+    memcpy(entry + LOG_ENTRY_HEADER_SIZE, text, len);
+    g_log_len += LOG_ENTRY_HEADER_SIZE + len;
+}
+
+/** Flushes the log buffer on the way back to the host; returns status unchanged */
+static int end_step(int status) {
+    flush_logs();
+    return status;
+}
+
 // ---------- Error reporting infrastructure ----------
 
 // Global error message buffer for inter-process communication
 // Accessible from host via get_last_error_ptr() and get_last_error_len()
 static char g_last_error[1024];
 
-// Global result buffer for returning JavaScript values to the host
-// Accessible from host via get_result_ptr() and get_result_len()
-static char g_result[65536];  // 64KB buffer for result values
+// Result of the last evaluation, allocated to size:
+//   [uint32 length, little endian][length bytes of UTF-8][NUL]
+// Accessible from host via get_result_region() (or get_result_ptr()/get_result_len()),
+// released by free_result() or when the next result is stored
+#define RESULT_HEADER_SIZE 4
+static unsigned char* g_result_region = NULL;
 
-// Global script buffer for receiving JavaScript source code from the host
-// Accessible from host via get_script_buffer_ptr() and get_script_buffer_len()
+// Script input from the host, sized per script and NUL-terminated so JS_Eval
+// can parse it in place. Managed via alloc_input()/free_input()
+static char* g_input = NULL;
+static int g_input_cap = 0;
+
+// Legacy fixed-size script buffer for hosts that predate alloc_input.
+// Allocated on first use by get_script_buffer_ptr() instead of living in
+// static data, so it no longer adds 1MB to every instance's linear memory
 #define SCRIPT_BUFFER_SIZE (1024 * 1024) // 1MB
-static char g_script_buffer[SCRIPT_BUFFER_SIZE];
+static char* g_script_buffer = NULL;
 
 // ---------- Global QuickJS state ----------
-// Note: Each eval_js call creates its own runtime/context for isolation
+// Note: Each eval_js call creates its own runtime/context for isolation;
+// eval_js_shared keeps one runtime per instance (see "Shared runtime" below)
+
+#ifdef SCRIPTBOX_SNAPSHOT
+// Generated by build.sh --snapshot: the core bootstrap (scripts/sdk/scriptbox.js
+// followed by scripts/dist/sdk/bootstrap-utils.js) as SCRIPTBOX_BOOTSTRAP_SOURCE.
+#include "snapshot_bootstrap.h"
+
+// Runtime/context created by wizer.initialize and captured in the snapshot.
+// Every instance starts from the same linear memory, so the first eval_js call
+// of each instance receives a context in which the bootstrap has already run.
+static JSRuntime* g_snapshot_rt = NULL;
+static JSContext* g_snapshot_ctx = NULL;
+static int g_snapshot_consumed = 0;
+static int g_snapshot_initialized = 0;
+#endif
+
+// ---------- Runtime allocator ----------
+//
+// QuickJS charges every allocation to its runtime by usable size; that is what
+// JS_SetMemoryLimit enforces and what paces the GC. wasi-libc cannot report a
+// block's size (build.sh makes js_def_malloc_usable_size return 0), so with the
+// default allocator the limit never triggered and the GC ran on allocation
+// counts alone. Runtimes created here record each block's size in a header
+// instead, and all of them charge one heap total per instance.
+
+// Keeps payloads at malloc's 16-byte alignment
+#define HEAP_HEADER_SIZE 16
+
+typedef struct ScriptBoxHeap {
+    size_t in_use;  // payload bytes currently allocated by QuickJS
+    size_t peak;    // high-water mark of in_use since the last get_memory_stats
+} ScriptBoxHeap;
+
+static ScriptBoxHeap g_heap = { 0, 0 };
+
+// Set by set_memory_limits; 0 keeps the QuickJS default (no limit / 256KB threshold)
+static size_t g_memory_limit = 0;
+static size_t g_gc_threshold = 0;
+
+static void* heap_track(ScriptBoxHeap* heap, unsigned char* block, size_t size) {
+    if (block == NULL) {
+        return NULL;
+    }
+
+    memcpy(block, &size, sizeof(size));
+    heap->in_use += size;
+    if (heap->in_use > heap->peak) {
+        heap->peak = heap->in_use;
+    }
+    return block + HEAP_HEADER_SIZE;
+}
+
+static size_t heap_block_size(const void* ptr) {
+    size_t size;
+    memcpy(&size, (const unsigned char*)ptr - HEAP_HEADER_SIZE, sizeof(size));
+    return size;
+}
+
+static void* heap_malloc(void* opaque, size_t size) {
+    if (size > SIZE_MAX - HEAP_HEADER_SIZE) {
+        return NULL;
+    }
+    return heap_track(opaque, malloc(size + HEAP_HEADER_SIZE), size);
+}
+
+static void* heap_calloc(void* opaque, size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - HEAP_HEADER_SIZE) / size) {
+        return NULL;
+    }
+    return heap_track(opaque, calloc(1, count * size + HEAP_HEADER_SIZE), count * size);
+}
+
+static void heap_free(void* opaque, void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    ScriptBoxHeap* heap = opaque;
+    heap->in_use -= heap_block_size(ptr);
+    free((unsigned char*)ptr - HEAP_HEADER_SIZE);
+}
+
+static void* heap_realloc(void* opaque, void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return size == 0 ? NULL : heap_malloc(opaque, size);
+    }
+
+    if (size == 0) {
+        heap_free(opaque, ptr);
+        return NULL;
+    }
+
+    if (size > SIZE_MAX - HEAP_HEADER_SIZE) {
+        return NULL;
+    }
+
+    ScriptBoxHeap* heap = opaque;
+    size_t old_size = heap_block_size(ptr);
+    unsigned char* block = realloc((unsigned char*)ptr - HEAP_HEADER_SIZE, size + HEAP_HEADER_SIZE);
+    if (block == NULL) {
+        return NULL;  // the old block is still allocated and still charged
+    }
+
+    heap->in_use -= old_size;
+    return heap_track(heap, block, size);
+}
+
+static size_t heap_usable_size(const void* ptr) {
+    return ptr == NULL ? 0 : heap_block_size(ptr);
+}
+
+static const JSMallocFunctions g_heap_functions = {
+    heap_calloc,
+    heap_malloc,
+    heap_free,
+    heap_realloc,
+    heap_usable_size,
+};
+
+// Polls the deadline and takes profile samples; defined with the exports below
+static int interrupt_handler(JSRuntime* rt, void* opaque);
+
+static void apply_memory_limits(JSRuntime* rt) {
+    if (rt == NULL) {
+        return;
+    }
+
+    JS_SetMemoryLimit(rt, g_memory_limit);
+    if (g_gc_threshold != 0) {
+        JS_SetGCThreshold(rt, g_gc_threshold);
+    }
+}
+
+/**
+ * @brief Create a runtime on the tracked allocator with the stack and memory limits applied
+ * @return The runtime, or NULL if it could not be created
+ */
+static JSRuntime* new_runtime(void) {
+    JSRuntime* rt = JS_NewRuntime2(&g_heap_functions, &g_heap);
+    if (rt != NULL) {
+        JS_SetMaxStackSize(rt, SCRIPTBOX_JS_MAX_STACK);
+        apply_memory_limits(rt);
+        JS_SetInterruptHandler(rt, interrupt_handler, NULL);
+    }
+    return rt;
+}
 
 // ---------- Error message handling ----------
 //
@@ -101,6 +326,49 @@ static void capture_exception(JSContext* ctx, JSValue exc) {
 
 // ---------- JS <-> host_call bridge ----------
 
+// Response buffer handed to host_call. Two-phase protocol: when a response does not fit,
+// the host calls grow_response_buffer(len) from inside host_call and writes into the
+// returned buffer; host_call always returns the full response length. Buffers grown
+// beyond RESPONSE_BUFFER_RETAIN are released after the response has been consumed.
+#define RESPONSE_BUFFER_INITIAL 4096
+#define RESPONSE_BUFFER_RETAIN (64 * 1024)
+static char g_response_small[RESPONSE_BUFFER_INITIAL];
+static char* g_response_buf = g_response_small;
+static int g_response_cap = RESPONSE_BUFFER_INITIAL;
+
+/**
+ * @brief Ensure the host-call response buffer holds at least len bytes
+ * @return The (possibly new) buffer, or NULL if it could not be allocated
+ *
+ * Called by the host during host_call. The previous contents are discarded.
+ */
+__attribute__((export_name("grow_response_buffer")))
+char* grow_response_buffer(int len) {
+    if (len <= g_response_cap) {
+        return g_response_buf;
+    }
+
+    char* buf = malloc((size_t)len);
+    if (!buf) {
+        return NULL;
+    }
+
+    if (g_response_buf != g_response_small) {
+        free(g_response_buf);
+    }
+    g_response_buf = buf;
+    g_response_cap = len;
+    return buf;
+}
+
+static void trim_response_buffer(void) {
+    if (g_response_cap > RESPONSE_BUFFER_RETAIN) {
+        free(g_response_buf);
+        g_response_buf = g_response_small;
+        g_response_cap = RESPONSE_BUFFER_INITIAL;
+    }
+}
+
 // JS signature: __host.bridge(payload: string): string | null
 // This function bridges JavaScript calls to the host via the WASM import.
 // It accepts a JSON string, forwards it to the host, and returns the host's response.
@@ -119,13 +387,11 @@ static JSValue js_bridge_call(JSContext *ctx, JSValueConst this_val,
         return JS_ThrowTypeError(ctx, "bridge argument must be a string");
     }
     
-    // Prepare output buffer for host response
-    // Using a reasonable fixed size; could be made dynamic if needed
-    char response_buf[4096];
-    
     // Call the host via WASM import
     // host_call(input_ptr, input_len, output_ptr, output_capacity)
-    int response_len = host_call(payload, (int)payload_len, response_buf, sizeof(response_buf));
+    // The host may replace g_response_buf through grow_response_buffer during the call.
+    flush_logs();
+    int response_len = host_call(payload, (int)payload_len, g_response_buf, g_response_cap);
     
     // Clean up the input string
     JS_FreeCString(ctx, payload);
@@ -139,379 +405,2484 @@ static JSValue js_bridge_call(JSContext *ctx, JSValueConst this_val,
         // Host returned empty response - return null
         return JS_NULL;
     }
+
+    if (response_len > g_response_cap) {
+        // The host could not grow the buffer (allocation failed)
+        return JS_ThrowInternalError(ctx, "Host response too large (%d bytes)", response_len);
+    }
     
     // Return the host's response as a JavaScript string
-    return JS_NewStringLen(ctx, response_buf, response_len);
+    JSValue response = JS_NewStringLen(ctx, g_response_buf, response_len);
+    trim_response_buffer();
+    return response;
 }
 
-// Note: Host bridge is installed per-evaluation in eval_js()
+// ---------- Async host calls ----------
+//
+// __host.bridgeAsync(payload) sends {"callId":N,"request":<payload>} through host_call
+// and returns a promise for the response string. The host either answers right away
+// (non-empty response) or returns 0 bytes and runs the call in the background; it then
+// delivers the response with complete_host_call(N, ...), which resolves the promise and
+// drains the job queue. Pending calls belong to the context that made them and are
+// dropped with it.
 
-// ---------- Error reporting ----------
+typedef struct PendingHostCall {
+    int id;
+    JSContext* ctx;
+    JSValue resolve;
+} PendingHostCall;
 
-/**
- * @brief Get pointer to script buffer
- * @return Pointer to the script buffer
- */
-__attribute__((export_name("get_script_buffer_ptr")))
-char* get_script_buffer_ptr(void) {
-    return g_script_buffer;
-}
+static PendingHostCall* g_pending_calls = NULL;
+static int g_pending_count = 0;
+static int g_pending_cap = 0;
+static int g_next_call_id = 1;
 
 /**
- * @brief Get length of script buffer
- * @return Length in bytes
+ * @brief Make room for one more pending call
+ * @return 0 on success, -1 if the table could not grow
  */
-__attribute__((export_name("get_script_buffer_len")))
-int get_script_buffer_len(void) {
-    return SCRIPT_BUFFER_SIZE;
-}
+static int reserve_pending_call(void) {
+    if (g_pending_count < g_pending_cap) {
+        return 0;
+    }
 
-/**
- * @brief Get pointer to error message buffer
- * @return Pointer to null-terminated error string (valid until next eval_js call)
- * 
- * The returned pointer points to WASM linear memory and is valid for the
- * lifetime of the current WASM instance. Use get_last_error_len() to determine
- * the length before copying.
- */
-__attribute__((export_name("get_last_error_ptr")))
-const char* get_last_error_ptr(void) {
-    return g_last_error;
+    int cap = g_pending_cap == 0 ? 8 : g_pending_cap * 2;
+    PendingHostCall* calls = realloc(g_pending_calls, (size_t)cap * sizeof(PendingHostCall));
+    if (!calls) {
+        return -1;
+    }
+
+    g_pending_calls = calls;
+    g_pending_cap = cap;
+    return 0;
 }
 
 /**
- * @brief Get length of error message
- * @return Length in bytes (not including null terminator)
+ * @brief Remove the pending call with the given id
+ * @return 1 if found (copied to out), 0 otherwise
  */
-__attribute__((export_name("get_last_error_len")))
-int get_last_error_len(void) {
-    return (int)strlen(g_last_error);
+static int take_pending_call(int id, PendingHostCall* out) {
+    for (int i = 0; i < g_pending_count; i++) {
+        if (g_pending_calls[i].id == id) {
+            *out = g_pending_calls[i];
+            g_pending_calls[i] = g_pending_calls[--g_pending_count];
+            return 1;
+        }
+    }
+    return 0;
 }
 
-/**
- * @brief Get pointer to result buffer
- * @return Pointer to null-terminated result string (valid until next eval_js call)
- *
- * The returned pointer points to WASM linear memory and is valid for the
- * lifetime of the current WASM instance. Use get_result_len() to determine
- * the length before copying.
- */
-__attribute__((export_name("get_result_ptr")))
-const char* get_result_ptr(void) {
-    return g_result;
+static int has_pending_calls(JSContext* ctx) {
+    for (int i = 0; i < g_pending_count; i++) {
+        if (g_pending_calls[i].ctx == ctx) {
+            return 1;
+        }
+    }
+    return 0;
 }
 
 /**
- * @brief Get length of result
- * @return Length in bytes (not including null terminator)
+ * @brief Forget the pending calls of a context that is about to be freed
+ *
+ * Responses that arrive later for these ids are ignored by complete_host_call.
  */
-__attribute__((export_name("get_result_len")))
-int get_result_len(void) {
-    return (int)strlen(g_result);
+static void drop_pending_calls(JSContext* ctx) {
+    int kept = 0;
+    for (int i = 0; i < g_pending_count; i++) {
+        if (g_pending_calls[i].ctx == ctx) {
+            JS_FreeValue(ctx, g_pending_calls[i].resolve);
+        } else {
+            g_pending_calls[kept++] = g_pending_calls[i];
+        }
+    }
+    g_pending_count = kept;
 }
 
-// ---------- Console logging ----------
-
-static JSValue js_console_log(JSContext *ctx, JSValueConst this_val,
-                              int argc, JSValueConst *argv)
+// JS signature: __host.bridgeAsync(payload: string): Promise<string | null>
+// Same payload and response format as __host.bridge.
+static JSValue js_bridge_call_async(JSContext *ctx, JSValueConst this_val,
+                                    int argc, JSValueConst *argv)
 {
-    size_t len = 0;
-    const char* str = JS_ToCStringLen(ctx, &len, argv[0]);
-    if (!str)
-        return JS_EXCEPTION;
-
-    host_log(str, (int)len);
-    JS_FreeCString(ctx, str);
-    return JS_UNDEFINED;
-}
+    if (argc < 1) {
+        return JS_ThrowTypeError(ctx, "bridgeAsync requires 1 argument (JSON string)");
+    }
 
-// ---------- Host bridge installation ----------
+    size_t payload_len;
+    const char* payload = JS_ToCStringLen(ctx, &payload_len, argv[0]);
+    if (!payload) {
+        return JS_ThrowTypeError(ctx, "bridgeAsync argument must be a string");
+    }
 
-// Install host bridge (console.log, __host.bridge) into the JS context.
-// This provides the minimal, stable bridge primitives.
-// Higher-level APIs (scriptbox, etc.) are injected as JS by the host.
-static int install_host_bridge(JSContext* ctx) {
-    JSValue global = JS_GetGlobalObject(ctx);
-    if (JS_IsUndefined(global) || JS_IsNull(global)) {
-        JS_FreeValue(ctx, global);
-        set_error("Global object is null/undefined - context initialization failed");
-        return -1;
+    if (reserve_pending_call() != 0) {
+        JS_FreeCString(ctx, payload);
+        return JS_ThrowOutOfMemory(ctx);
     }
 
-    // -------- Install console.log --------
-    JSValue console = JS_NewObject(ctx);
-    if (JS_IsException(console)) {
-        JS_FreeValue(ctx, global);
-        set_error("Failed to create console object");
-        return -1;
+    int id = g_next_call_id;
+    g_next_call_id = g_next_call_id == INT_MAX ? 1 : g_next_call_id + 1;
+
+    // Envelope: {"callId":N,"request":<payload>}
+    char prefix[48];
+    int prefix_len = snprintf(prefix, sizeof(prefix), "{\"callId\":%d,\"request\":", id);
+    size_t request_len = (size_t)prefix_len + payload_len + 1;
+    char* request = malloc(request_len);
+    if (!request) {
+        JS_FreeCString(ctx, payload);
+        return JS_ThrowOutOfMemory(ctx);
     }
+    memcpy(request, prefix, (size_t)prefix_len);
+    memcpy(request + prefix_len, payload, payload_len);
+    request[request_len - 1] = '}';
+    JS_FreeCString(ctx, payload);
 
-    JSValue logFn = JS_NewCFunction(ctx, js_console_log, "log", 1);
-    if (JS_IsException(logFn)) {
-        JS_FreeValue(ctx, console);
-        JS_FreeValue(ctx, global);
-        set_error("Failed to create console.log function");
-        return -1;
+    JSValue resolving[2];
+    JSValue promise = JS_NewPromiseCapability(ctx, resolving);
+    if (JS_IsException(promise)) {
+        free(request);
+        return promise;
     }
-    JS_SetPropertyStr(ctx, console, "log", logFn);
-    JS_SetPropertyStr(ctx, global, "console", console);
+    JS_FreeValue(ctx, resolving[1]);
 
-    // -------- Install __host object with functions --------
-    JSValue hostObj = JS_NewObject(ctx);
-    if (JS_IsException(hostObj)) {
-        JS_FreeValue(ctx, global);
-        set_error("Failed to create __host object");
-        return -1;
+    flush_logs();
+    int response_len = host_call(request, (int)request_len, g_response_buf, g_response_cap);
+    free(request);
+
+    if (response_len < 0 || response_len > g_response_cap) {
+        JS_FreeValue(ctx, resolving[0]);
+        JS_FreeValue(ctx, promise);
+        if (response_len < 0) {
+            return JS_ThrowInternalError(ctx, "Host call failed with error code %d", response_len);
+        }
+        return JS_ThrowInternalError(ctx, "Host response too large (%d bytes)", response_len);
     }
-    
-    // Register bridge function for host communication
-    JSValue bridgeFn = JS_NewCFunction(ctx, js_bridge_call, "bridge", 1);
-    if (JS_IsException(bridgeFn)) {
-        JS_FreeValue(ctx, hostObj);
-        JS_FreeValue(ctx, global);
-        set_error("Failed to create bridge function");
-        return -1;
+
+    if (response_len == 0) {
+        // Running on the host; completed later through complete_host_call
+        g_pending_calls[g_pending_count].id = id;
+        g_pending_calls[g_pending_count].ctx = ctx;
+        g_pending_calls[g_pending_count].resolve = resolving[0];
+        g_pending_count++;
+        return promise;
     }
-    JS_SetPropertyStr(ctx, hostObj, "bridge", bridgeFn);
-    
-    // Attach __host to global
-    JS_SetPropertyStr(ctx, global, "__host", hostObj);
-    JS_FreeValue(ctx, global);
-    
-    return 0;
+
+    JSValue response = JS_NewStringLen(ctx, g_response_buf, response_len);
+    trim_response_buffer();
+    JSValue ret = JS_Call(ctx, resolving[0], JS_UNDEFINED, 1, &response);
+    JS_FreeValue(ctx, ret);
+    JS_FreeValue(ctx, response);
+    JS_FreeValue(ctx, resolving[0]);
+    return promise;
 }
 
-// ---------- Result Conversion ----------
+// ---------- Binary host calls ----------
 
-/**
- * @brief Convert a JavaScript value to a string representation
- *
- * For primitives (number, boolean, string, null, undefined): uses ToString
- * For objects and arrays: uses JSON.stringify
- *
- * @param ctx The QuickJS context
- * @param val The JavaScript value to convert
- * @param result_buf Output buffer for the result
- * @param result_buf_size Size of the output buffer
- * @return 0 on success, -1 on error
- */
-static int js_value_to_string(JSContext* ctx, JSValue val, char* result_buf, size_t result_buf_size) {
-    // Clear result buffer
-    result_buf[0] = '\0';
+// __host.bridgeBinary(target, args) skips JSON on both sides: arguments are encoded straight
+// from JSValues into a MessagePack subset and the response is decoded back into JSValues.
+// Both directions start with BINARY_CALL_MARKER (0xC1, a byte MessagePack never uses), which
+// is how the host tells binary requests from JSON ones.
+//
+//   request:  0xC1 [target: int method ID | str method name, args: array]
+//   response: 0xC1 [ok: bool, value: result | str error message]
+//
+// Types: nil, bool, int (up to 64 bits), float64, str, array, map with str keys. Values map
+// like JSON.stringify: undefined, functions and symbols become nil (and are left out of
+// objects), NaN and Infinity become nil, toJSON() is honoured.
+#define BINARY_CALL_MARKER 0xC1
+#define BINARY_MAX_DEPTH 64
+#define MAX_SAFE_INTEGER 9007199254740991.0
 
-    // Handle different value types
-    if (JS_IsUndefined(val)) {
-        snprintf(result_buf, result_buf_size, "undefined");
-        return 0;
-    }
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+    int malloc_owned;  // grown with realloc so it can outlive the runtime (result regions)
+} MsgBuffer;
 
-    if (JS_IsNull(val)) {
-        // Write the literal ourselves so QuickJS doesn't accidentally emit the
-        // bootstrap script text (this happened when we relied on snprintf).
-        if (result_buf_size >= NULL_LITERAL_SIZE) {
-            for (size_t i = 0; i < NULL_LITERAL_SIZE; i++) {
-                result_buf[i] = LITERAL_NULL[i];
-            }
-        } else if (result_buf_size > 0) {
-            size_t copy_len = result_buf_size - 1;
-            size_t i;
-            for (i = 0; i < copy_len && LITERAL_NULL[i] != '\0'; i++) {
-                result_buf[i] = LITERAL_NULL[i];
-            }
-            result_buf[i] = '\0';
-        }
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} MsgReader;
+
+/** @return 0, or -1 with an out-of-memory exception pending */
+static int msg_reserve(JSContext* ctx, MsgBuffer* buf, size_t extra) {
+    if (buf->len + extra <= buf->cap) {
         return 0;
     }
 
-    if (JS_IsBool(val)) {
-        int bval = JS_ToBool(ctx, val);
-        snprintf(result_buf, result_buf_size, "%s", bval ? "true" : "false");
-        return 0;
+    size_t cap = buf->cap ? buf->cap * 2 : 256;
+    while (cap < buf->len + extra) {
+        cap *= 2;
     }
 
-    if (JS_IsNumber(val) || JS_IsString(val)) {
-        // For numbers and strings, use direct ToString
-        const char* str = JS_ToCString(ctx, val);
-        if (!str) {
-            set_error("Failed to convert value to string");
-            return -1;
+    uint8_t* data = buf->malloc_owned ? realloc(buf->data, cap) : js_realloc(ctx, buf->data, cap);
+    if (!data) {
+        if (buf->malloc_owned) {
+            JS_ThrowOutOfMemory(ctx);
         }
-        snprintf(result_buf, result_buf_size, "%s", str);
-        JS_FreeCString(ctx, str);
-        return 0;
+        return -1;
     }
+    buf->data = data;
+    buf->cap = cap;
+    return 0;
+}
 
-    // For objects and arrays, use JSON.stringify
-    if (JS_IsObject(val)) {
-        // Get JSON global object
-        JSValue global = JS_GetGlobalObject(ctx);
-        JSValue json_obj = JS_GetPropertyStr(ctx, global, "JSON");
-        JSValue stringify_fn = JS_GetPropertyStr(ctx, json_obj, "stringify");
+static int msg_put_byte(JSContext* ctx, MsgBuffer* buf, uint8_t byte) {
+    if (msg_reserve(ctx, buf, 1) != 0) {
+        return -1;
+    }
+    buf->data[buf->len++] = byte;
+    return 0;
+}
 
-        // Call JSON.stringify(val)
-        JSValue args[1] = { val };
-        JSValue json_result = JS_Call(ctx, stringify_fn, json_obj, 1, args);
+/** Writes tag followed by the low `size` bytes of value, big-endian */
+static int msg_put_tagged(JSContext* ctx, MsgBuffer* buf, uint8_t tag, uint64_t value, int size) {
+    if (msg_reserve(ctx, buf, 1 + (size_t)size) != 0) {
+        return -1;
+    }
+    buf->data[buf->len++] = tag;
+    for (int shift = (size - 1) * 8; shift >= 0; shift -= 8) {
+        buf->data[buf->len++] = (uint8_t)(value >> shift);
+    }
+    return 0;
+}
 
-        if (JS_IsException(json_result)) {
-            // JSON.stringify failed - try toString as fallback
-            JS_FreeValue(ctx, json_result);
-            JS_FreeValue(ctx, stringify_fn);
-            JS_FreeValue(ctx, json_obj);
-            JS_FreeValue(ctx, global);
-
-            const char* str = JS_ToCString(ctx, val);
-            if (!str) {
-                set_error("Failed to convert object to string");
-                return -1;
-            }
-            snprintf(result_buf, result_buf_size, "%s", str);
+static int msg_put_int(JSContext* ctx, MsgBuffer* buf, int64_t value) {
+    if (value >= 0 && value <= 0x7f) {
+        return msg_put_byte(ctx, buf, (uint8_t)value);
+    }
+    if (value < 0 && value >= -32) {
+        return msg_put_byte(ctx, buf, (uint8_t)(0xe0 | (value & 0x1f)));
+    }
+    if (value >= INT32_MIN && value <= INT32_MAX) {
+        return msg_put_tagged(ctx, buf, 0xd2, (uint64_t)value, 4);
+    }
+    return msg_put_tagged(ctx, buf, 0xd3, (uint64_t)value, 8);
+}
+
+static int msg_put_double(JSContext* ctx, MsgBuffer* buf, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return msg_put_tagged(ctx, buf, 0xcb, bits, 8);
+}
+
+static int msg_put_str(JSContext* ctx, MsgBuffer* buf, const char* str, size_t len) {
+    int rc;
+    if (len < 32) {
+        rc = msg_put_byte(ctx, buf, (uint8_t)(0xa0 | len));
+    } else if (len <= 0xff) {
+        rc = msg_put_tagged(ctx, buf, 0xd9, len, 1);
+    } else if (len <= 0xffff) {
+        rc = msg_put_tagged(ctx, buf, 0xda, len, 2);
+    } else {
+        rc = msg_put_tagged(ctx, buf, 0xdb, len, 4);
+    }
+    if (rc != 0 || msg_reserve(ctx, buf, len) != 0) {
+        return -1;
+    }
+    memcpy(buf->data + buf->len, str, len);
+    buf->len += len;
+    return 0;
+}
+
+static int msg_put_array_header(JSContext* ctx, MsgBuffer* buf, uint32_t count) {
+    if (count < 16) {
+        return msg_put_byte(ctx, buf, (uint8_t)(0x90 | count));
+    }
+    if (count <= 0xffff) {
+        return msg_put_tagged(ctx, buf, 0xdc, count, 2);
+    }
+    return msg_put_tagged(ctx, buf, 0xdd, count, 4);
+}
+
+static int msg_skipped_in_object(JSContext* ctx, JSValueConst val) {
+    return JS_IsUndefined(val) || JS_IsSymbol(val) || JS_IsFunction(ctx, val);
+}
+
+static int msg_encode(JSContext* ctx, MsgBuffer* buf, JSValueConst val, int depth);
+
+static int msg_encode_array(JSContext* ctx, MsgBuffer* buf, JSValueConst arr, int depth) {
+    JSValue length_val = JS_GetPropertyStr(ctx, arr, "length");
+    int32_t length;
+    int rc = JS_ToInt32(ctx, &length, length_val);
+    JS_FreeValue(ctx, length_val);
+    if (rc != 0) {
+        return -1;
+    }
+    if (length < 0) {
+        JS_ThrowRangeError(ctx, "Array too large to pass to the host");
+        return -1;
+    }
+
+    if (msg_put_array_header(ctx, buf, (uint32_t)length) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < (uint32_t)length; i++) {
+        JSValue item = JS_GetPropertyUint32(ctx, arr, i);
+        if (JS_IsException(item)) {
+            return -1;
+        }
+        rc = msg_encode(ctx, buf, item, depth + 1);
+        JS_FreeValue(ctx, item);
+        if (rc != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int msg_encode_object(JSContext* ctx, MsgBuffer* buf, JSValueConst obj, int depth) {
+    JSPropertyEnum* props;
+    uint32_t prop_count;
+    if (JS_GetOwnPropertyNames(ctx, &props, &prop_count, obj, JS_GPN_STRING_MASK | JS_GPN_ENUM_ONLY) != 0) {
+        return -1;
+    }
+
+    // map32 header; the entry count is patched in once skipped values are known
+    size_t header = buf->len;
+    int rc = msg_put_tagged(ctx, buf, 0xdf, 0, 4);
+    uint32_t written = 0;
+    for (uint32_t i = 0; rc == 0 && i < prop_count; i++) {
+        JSValue value = JS_GetProperty(ctx, obj, props[i].atom);
+        if (JS_IsException(value)) {
+            rc = -1;
+            break;
+        }
+        if (!msg_skipped_in_object(ctx, value)) {
+            size_t key_len;
+            JSValue key_val = JS_AtomToString(ctx, props[i].atom);
+            const char* key = JS_ToCStringLen(ctx, &key_len, key_val);
+            JS_FreeValue(ctx, key_val);
+            rc = key ? msg_put_str(ctx, buf, key, key_len) : -1;
+            JS_FreeCString(ctx, key);
+            if (rc == 0) {
+                rc = msg_encode(ctx, buf, value, depth + 1);
+                written++;
+            }
+        }
+        JS_FreeValue(ctx, value);
+    }
+    JS_FreePropertyEnum(ctx, props, prop_count);
+
+    if (rc == 0) {
+        for (int b = 0; b < 4; b++) {
+            buf->data[header + 1 + b] = (uint8_t)(written >> (24 - 8 * b));
+        }
+    }
+    return rc;
+}
+
+/** @return 0, or -1 with an exception pending */
+static int msg_encode(JSContext* ctx, MsgBuffer* buf, JSValueConst val, int depth) {
+    if (depth > BINARY_MAX_DEPTH) {
+        JS_ThrowRangeError(ctx, "Host call value nested too deeply");
+        return -1;
+    }
+
+    if (JS_IsNull(val) || msg_skipped_in_object(ctx, val)) {
+        return msg_put_byte(ctx, buf, 0xc0);
+    }
+    if (JS_IsBool(val)) {
+        return msg_put_byte(ctx, buf, JS_ToBool(ctx, val) ? 0xc3 : 0xc2);
+    }
+    if (JS_IsNumber(val)) {
+        double d;
+        if (JS_ToFloat64(ctx, &d, val) != 0) {
+            return -1;
+        }
+        if (!isfinite(d)) {
+            return msg_put_byte(ctx, buf, 0xc0);
+        }
+        if (d == floor(d) && fabs(d) <= MAX_SAFE_INTEGER) {
+            return msg_put_int(ctx, buf, (int64_t)d);
+        }
+        return msg_put_double(ctx, buf, d);
+    }
+    if (JS_IsString(val)) {
+        size_t len;
+        const char* str = JS_ToCStringLen(ctx, &len, val);
+        if (!str) {
+            return -1;
+        }
+        int rc = msg_put_str(ctx, buf, str, len);
+        JS_FreeCString(ctx, str);
+        return rc;
+    }
+    if (!JS_IsObject(val)) {
+        JS_ThrowTypeError(ctx, "Value cannot be passed to the host");
+        return -1;
+    }
+
+    JSValue to_json = JS_GetPropertyStr(ctx, val, "toJSON");
+    if (JS_IsException(to_json)) {
+        return -1;
+    }
+    if (JS_IsFunction(ctx, to_json)) {
+        JSValue converted = JS_Call(ctx, to_json, val, 0, NULL);
+        JS_FreeValue(ctx, to_json);
+        if (JS_IsException(converted)) {
+            return -1;
+        }
+        int rc = msg_encode(ctx, buf, converted, depth + 1);
+        JS_FreeValue(ctx, converted);
+        return rc;
+    }
+    JS_FreeValue(ctx, to_json);
+
+    int is_array = JS_IsArray(ctx, val);
+    if (is_array < 0) {
+        return -1;
+    }
+    return is_array
+        ? msg_encode_array(ctx, buf, val, depth)
+        : msg_encode_object(ctx, buf, val, depth);
+}
+
+static int msg_read_uint(MsgReader* r, int size, uint64_t* out) {
+    if (r->end - r->p < size) {
+        return -1;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value = (value << 8) | *r->p++;
+    }
+    *out = value;
+    return 0;
+}
+
+static JSValue msg_throw_malformed(JSContext* ctx) {
+    return JS_ThrowInternalError(ctx, "Malformed binary host response");
+}
+
+static JSValue msg_decode(JSContext* ctx, MsgReader* r, int depth);
+
+static JSValue msg_decode_array(JSContext* ctx, MsgReader* r, uint64_t count, int depth) {
+    // Every element takes at least one byte
+    if (count > (uint64_t)(r->end - r->p)) {
+        return msg_throw_malformed(ctx);
+    }
+
+    JSValue arr = JS_NewArray(ctx);
+    if (JS_IsException(arr)) {
+        return arr;
+    }
+    for (uint32_t i = 0; i < (uint32_t)count; i++) {
+        JSValue item = msg_decode(ctx, r, depth + 1);
+        if (JS_IsException(item) || JS_SetPropertyUint32(ctx, arr, i, item) < 0) {
+            JS_FreeValue(ctx, arr);
+            return JS_EXCEPTION;
+        }
+    }
+    return arr;
+}
+
+static JSValue msg_decode_map(JSContext* ctx, MsgReader* r, uint64_t count, int depth) {
+    // Every entry takes at least two bytes
+    if (count > (uint64_t)(r->end - r->p) / 2) {
+        return msg_throw_malformed(ctx);
+    }
+
+    JSValue obj = JS_NewObject(ctx);
+    if (JS_IsException(obj)) {
+        return obj;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t key_len;
+        uint8_t tag = r->p < r->end ? *r->p++ : 0;
+        int rc = 0;
+        if (tag >= 0xa0 && tag <= 0xbf) {
+            key_len = tag & 0x1f;
+        } else if (tag == 0xd9 || tag == 0xda || tag == 0xdb) {
+            rc = msg_read_uint(r, 1 << (tag - 0xd9), &key_len);
+        } else {
+            rc = -1;
+        }
+        if (rc != 0 || key_len > (uint64_t)(r->end - r->p)) {
+            JS_FreeValue(ctx, obj);
+            return msg_throw_malformed(ctx);
+        }
+
+        JSAtom key = JS_NewAtomLen(ctx, (const char*)r->p, (size_t)key_len);
+        r->p += key_len;
+        if (key == JS_ATOM_NULL) {
+            JS_FreeValue(ctx, obj);
+            return JS_EXCEPTION;
+        }
+
+        JSValue value = msg_decode(ctx, r, depth + 1);
+        rc = JS_IsException(value) ? -1 : JS_DefinePropertyValue(ctx, obj, key, value, JS_PROP_C_W_E);
+        JS_FreeAtom(ctx, key);
+        if (rc < 0) {
+            JS_FreeValue(ctx, obj);
+            return JS_EXCEPTION;
+        }
+    }
+    return obj;
+}
+
+static JSValue msg_decode(JSContext* ctx, MsgReader* r, int depth) {
+    if (depth > BINARY_MAX_DEPTH) {
+        return JS_ThrowRangeError(ctx, "Host response nested too deeply");
+    }
+    if (r->p >= r->end) {
+        return msg_throw_malformed(ctx);
+    }
+
+    uint8_t tag = *r->p++;
+    uint64_t n;
+    if (tag <= 0x7f) {
+        return JS_NewInt32(ctx, tag);
+    }
+    if (tag >= 0xe0) {
+        return JS_NewInt32(ctx, (int8_t)tag);
+    }
+    if (tag >= 0xa0 && tag <= 0xbf) {
+        n = tag & 0x1f;
+        goto string;
+    }
+    if (tag >= 0x90 && tag <= 0x9f) {
+        return msg_decode_array(ctx, r, tag & 0x0f, depth);
+    }
+    if (tag >= 0x80 && tag <= 0x8f) {
+        return msg_decode_map(ctx, r, tag & 0x0f, depth);
+    }
+
+    switch (tag) {
+    case 0xc0: return JS_NULL;
+    case 0xc2: return JS_FALSE;
+    case 0xc3: return JS_TRUE;
+    case 0xcc: case 0xcd: case 0xce: case 0xcf:
+        if (msg_read_uint(r, 1 << (tag - 0xcc), &n) != 0) {
+            break;
+        }
+        return n <= INT32_MAX ? JS_NewInt32(ctx, (int32_t)n) : JS_NewFloat64(ctx, (double)n);
+    case 0xd0: case 0xd1: case 0xd2: case 0xd3: {
+        int size = 1 << (tag - 0xd0);
+        if (msg_read_uint(r, size, &n) != 0) {
+            break;
+        }
+        // Sign-extend from `size` bytes
+        int64_t value = size == 8 ? (int64_t)n : (int64_t)(n << (64 - size * 8)) >> (64 - size * 8);
+        return JS_NewInt64(ctx, value);
+    }
+    case 0xcb: {
+        double d;
+        if (msg_read_uint(r, 8, &n) != 0) {
+            break;
+        }
+        memcpy(&d, &n, sizeof(d));
+        return JS_NewFloat64(ctx, d);
+    }
+    case 0xd9: case 0xda: case 0xdb:
+        if (msg_read_uint(r, 1 << (tag - 0xd9), &n) != 0) {
+            break;
+        }
+        goto string;
+    case 0xdc: case 0xdd:
+        if (msg_read_uint(r, tag == 0xdc ? 2 : 4, &n) != 0) {
+            break;
+        }
+        return msg_decode_array(ctx, r, n, depth);
+    case 0xde: case 0xdf:
+        if (msg_read_uint(r, tag == 0xde ? 2 : 4, &n) != 0) {
+            break;
+        }
+        return msg_decode_map(ctx, r, n, depth);
+    default:
+        break;
+    }
+    return msg_throw_malformed(ctx);
+
+string:
+    if (n > (uint64_t)(r->end - r->p)) {
+        return msg_throw_malformed(ctx);
+    }
+    {
+        JSValue str = JS_NewStringLen(ctx, (const char*)r->p, (size_t)n);
+        r->p += n;
+        return str;
+    }
+}
+
+/** Decodes [ok, value] from the response buffer; a failed call is rethrown as an Error */
+static JSValue decode_binary_response(JSContext* ctx, const uint8_t* data, int len) {
+    MsgReader r = { data, data + len };
+    if (len < 3 || *r.p++ != BINARY_CALL_MARKER || *r.p++ != 0x92) {
+        return msg_throw_malformed(ctx);
+    }
+
+    uint8_t ok = *r.p++;
+    if (ok != 0xc2 && ok != 0xc3) {
+        return msg_throw_malformed(ctx);
+    }
+
+    JSValue value = msg_decode(ctx, &r, 0);
+    if (JS_IsException(value) || ok == 0xc3) {
+        return value;
+    }
+
+    JSValue error = JS_NewError(ctx);
+    if (JS_IsException(error)) {
+        JS_FreeValue(ctx, value);
+        return error;
+    }
+    JS_DefinePropertyValueStr(ctx, error, "message", value, JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+    return JS_Throw(ctx, error);
+}
+
+// JS signature: __host.bridgeBinary(target: number | string, args?: ArrayLike<unknown>): unknown
+// target is a method ID from __scriptbox.registerMethodIds or a registered method name.
+// Returns the handler's result; a failed call throws an Error with the host's message.
+static JSValue js_bridge_binary(JSContext *ctx, JSValueConst this_val,
+                                int argc, JSValueConst *argv)
+{
+    if (argc < 1 || !(JS_IsNumber(argv[0]) || JS_IsString(argv[0]))) {
+        return JS_ThrowTypeError(ctx, "bridgeBinary requires a method ID or name");
+    }
+
+    MsgBuffer buf = { NULL, 0, 0, 0 };
+    int rc = msg_put_byte(ctx, &buf, BINARY_CALL_MARKER);
+    if (rc == 0) {
+        rc = msg_put_array_header(ctx, &buf, 2);
+    }
+    if (rc == 0) {
+        rc = msg_encode(ctx, &buf, argv[0], 0);
+    }
+    if (rc == 0) {
+        if (argc < 2 || JS_IsUndefined(argv[1])) {
+            rc = msg_put_array_header(ctx, &buf, 0);
+        } else if (JS_IsObject(argv[1]) && !JS_IsFunction(ctx, argv[1])) {
+            // Arrays and array-likes such as a function's arguments object
+            rc = msg_encode_array(ctx, &buf, argv[1], 0);
+        } else {
+            JS_ThrowTypeError(ctx, "bridgeBinary arguments must be an array");
+            rc = -1;
+        }
+    }
+    if (rc != 0) {
+        js_free(ctx, buf.data);
+        return JS_EXCEPTION;
+    }
+
+    // The host may replace g_response_buf through grow_response_buffer during the call
+    flush_logs();
+    int response_len = host_call((const char*)buf.data, (int)buf.len, g_response_buf, g_response_cap);
+    js_free(ctx, buf.data);
+
+    if (response_len < 0) {
+        return JS_ThrowInternalError(ctx, "Host call failed with error code %d", response_len);
+    }
+    if (response_len > g_response_cap) {
+        return JS_ThrowInternalError(ctx, "Host response too large (%d bytes)", response_len);
+    }
+
+    JSValue result = decode_binary_response(ctx, (const uint8_t*)g_response_buf, response_len);
+    trim_response_buffer();
+    return result;
+}
+
+// ---------- JSON host calls ----------
+
+/** Appends len bytes; 0, or -1 with an exception pending */
+static int msg_put_bytes(JSContext* ctx, MsgBuffer* buf, const char* data, size_t len) {
+    if (msg_reserve(ctx, buf, len) != 0) {
+        return -1;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return 0;
+}
+
+/** Appends JSON.stringify(val), or "null" when val has no JSON form */
+static int msg_put_json(JSContext* ctx, MsgBuffer* buf, JSValueConst val) {
+    JSValue json = JS_JSONStringify(ctx, val, JS_UNDEFINED, JS_UNDEFINED);
+    if (JS_IsException(json)) {
+        return -1;
+    }
+    if (!JS_IsString(json)) {
+        JS_FreeValue(ctx, json);
+        return msg_put_bytes(ctx, buf, LITERAL_NULL, sizeof(LITERAL_NULL) - 1);
+    }
+
+    size_t len;
+    const char* text = JS_ToCStringLen(ctx, &len, json);
+    JS_FreeValue(ctx, json);
+    if (!text) {
+        return -1;
+    }
+    int rc = msg_put_bytes(ctx, buf, text, len);
+    JS_FreeCString(ctx, text);
+    return rc;
+}
+
+/** Appends the JSON array of an array or array-like (a function's arguments object) */
+static int msg_put_json_args(JSContext* ctx, MsgBuffer* buf, JSValueConst args) {
+    if (JS_IsUndefined(args) || JS_IsNull(args)) {
+        return msg_put_bytes(ctx, buf, "[]", 2);
+    }
+    if (JS_IsArray(ctx, args) == 1) {
+        return msg_put_json(ctx, buf, args);
+    }
+    if (!JS_IsObject(args) || JS_IsFunction(ctx, args)) {
+        JS_ThrowTypeError(ctx, "host call arguments must be an array");
+        return -1;
+    }
+
+    JSValue length_val = JS_GetPropertyStr(ctx, args, "length");
+    uint32_t length;
+    int rc = JS_ToUint32(ctx, &length, length_val);
+    JS_FreeValue(ctx, length_val);
+    if (rc != 0) {
+        return -1;
+    }
+
+    JSValue arr = JS_NewArray(ctx);
+    if (JS_IsException(arr)) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        JSValue item = JS_GetPropertyUint32(ctx, args, i);
+        if (JS_IsException(item) || JS_SetPropertyUint32(ctx, arr, i, item) < 0) {
+            JS_FreeValue(ctx, arr);
+            return -1;
+        }
+    }
+    rc = msg_put_json(ctx, buf, arr);
+    JS_FreeValue(ctx, arr);
+    return rc;
+}
+
+/** Decodes a {"result":...} or {"error":...} envelope; errors are thrown as an Error */
+static JSValue decode_json_response(JSContext* ctx, const char* text, int len) {
+    JSValue parsed = JS_ParseJSON(ctx, text, (size_t)len, "<host>");
+    if (JS_IsException(parsed) || !JS_IsObject(parsed)) {
+        if (JS_IsException(parsed)) {
+            return parsed;
+        }
+        JS_FreeValue(ctx, parsed);
+        return JS_NULL;
+    }
+
+    JSValue error = JS_GetPropertyStr(ctx, parsed, "error");
+    if (JS_IsException(error)) {
+        JS_FreeValue(ctx, parsed);
+        return error;
+    }
+    if (JS_ToBool(ctx, error)) {
+        JS_FreeValue(ctx, parsed);
+        JSValue message = JS_ToString(ctx, error);
+        JS_FreeValue(ctx, error);
+        if (JS_IsException(message)) {
+            return message;
+        }
+        JSValue exception = JS_NewError(ctx);
+        if (JS_IsException(exception)) {
+            JS_FreeValue(ctx, message);
+            return exception;
+        }
+        JS_DefinePropertyValueStr(ctx, exception, "message", message, JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+        return JS_Throw(ctx, exception);
+    }
+    JS_FreeValue(ctx, error);
+
+    JSValue result = JS_GetPropertyStr(ctx, parsed, "result");
+    JS_FreeValue(ctx, parsed);
+    return result;
+}
+
+// JS signature: __host.invoke(target: number | string, args?: ArrayLike<unknown>): unknown
+// The JSON counterpart of bridgeBinary, used by __scriptbox.hostCall and the proxies of
+// createMethod: builds {"id":N,"args":[...]} or {"method":"...","args":[...]}, makes the
+// host call and unwraps the response envelope, without a round of JSON plumbing in JS.
+static JSValue js_host_invoke(JSContext *ctx, JSValueConst this_val,
+                              int argc, JSValueConst *argv)
+{
+    if (argc < 1 || !(JS_IsNumber(argv[0]) || JS_IsString(argv[0]))) {
+        return JS_ThrowTypeError(ctx, "invoke requires a method ID or name");
+    }
+
+    MsgBuffer buf = { NULL, 0, 0, 0 };
+    int rc;
+    if (JS_IsNumber(argv[0])) {
+        int32_t id;
+        rc = JS_ToInt32(ctx, &id, argv[0]);
+        if (rc == 0) {
+            char prefix[32];
+            int prefix_len = snprintf(prefix, sizeof(prefix), "{\"id\":%d", (int)id);
+            rc = msg_put_bytes(ctx, &buf, prefix, (size_t)prefix_len);
+        }
+    } else {
+        rc = msg_put_bytes(ctx, &buf, "{\"method\":", 10);
+        if (rc == 0) {
+            rc = msg_put_json(ctx, &buf, argv[0]);
+        }
+    }
+    if (rc == 0) {
+        rc = msg_put_bytes(ctx, &buf, ",\"args\":", 8);
+    }
+    if (rc == 0) {
+        rc = msg_put_json_args(ctx, &buf, argc < 2 ? JS_UNDEFINED : argv[1]);
+    }
+    if (rc == 0) {
+        rc = msg_put_byte(ctx, &buf, '}');
+    }
+    if (rc != 0) {
+        js_free(ctx, buf.data);
+        return JS_EXCEPTION;
+    }
+
+    // The host may replace g_response_buf through grow_response_buffer during the call
+    flush_logs();
+    int response_len = host_call((const char*)buf.data, (int)buf.len, g_response_buf, g_response_cap);
+    js_free(ctx, buf.data);
+
+    if (response_len < 0) {
+        return JS_ThrowInternalError(ctx, "Host call failed with error code %d", response_len);
+    }
+    if (response_len > g_response_cap) {
+        return JS_ThrowInternalError(ctx, "Host response too large (%d bytes)", response_len);
+    }
+    if (response_len == 0) {
+        const char* name = JS_ToCString(ctx, argv[0]);
+        JSValue error = JS_ThrowInternalError(ctx, "Host returned null response for method %s", name ? name : "?");
+        JS_FreeCString(ctx, name);
+        return error;
+    }
+
+    JSValue result;
+    if (response_len < g_response_cap) {
+        // JS_ParseJSON needs a NUL after the text
+        g_response_buf[response_len] = '\0';
+        result = decode_json_response(ctx, g_response_buf, response_len);
+    } else {
+        char* copy = js_malloc(ctx, (size_t)response_len + 1);
+        if (!copy) {
+            trim_response_buffer();
+            return JS_EXCEPTION;
+        }
+        memcpy(copy, g_response_buf, (size_t)response_len);
+        copy[response_len] = '\0';
+        result = decode_json_response(ctx, copy, response_len);
+        js_free(ctx, copy);
+    }
+    trim_response_buffer();
+    return result;
+}
+
+// Note: Host bridge is installed per-evaluation in eval_js()
+
+// ---------- Error reporting ----------
+
+/**
+ * @brief Allocate the input buffer for the next script or bytecode
+ *
+ * The buffer holds len bytes plus a terminating NUL (already written), so
+ * source evaluated from it is parsed in place without another copy. The
+ * previous allocation is reused when it is large enough.
+ *
+ * @param len Number of bytes the host will write
+ * @return Pointer to the buffer, or NULL if len is negative or allocation failed
+ */
+__attribute__((export_name("alloc_input")))
+char* alloc_input(int len) {
+    if (len < 0 || len == INT_MAX) {
+        return NULL;
+    }
+
+    if (g_input == NULL || g_input_cap < len + 1) {
+        free(g_input);
+        g_input = malloc((size_t)len + 1);
+        g_input_cap = g_input != NULL ? len + 1 : 0;
+        if (g_input == NULL) {
+            return NULL;
+        }
+    }
+
+    g_input[len] = '\0';
+    return g_input;
+}
+
+/**
+ * @brief Release the buffer returned by alloc_input
+ *
+ * Called by the host once the evaluation that consumed the input returned.
+ * Safe to call when nothing is allocated.
+ */
+__attribute__((export_name("free_input")))
+void free_input(void) {
+    free(g_input);
+    g_input = NULL;
+    g_input_cap = 0;
+}
+
+/**
+ * @brief Check whether code_ptr[0..len] lies in the alloc_input buffer and is NUL-terminated
+ */
+static int is_terminated_input(const char* code_ptr, int len) {
+    return g_input != NULL
+        && code_ptr >= g_input
+        && len >= 0
+        && len < g_input_cap - (code_ptr - g_input)
+        && code_ptr[len] == '\0';
+}
+
+/**
+ * @brief Get pointer to script buffer (legacy hosts; see alloc_input)
+ * @return Pointer to the script buffer, or NULL if it could not be allocated
+ */
+__attribute__((export_name("get_script_buffer_ptr")))
+char* get_script_buffer_ptr(void) {
+    if (g_script_buffer == NULL) {
+        g_script_buffer = malloc(SCRIPT_BUFFER_SIZE);
+    }
+    return g_script_buffer;
+}
+
+/**
+ * @brief Get length of script buffer (legacy hosts; see alloc_input)
+ * @return Length in bytes, 0 if the buffer could not be allocated
+ */
+__attribute__((export_name("get_script_buffer_len")))
+int get_script_buffer_len(void) {
+    return get_script_buffer_ptr() != NULL ? SCRIPT_BUFFER_SIZE : 0;
+}
+
+/**
+ * @brief Get pointer to error message buffer
+ * @return Pointer to null-terminated error string (valid until next eval_js call)
+ * 
+ * The returned pointer points to WASM linear memory and is valid for the
+ * lifetime of the current WASM instance. Use get_last_error_len() to determine
+ * the length before copying.
+ */
+__attribute__((export_name("get_last_error_ptr")))
+const char* get_last_error_ptr(void) {
+    return g_last_error;
+}
+
+/**
+ * @brief Get length of error message
+ * @return Length in bytes (not including null terminator)
+ */
+__attribute__((export_name("get_last_error_len")))
+int get_last_error_len(void) {
+    return (int)strlen(g_last_error);
+}
+
+static uint32_t result_region_len(void) {
+    if (g_result_region == NULL) {
+        return 0;
+    }
+
+    return (uint32_t)g_result_region[0]
+         | ((uint32_t)g_result_region[1] << 8)
+         | ((uint32_t)g_result_region[2] << 16)
+         | ((uint32_t)g_result_region[3] << 24);
+}
+
+/**
+ * @brief Release the result region
+ */
+__attribute__((export_name("free_result")))
+void free_result(void) {
+    free(g_result_region);
+    g_result_region = NULL;
+}
+
+/**
+ * @brief Store a copy of str as the current result, replacing the previous one
+ * @return 0 on success, -1 if the region could not be allocated
+ */
+static void write_result_header(unsigned char* region, size_t len) {
+    region[0] = (unsigned char)(len & 0xff);
+    region[1] = (unsigned char)((len >> 8) & 0xff);
+    region[2] = (unsigned char)((len >> 16) & 0xff);
+    region[3] = (unsigned char)((len >> 24) & 0xff);
+}
+
+static int set_result(const char* str, size_t len) {
+    free_result();
+
+    if (len > UINT32_MAX - RESULT_HEADER_SIZE - 1) {
+        set_error("Result too large (%zu bytes)", len);
+        return -1;
+    }
+
+    g_result_region = malloc(RESULT_HEADER_SIZE + len + 1);
+    if (g_result_region == NULL) {
+        set_error("Failed to allocate result buffer (%zu bytes)", len);
+        return -1;
+    }
+
+    write_result_header(g_result_region, len);
+    memcpy(g_result_region + RESULT_HEADER_SIZE, str, len);
+    g_result_region[RESULT_HEADER_SIZE + len] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Store a value as MessagePack in the result region (EVAL_FLAG_BINARY_RESULT)
+ *
+ * Encodes straight into the region, so neither side builds a JSON string. Same
+ * value mapping as binary host calls: undefined, functions and symbols become nil
+ * (and are skipped as object members), toJSON is honoured, non-finite numbers are nil.
+ */
+static int set_binary_result(JSContext* ctx, JSValueConst val) {
+    free_result();
+
+    MsgBuffer buf = { NULL, 0, 0, 1 };
+    int rc = msg_reserve(ctx, &buf, RESULT_HEADER_SIZE);
+    if (rc == 0) {
+        buf.len = RESULT_HEADER_SIZE;
+        rc = msg_encode(ctx, &buf, val, 0);
+    }
+    if (rc == 0) {
+        rc = msg_put_byte(ctx, &buf, 0);  // NUL terminated like text results
+    }
+    if (rc != 0) {
+        free(buf.data);
+        JSValue exc = JS_GetException(ctx);
+        capture_exception(ctx, exc);
+        JS_FreeValue(ctx, exc);
+        return -1;
+    }
+
+    size_t len = buf.len - RESULT_HEADER_SIZE - 1;
+    if (len > UINT32_MAX - RESULT_HEADER_SIZE - 1) {
+        free(buf.data);
+        set_error("Result too large (%zu bytes)", len);
+        return -1;
+    }
+
+    write_result_header(buf.data, len);
+    g_result_region = buf.data;
+    return 0;
+}
+
+/**
+ * @brief Get the length-prefixed result region
+ * @return Pointer to [uint32 length][UTF-8 bytes][NUL], or NULL when there is no result
+ *
+ * The region stays valid until free_result() or the next evaluation.
+ */
+__attribute__((export_name("get_result_region")))
+const unsigned char* get_result_region(void) {
+    return g_result_region;
+}
+
+/**
+ * @brief Get pointer to result string
+ * @return Pointer to null-terminated result string (valid until next eval_js call)
+ *
+ * Kept for hosts that predate get_result_region(). Use get_result_len()
+ * for the length; results may contain NUL characters.
+ */
+__attribute__((export_name("get_result_ptr")))
+const char* get_result_ptr(void) {
+    return g_result_region == NULL ? "" : (const char*)(g_result_region + RESULT_HEADER_SIZE);
+}
+
+/**
+ * @brief Get length of result
+ * @return Length in bytes (not including null terminator)
+ */
+__attribute__((export_name("get_result_len")))
+int get_result_len(void) {
+    return (int)result_region_len();
+}
+
+// ---------- Console logging ----------
+
+/**
+ * @brief Text of one console argument: strings as they are, objects as JSON when
+ *        they can be serialized, errors and everything else through ToString
+ * @return A string to free with JS_FreeCString, or NULL with an exception pending
+ */
+static const char* console_arg_text(JSContext* ctx, JSValueConst arg, size_t* len) {
+    if (JS_IsObject(arg) && !JS_IsFunction(ctx, arg) && !JS_IsError(ctx, arg)) {
+        JSValue json = JS_JSONStringify(ctx, arg, JS_UNDEFINED, JS_UNDEFINED);
+        if (JS_IsString(json)) {
+            const char* text = JS_ToCStringLen(ctx, len, json);
+            JS_FreeValue(ctx, json);
+            return text;
+        }
+        if (JS_IsException(json)) {
+            // Cycles, BigInts: fall back to ToString like console.log did before
+            JS_FreeValue(ctx, JS_GetException(ctx));
+        }
+        JS_FreeValue(ctx, json);
+    }
+    return JS_ToCStringLen(ctx, len, arg);
+}
+
+// console.log(a, b, ...): one entry, the arguments joined by spaces
+static JSValue js_console_log(JSContext *ctx, JSValueConst this_val,
+                              int argc, JSValueConst *argv)
+{
+    if (argc <= 1) {
+        size_t len = 0;
+        const char* str = argc == 0 ? "" : console_arg_text(ctx, argv[0], &len);
+        if (!str)
+            return JS_EXCEPTION;
+
+        append_log(str, len);
+        if (argc != 0)
             JS_FreeCString(ctx, str);
-            return 0;
+        return JS_UNDEFINED;
+    }
+
+    MsgBuffer line = { NULL, 0, 0, 0 };
+    for (int i = 0; i < argc; i++) {
+        size_t len = 0;
+        const char* str = console_arg_text(ctx, argv[i], &len);
+        if (!str || msg_reserve(ctx, &line, len + 1) != 0) {
+            if (str)
+                JS_FreeCString(ctx, str);
+            js_free(ctx, line.data);
+            return JS_EXCEPTION;
+        }
+
+        if (i > 0)
+            line.data[line.len++] = ' ';
+        memcpy(line.data + line.len, str, len);
+        line.len += len;
+        JS_FreeCString(ctx, str);
+    }
+
+    append_log((const char*)line.data, line.len);
+    js_free(ctx, line.data);
+    return JS_UNDEFINED;
+}
+
+// ---------- Host bridge installation ----------
+
+// Install host bridge (console.log, __host.bridge) into the JS context.
+// This provides the minimal, stable bridge primitives.
+// Higher-level APIs (scriptbox, etc.) are injected as JS by the host.
+static int install_host_bridge(JSContext* ctx) {
+    JSValue global = JS_GetGlobalObject(ctx);
+    if (JS_IsUndefined(global) || JS_IsNull(global)) {
+        JS_FreeValue(ctx, global);
+        set_error("Global object is null/undefined - context initialization failed");
+        return -1;
+    }
+
+    // -------- Install console.log --------
+    JSValue console = JS_NewObject(ctx);
+    if (JS_IsException(console)) {
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create console object");
+        return -1;
+    }
+
+    JSValue logFn = JS_NewCFunction(ctx, js_console_log, "log", 1);
+    if (JS_IsException(logFn)) {
+        JS_FreeValue(ctx, console);
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create console.log function");
+        return -1;
+    }
+    JS_SetPropertyStr(ctx, console, "log", logFn);
+    JS_SetPropertyStr(ctx, global, "console", console);
+
+    // -------- Install __host object with functions --------
+    JSValue hostObj = JS_NewObject(ctx);
+    if (JS_IsException(hostObj)) {
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create __host object");
+        return -1;
+    }
+    
+    // Register bridge function for host communication
+    JSValue bridgeFn = JS_NewCFunction(ctx, js_bridge_call, "bridge", 1);
+    if (JS_IsException(bridgeFn)) {
+        JS_FreeValue(ctx, hostObj);
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create bridge function");
+        return -1;
+    }
+    JS_SetPropertyStr(ctx, hostObj, "bridge", bridgeFn);
+
+    JSValue bridgeAsyncFn = JS_NewCFunction(ctx, js_bridge_call_async, "bridgeAsync", 1);
+    if (JS_IsException(bridgeAsyncFn)) {
+        JS_FreeValue(ctx, hostObj);
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create bridgeAsync function");
+        return -1;
+    }
+    JS_SetPropertyStr(ctx, hostObj, "bridgeAsync", bridgeAsyncFn);
+
+    JSValue bridgeBinaryFn = JS_NewCFunction(ctx, js_bridge_binary, "bridgeBinary", 2);
+    if (JS_IsException(bridgeBinaryFn)) {
+        JS_FreeValue(ctx, hostObj);
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create bridgeBinary function");
+        return -1;
+    }
+    JS_SetPropertyStr(ctx, hostObj, "bridgeBinary", bridgeBinaryFn);
+
+    JSValue invokeFn = JS_NewCFunction(ctx, js_host_invoke, "invoke", 2);
+    if (JS_IsException(invokeFn)) {
+        JS_FreeValue(ctx, hostObj);
+        JS_FreeValue(ctx, global);
+        set_error("Failed to create invoke function");
+        return -1;
+    }
+    JS_SetPropertyStr(ctx, hostObj, "invoke", invokeFn);
+    
+    // Attach __host to global
+    JS_SetPropertyStr(ctx, global, "__host", hostObj);
+    JS_FreeValue(ctx, global);
+    
+    return 0;
+}
+
+// ---------- Result Conversion ----------
+
+/**
+ * @brief Store a QuickJS string conversion of val as the result
+ * @return 0 on success, -1 on error
+ */
+static int set_result_from_cstring(JSContext* ctx, JSValueConst val, const char* what) {
+    size_t len = 0;
+    const char* str = JS_ToCStringLen(ctx, &len, val);
+    if (!str) {
+        set_error("Failed to convert %s to string", what);
+        return -1;
+    }
+
+    int status = set_result(str, len);
+    JS_FreeCString(ctx, str);
+    return status;
+}
+
+/**
+ * @brief Convert a JavaScript value to a string representation and store it as the result
+ *
+ * For primitives (number, boolean, string, null, undefined): uses ToString
+ * For objects and arrays: uses JSON.stringify
+ *
+ * Results are sized to fit; nothing is truncated.
+ *
+ * @param ctx The QuickJS context
+ * @param val The JavaScript value to convert
+ * @return 0 on success, -1 on error
+ */
+static int js_value_to_string(JSContext* ctx, JSValue val) {
+    // Handle different value types
+    if (JS_IsUndefined(val)) {
+        return set_result("undefined", 9);
+    }
+
+    if (JS_IsNull(val)) {
+        // Write the literal ourselves so QuickJS doesn't accidentally emit the
+        // bootstrap script text (this happened when we relied on snprintf).
+        return set_result(LITERAL_NULL, sizeof(LITERAL_NULL) - 1);
+    }
+
+    if (JS_IsBool(val)) {
+        return JS_ToBool(ctx, val) ? set_result("true", 4) : set_result("false", 5);
+    }
+
+    if (JS_IsNumber(val) || JS_IsString(val)) {
+        // For numbers and strings, use direct ToString
+        return set_result_from_cstring(ctx, val, "value");
+    }
+
+    // For objects and arrays, serialize natively: no global lookups or call through
+    // the interpreter, and scripts cannot change the result by replacing JSON.stringify
+    if (JS_IsObject(val)) {
+        JSValue json_result = JS_JSONStringify(ctx, val, JS_UNDEFINED, JS_UNDEFINED);
+
+        if (JS_IsException(json_result)) {
+            // JSON.stringify failed - try toString as fallback
+            JS_FreeValue(ctx, JS_GetException(ctx));
+            return set_result_from_cstring(ctx, val, "object");
+        }
+
+        int status = set_result_from_cstring(ctx, json_result, "JSON result");
+        JS_FreeValue(ctx, json_result);
+        return status;
+    }
+
+    // Fallback: try to convert to string
+    return set_result_from_cstring(ctx, val, "value");
+}
+
+// ---------- Pre-initialized snapshot ----------
+
+#ifdef SCRIPTBOX_SNAPSHOT
+/**
+ * @brief Evaluate the embedded core bootstrap in a context
+ * @return 0 on success, -1 on exception (details in g_last_error)
+ */
+static int run_embedded_bootstrap(JSContext* ctx) {
+    JSValue result = JS_Eval(ctx, SCRIPTBOX_BOOTSTRAP_SOURCE, SCRIPTBOX_BOOTSTRAP_SOURCE_LEN,
+                             "bootstrap", 0);
+    if (JS_IsException(result)) {
+        JSValue exc = JS_GetException(ctx);
+        capture_exception(ctx, exc);
+        JS_FreeValue(ctx, exc);
+        JS_FreeValue(ctx, result);
+        return -1;
+    }
+
+    JS_FreeValue(ctx, result);
+    return 0;
+}
+
+/**
+ * @brief Wizer entry point: build the runtime, bridge and core bootstrap once
+ *
+ * Runs at build time under Wizer; the resulting linear memory becomes the
+ * initial state of every instance. Host imports must not be called here.
+ * On failure the snapshot simply carries no context and eval_js falls back to
+ * creating a fresh runtime (the error stays in g_last_error for diagnostics).
+ */
+__attribute__((export_name("wizer.initialize")))
+void scriptbox_wizer_initialize(void) {
+    JSRuntime* rt = new_runtime();
+    if (!rt) {
+        set_error("Snapshot: Failed to create runtime");
+        return;
+    }
+
+    JSContext* ctx = JS_NewContext(rt);
+    if (!ctx) {
+        set_error("Snapshot: Failed to create context");
+        JS_FreeRuntime(rt);
+        return;
+    }
+
+    if (install_host_bridge(ctx) != 0) {
+        JS_FreeContext(ctx);
+        JS_FreeRuntime(rt);
+        return;
+    }
+
+    if (run_embedded_bootstrap(ctx) != 0) {
+        JS_FreeContext(ctx);
+        JS_FreeRuntime(rt);
+        return;
+    }
+
+    g_snapshot_rt = rt;
+    g_snapshot_ctx = ctx;
+    g_snapshot_consumed = 0;
+    g_snapshot_initialized = 1;
+    g_log_len = 0;  // nothing to deliver them to at build time
+    set_error("OK");
+}
+
+/**
+ * @brief Hand the pre-initialized context to the caller (once per instance)
+ * @return 1 if rt/ctx were filled from the snapshot, 0 otherwise
+ */
+static int take_snapshot_context(JSRuntime** rt, JSContext** ctx) {
+    // g_snapshot_rt is NULL once the shared runtime adopted the snapshot
+    if (g_snapshot_rt == NULL || g_snapshot_ctx == NULL || g_snapshot_consumed) {
+        return 0;
+    }
+
+    *rt = g_snapshot_rt;
+    *ctx = g_snapshot_ctx;
+    g_snapshot_consumed = 1;
+    return 1;
+}
+
+/**
+ * @brief Free a snapshot context left behind by a previous eval_js call
+ *
+ * Teardown is deferred so single-use instances (the common case) never pay
+ * for it; only an instance that evaluates a second script frees the state.
+ */
+static void release_consumed_snapshot(void) {
+    if (g_snapshot_rt != NULL && g_snapshot_ctx != NULL && g_snapshot_consumed) {
+        JS_FreeContext(g_snapshot_ctx);
+        JS_FreeRuntime(g_snapshot_rt);
+        g_snapshot_ctx = NULL;
+        g_snapshot_rt = NULL;
+    }
+}
+#endif
+
+/**
+ * @brief Report whether the module was pre-initialized by wizer.initialize
+ * @return 1 if every evaluation starts with the core bootstrap already loaded, 0 otherwise
+ *
+ * Always exported so the host can reject modules that were configured as
+ * snapshots but were built without --snapshot (or whose initializer failed).
+ */
+__attribute__((export_name("is_preinitialized")))
+int is_preinitialized(void) {
+#ifdef SCRIPTBOX_SNAPSHOT
+    return g_snapshot_initialized;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Free a runtime/context pair used by eval_js
+ * @param owned 0 for the snapshot context (teardown is deferred), 1 otherwise
+ */
+static void release_eval_context(JSRuntime* rt, JSContext* ctx, int owned) {
+    // eval_js never awaits; calls still running on the host resolve nothing
+    drop_pending_calls(ctx);
+
+    if (!owned) {
+        return;
+    }
+
+    JS_FreeContext(ctx);
+    JS_FreeRuntime(rt);
+}
+
+// ---------- JavaScript Evaluation ----------
+
+/**
+ * @brief Create a context with the host bridge installed
+ * @param rt Runtime that will own the context
+ * @param out_ctx Receives the new context on success
+ * @return 0 on success, otherwise an eval_js status code (21, 22 or 23)
+ */
+static int create_eval_context(JSRuntime* rt, JSContext** out_ctx) {
+    JSContext* ctx = JS_NewContext(rt);
+    if (!ctx) {
+        set_error("Failed to create JavaScript context");
+        return 21;
+    }
+
+    // Install console.log and __host_call_json
+    if (install_host_bridge(ctx) != 0) {
+        // install_host_bridge already set an error message
+        JS_FreeContext(ctx);
+        return 23;
+    }
+
+#ifdef SCRIPTBOX_SNAPSHOT
+    // The host omits the core bootstrap for snapshot modules, so contexts
+    // created after the snapshot one was used must load it themselves
+    if (run_embedded_bootstrap(ctx) != 0) {
+        JS_FreeContext(ctx);
+        return 22;
+    }
+#endif
+
+    *out_ctx = ctx;
+    return 0;
+}
+
+// Flags accepted by context_eval / context_eval_bytecode
+#define EVAL_FLAG_DISCARD_RESULT (1 << 0)  // skip result conversion (bootstrap segments)
+#define EVAL_FLAG_AWAIT_RESULT   (1 << 1)  // settle a returned promise before reporting
+                                           // (may return 30 while host calls are pending)
+#define EVAL_FLAG_BINARY_RESULT  (1 << 2)  // store the result as MessagePack, not text
+
+// Promise returned by an EVAL_FLAG_AWAIT_RESULT evaluation that is still settling
+static int g_await_active = 0;
+static JSContext* g_await_ctx = NULL;
+static JSValue g_await_promise;
+static int g_await_flags = 0;
+
+static int complete_eval(JSContext* ctx, JSValue result, int flags);
+
+static void clear_awaited_result(void) {
+    if (!g_await_active) {
+        return;
+    }
+
+    JS_FreeValue(g_await_ctx, g_await_promise);
+    g_await_active = 0;
+    g_await_ctx = NULL;
+}
+
+/**
+ * @brief Run queued promise jobs, then report the state of the awaited promise
+ * @return 0 once it fulfilled (result stored), 22 if it rejected or can never settle,
+ *         30 while it waits on host calls
+ */
+static int settle_awaited_result(void) {
+    JSContext* ctx = g_await_ctx;
+    JSRuntime* rt = JS_GetRuntime(ctx);
+
+    for (;;) {
+        JSContext* job_ctx = NULL;
+        int ret = JS_ExecutePendingJob(rt, &job_ctx);
+        if (ret == 0) {
+            break;
+        }
+        if (ret < 0) {
+            JSValue exc = JS_GetException(job_ctx);
+            capture_exception(job_ctx, exc);
+            JS_FreeValue(job_ctx, exc);
+            clear_awaited_result();
+            return 22;
+        }
+    }
+
+    switch (JS_PromiseState(ctx, g_await_promise)) {
+    case JS_PROMISE_FULFILLED: {
+        JSValue value = JS_PromiseResult(ctx, g_await_promise);
+        int flags = g_await_flags;
+        clear_awaited_result();
+        return complete_eval(ctx, value, flags);
+    }
+    case JS_PROMISE_REJECTED: {
+        JSValue reason = JS_PromiseResult(ctx, g_await_promise);
+        capture_exception(ctx, reason);
+        JS_FreeValue(ctx, reason);
+        clear_awaited_result();
+        return 22;
+    }
+    default:
+        if (!has_pending_calls(ctx)) {
+            clear_awaited_result();
+            set_error("Exception: script result is a promise that never settles");
+            return 22;
+        }
+        set_error("Pending");
+        return 30;
+    }
+}
+
+/**
+ * @brief Turn an evaluation result into a status code, capturing result or error
+ * @param result Evaluation result; always freed (or kept while awaiting)
+ * @return 0 on success, 22 on exception, 26 if the result could not be converted,
+ *         30 if an awaited promise is waiting on host calls
+ */
+static int complete_eval(JSContext* ctx, JSValue result, int flags) {
+    if (JS_IsException(result)) {
+        JSValue exc = JS_GetException(ctx);
+        capture_exception(ctx, exc);
+        JS_FreeValue(ctx, exc);
+        JS_FreeValue(ctx, result);
+        return 22;
+    }
+
+    // JS_PromiseState returns -1 for values that are not promises
+    if ((flags & EVAL_FLAG_AWAIT_RESULT) && (int)JS_PromiseState(ctx, result) >= 0) {
+        clear_awaited_result();
+        g_await_active = 1;
+        g_await_ctx = ctx;
+        g_await_promise = result;
+        g_await_flags = flags & ~EVAL_FLAG_AWAIT_RESULT;
+        return settle_awaited_result();
+    }
+
+    if (flags & EVAL_FLAG_DISCARD_RESULT) {
+        free_result();
+    } else if (flags & EVAL_FLAG_BINARY_RESULT) {
+        if (set_binary_result(ctx, result) != 0) {
+            JS_FreeValue(ctx, result);
+            return 26;
+        }
+    } else if (js_value_to_string(ctx, result) != 0) {
+        // Failed to convert result to string
+        JS_FreeValue(ctx, result);
+        return 26;  // New error code for result conversion failure
+    }
+
+    JS_FreeValue(ctx, result);
+    set_error("OK");
+    return 0;
+}
+
+/**
+ * @brief Evaluate code in an existing context and capture its result
+ * @param flags EVAL_FLAG_* bits
+ * @return 0 on success, otherwise an eval_js status code (22, 25 or 26)
+ */
+static int eval_in_context(JSRuntime* rt, JSContext* ctx, const char* code_ptr, int len, int flags) {
+    // JS_Eval requires input[len] == '\0'. alloc_input buffers already are; anything
+    // else (legacy script buffer) gets a null-terminated copy
+    char* code_copy = NULL;
+    const char* code = code_ptr;
+    if (!is_terminated_input(code_ptr, len)) {
+        code_copy = js_malloc_rt(rt, len + 1);
+        if (!code_copy) {
+            set_error("Failed to allocate code buffer (%d bytes)", len + 1);
+            return 25;
+        }
+        memcpy(code_copy, code_ptr, len);
+        code_copy[len] = '\0';
+        code = code_copy;
+    }
+
+    // Evaluate the code in the existing global scope (no flags = use current context's global)
+    // Note: JS_EVAL_TYPE_GLOBAL creates a NEW global scope, which would lose our bridge functions!
+    JSValue result = JS_Eval(ctx, code, len, "eval", 0);
+
+    int status = complete_eval(ctx, result, flags);
+    if (code_copy) {
+        js_free_rt(rt, code_copy);
+    }
+    return end_step(status);
+}
+
+/**
+ * @brief Evaluate JavaScript code in a fresh context
+ *
+ * Creates a new runtime and context for each invocation, evaluates the code,
+ * captures the return value, and cleans up resources. This ensures isolation
+ * between evaluations. Snapshot builds instead evaluate the first call of an
+ * instance in the pre-initialized context (see wizer.initialize).
+ *
+ * @param code_ptr Pointer to JavaScript source code (in WASM linear memory)
+ * @param len Number of bytes to read from code_ptr
+ *
+ * @return Status code:
+ *   0 = Success (result available via get_result_ptr/get_result_len)
+ *   20 = Failed to create runtime
+ *   21 = Failed to create context
+ *   22 = Evaluation resulted in exception (see get_last_error_ptr)
+ *   23 = Global object is null/undefined
+ *   24 = code_ptr is NULL
+ *   25 = Failed to allocate code buffer
+ *   26 = Failed to convert result to string
+ *
+ * On success, call get_result_ptr() and get_result_len() to retrieve the
+ * JavaScript return value as a string. Primitives are converted to their
+ * string representation, objects and arrays are converted to JSON.
+ *
+ * On error, call get_last_error_ptr() and get_last_error_len() to retrieve
+ * a human-readable error message including exception details and stack trace.
+ */
+__attribute__((export_name("eval_js")))
+int eval_js(const char* code_ptr, int len)
+{
+    // Validate input
+    if (code_ptr == NULL) {
+        set_error("code_ptr is NULL");
+        return 24;
+    }
+    
+    JSRuntime* rt = NULL;
+    JSContext* ctx = NULL;
+    int owned = 1;
+
+#ifdef SCRIPTBOX_SNAPSHOT
+    // Snapshot builds: the bootstrap already ran in the pre-initialized context
+    release_consumed_snapshot();
+    if (take_snapshot_context(&rt, &ctx)) {
+        owned = 0;
+    }
+#endif
+
+    if (owned) {
+        // Create fresh runtime and context for this evaluation
+        rt = new_runtime();
+        if (!rt) {
+            set_error("Failed to create JavaScript runtime");
+            return 20;
+        }
+
+        int status = create_eval_context(rt, &ctx);
+        if (status != 0) {
+            JS_FreeRuntime(rt);
+            return status;
         }
+    }
+
+    int status = eval_in_context(rt, ctx, code_ptr, len, 0);
+    release_eval_context(rt, ctx, owned);
+    return status;
+}
+
+// ---------- Shared runtime (pooled instances) ----------
+//
+// Hosts that keep a WASM instance alive across scripts call eval_js_shared
+// (or the context_* exports) instead of eval_js. The JSRuntime (atom table,
+// shape cache, allocator state) lives as long as the instance; every script
+// still gets a brand-new JSContext, so globals, prototypes and intrinsics are
+// never shared between scripts. Anything that could outlive a script on the
+// runtime (pending promise jobs) causes the runtime to be discarded, matching
+// eval_js semantics.
+
+static JSRuntime* g_shared_rt = NULL;
+
+// Context opened by context_create and used by context_eval*/context_free
+static JSContext* g_active_ctx = NULL;
+
+/**
+ * @brief Get (or lazily create) the long-lived runtime of this instance
+ * @return The runtime, or NULL if it could not be created
+ */
+static JSRuntime* acquire_shared_runtime(void) {
+    if (g_shared_rt != NULL) {
+        return g_shared_rt;
+    }
+
+#ifdef SCRIPTBOX_SNAPSHOT
+    // Free a snapshot already used by eval_js, otherwise adopt its runtime;
+    // the snapshot context stays pending for the first context_create
+    release_consumed_snapshot();
+    if (g_snapshot_rt != NULL) {
+        g_shared_rt = g_snapshot_rt;
+        g_snapshot_rt = NULL;
+        return g_shared_rt;
+    }
+#endif
+
+    g_shared_rt = new_runtime();
+    return g_shared_rt;
+}
+
+/**
+ * @brief Set the QuickJS heap limit and GC threshold of this instance's runtimes
+ * @param limit_bytes Largest total of live QuickJS allocations (0: no limit); allocations
+ *                    past it fail and the script sees an "out of memory" InternalError
+ * @param gc_threshold_bytes Allocation volume between automatic GC runs (0: QuickJS default)
+ *
+ * Applies to runtimes that already exist (shared, snapshot) and to every one created later.
+ * Both values are unsigned. Advertised through ABI_FEATURE_MEMORY_LIMITS.
+ */
+__attribute__((export_name("set_memory_limits")))
+void set_memory_limits(int limit_bytes, int gc_threshold_bytes) {
+    g_memory_limit = (uint32_t)limit_bytes;
+    g_gc_threshold = (uint32_t)gc_threshold_bytes;
+    apply_memory_limits(g_shared_rt);
+#ifdef SCRIPTBOX_SNAPSHOT
+    apply_memory_limits(g_snapshot_rt);
+#endif
+}
+
+/**
+ * @brief Bytes currently allocated by QuickJS across this instance's runtimes
+ *
+ * Unlike the size of linear memory, which never shrinks, this drops again when
+ * contexts are freed or the GC reclaims objects.
+ */
+__attribute__((export_name("get_heap_in_use")))
+int get_heap_in_use(void) {
+    return g_heap.in_use > INT_MAX ? INT_MAX : (int)g_heap.in_use;
+}
+
+// Slots of get_memory_stats, in the order GuestMemoryStats reads them
+enum {
+    MEMORY_STAT_HEAP_IN_USE,
+    MEMORY_STAT_HEAP_PEAK,
+    MEMORY_STAT_MALLOC_COUNT,
+    MEMORY_STAT_MEMORY_USED,
+    MEMORY_STAT_OBJECTS,
+    MEMORY_STAT_STRINGS,
+    MEMORY_STAT_ATOMS,
+    MEMORY_STAT_FUNCTIONS,
+    MEMORY_STAT_COUNT
+};
+
+static int64_t g_memory_stats[MEMORY_STAT_COUNT];
+
+/**
+ * @brief Snapshot the heap of the open context's runtime (JS_ComputeMemoryUsage)
+ * @return Pointer to MEMORY_STAT_COUNT int64 values, or NULL if there is no runtime
+ *
+ * Walks every object of the runtime, so its cost grows with the heap; the host only
+ * calls it when memory stats are enabled. Resets the peak, which therefore covers
+ * the time since the previous call. Advertised through ABI_FEATURE_MEMORY_STATS.
+ */
+__attribute__((export_name("get_memory_stats")))
+const int64_t* get_memory_stats(void) {
+    JSRuntime* rt = g_active_ctx != NULL ? JS_GetRuntime(g_active_ctx) : g_shared_rt;
+    if (rt == NULL) {
+        return NULL;
+    }
+
+    JSMemoryUsage usage;
+    JS_ComputeMemoryUsage(rt, &usage);
+    g_memory_stats[MEMORY_STAT_HEAP_IN_USE] = (int64_t)g_heap.in_use;
+    g_memory_stats[MEMORY_STAT_HEAP_PEAK] = (int64_t)g_heap.peak;
+    g_memory_stats[MEMORY_STAT_MALLOC_COUNT] = usage.malloc_count;
+    g_memory_stats[MEMORY_STAT_MEMORY_USED] = usage.memory_used_size;
+    g_memory_stats[MEMORY_STAT_OBJECTS] = usage.obj_count;
+    g_memory_stats[MEMORY_STAT_STRINGS] = usage.str_count;
+    g_memory_stats[MEMORY_STAT_ATOMS] = usage.atom_count;
+    g_memory_stats[MEMORY_STAT_FUNCTIONS] = usage.js_func_count;
+    g_heap.peak = g_heap.in_use;
+    return g_memory_stats;
+}
+
+// ---------- Interrupts: cooperative deadline and sampling profiler ----------
+//
+// QuickJS calls interrupt_handler every few thousand interpreter steps. Epoch
+// interruption traps the whole instance, which then has to be discarded; a
+// deadline checked here instead stops the script with an uncatchable
+// "interrupted" error and leaves the instance reusable. The same hook samples
+// the JavaScript stack of the open context for the profiler.
+
+// Sample records: the Error().stack text of each sample, NUL-terminated. An empty
+// record repeats the previous stack, so hot loops cost one byte per sample
+#define PROFILE_BUFFER_SIZE (1024 * 1024) // 1MB
 
-        const char* json_str = JS_ToCString(ctx, json_result);
-        if (!json_str) {
-            JS_FreeValue(ctx, json_result);
-            JS_FreeValue(ctx, stringify_fn);
-            JS_FreeValue(ctx, json_obj);
-            JS_FreeValue(ctx, global);
-            set_error("Failed to convert JSON result to string");
-            return -1;
+static int64_t g_deadline_ns = 0;  // 0: no deadline
+static int g_interrupted = 0;
+
+static int64_t g_sample_interval_ns = 0;  // 0: not profiling
+static int64_t g_next_sample_ns = 0;
+static int g_sampling = 0;
+static char* g_profile = NULL;
+static int g_profile_len = 0;
+static int g_profile_last = -1;  // offset of the last stack stored in full
+static int g_profile_samples = 0;
+static int g_profile_dropped = 0;
+
+// The open context's Error constructor, taken before any script could replace
+// the global; valid while g_active_ctx is set
+static JSValue g_error_ctor;
+
+// Slots of get_profile, in the order the host reads them
+enum {
+    PROFILE_SLOT_DATA,
+    PROFILE_SLOT_LENGTH,
+    PROFILE_SLOT_SAMPLES,
+    PROFILE_SLOT_DROPPED,
+    PROFILE_SLOT_COUNT
+};
+
+static int32_t g_profile_info[PROFILE_SLOT_COUNT];
+
+static int64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void append_sample(const char* stack, size_t len) {
+    if (g_profile == NULL) {
+        g_profile_dropped++;
+        return;
+    }
+
+    if (g_profile_last >= 0 && strcmp(g_profile + g_profile_last, stack) == 0) {
+        if (g_profile_len + 1 > PROFILE_BUFFER_SIZE) {
+            g_profile_dropped++;
+            return;
+        }
+        g_profile[g_profile_len++] = '\0';
+    } else {
+        if (len + 1 > (size_t)(PROFILE_BUFFER_SIZE - g_profile_len)) {
+            g_profile_dropped++;
+            return;
         }
+        g_profile_last = g_profile_len;
+        memcpy(g_profile + g_profile_len, stack, len + 1);
+        g_profile_len += (int)len + 1;
+    }
+    g_profile_samples++;
+}
 
-        snprintf(result_buf, result_buf_size, "%s", json_str);
+/**
+ * @brief Read an own data property without running accessors
+ * @param out Receives the value (free it) when the property is a data property
+ * @return 1 for a data property, 0 when absent, -1 for an accessor or an error
+ */
+static int get_own_data_property(JSContext* ctx, JSValueConst obj, const char* name, JSValue* out) {
+    JSAtom atom = JS_NewAtom(ctx, name);
+    if (atom == JS_ATOM_NULL) {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        return -1;
+    }
 
-        JS_FreeCString(ctx, json_str);
-        JS_FreeValue(ctx, json_result);
-        JS_FreeValue(ctx, stringify_fn);
-        JS_FreeValue(ctx, json_obj);
-        JS_FreeValue(ctx, global);
+    JSPropertyDescriptor desc;
+    int found = JS_GetOwnProperty(ctx, &desc, obj, atom);
+    JS_FreeAtom(ctx, atom);
+    if (found < 0) {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        return -1;
+    }
+    if (found == 0) {
         return 0;
     }
 
-    // Fallback: try to convert to string
-    const char* str = JS_ToCString(ctx, val);
-    if (!str) {
-        set_error("Failed to convert value to string");
+    if (desc.flags & JS_PROP_GETSET) {
+        JS_FreeValue(ctx, desc.getter);
+        JS_FreeValue(ctx, desc.setter);
+        JS_FreeValue(ctx, desc.value);
         return -1;
     }
-    snprintf(result_buf, result_buf_size, "%s", str);
-    JS_FreeCString(ctx, str);
-    return 0;
+
+    JS_FreeValue(ctx, desc.getter);
+    JS_FreeValue(ctx, desc.setter);
+    *out = desc.value;
+    return 1;
 }
 
-// ---------- JavaScript Evaluation ----------
+/**
+ * @brief True when building a backtrace could call back into script code
+ *
+ * Error.prepareStackTrace and an accessor Error.stackTraceLimit are read
+ * while QuickJS builds the stack of a new Error.
+ */
+static int backtrace_runs_script(JSContext* ctx, JSValueConst ctor) {
+    JSValue value;
+    int found = get_own_data_property(ctx, ctor, "prepareStackTrace", &value);
+    if (found < 0) {
+        return 1;
+    }
+    if (found > 0) {
+        int is_set = !JS_IsUndefined(value);
+        JS_FreeValue(ctx, value);
+        if (is_set) {
+            return 1;
+        }
+    }
+
+    found = get_own_data_property(ctx, ctor, "stackTraceLimit", &value);
+    if (found > 0) {
+        JS_FreeValue(ctx, value);
+    }
+    return found < 0;
+}
 
 /**
- * @brief Evaluate JavaScript code in a fresh context
+ * @brief Record the JavaScript stack of the open context
  *
- * Creates a new runtime and context for each invocation, evaluates the code,
- * captures the return value, and cleans up resources. This ensures isolation
- * between evaluations.
+ * Constructs an Error from C with the context's own Error constructor, so the
+ * backtrace QuickJS attaches to it holds exactly the frames of the running
+ * script. Nothing the script can redefine runs: samples are skipped (counted
+ * as dropped) while a stack hook is set, and only an own data "stack" property
+ * is read. Only the context API path is sampled; eval_js and eval_js_shared
+ * contexts are not tracked.
+ */
+static void take_sample(JSRuntime* rt) {
+    JSContext* ctx = g_active_ctx;
+    if (ctx == NULL || JS_GetRuntime(ctx) != rt || g_sampling) {
+        return;
+    }
+
+    if (!JS_IsFunction(ctx, g_error_ctor) || backtrace_runs_script(ctx, g_error_ctor)) {
+        g_profile_dropped++;
+        return;
+    }
+
+    g_sampling = 1;  // the Error constructor runs the interpreter, which polls again
+    JSValue error = JS_CallConstructor(ctx, g_error_ctor, 0, NULL);
+    JSValue stack = JS_UNDEFINED;
+    if (JS_IsException(error)) {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        g_profile_dropped++;
+    } else if (get_own_data_property(ctx, error, "stack", &stack) <= 0 || !JS_IsString(stack)) {
+        g_profile_dropped++;
+    } else {
+        size_t len;
+        const char* text = JS_ToCStringLen(ctx, &len, stack);
+        if (text != NULL) {
+            append_sample(text, len);
+            JS_FreeCString(ctx, text);
+        } else {
+            JS_FreeValue(ctx, JS_GetException(ctx));
+            g_profile_dropped++;
+        }
+    }
+
+    JS_FreeValue(ctx, stack);
+    JS_FreeValue(ctx, error);
+    g_sampling = 0;
+}
+
+static int interrupt_handler(JSRuntime* rt, void* opaque) {
+    if (g_deadline_ns == 0 && g_sample_interval_ns == 0) {
+        return 0;
+    }
+
+    int64_t now = monotonic_ns();
+    if (g_deadline_ns != 0 && now >= g_deadline_ns) {
+        g_interrupted = 1;
+        return 1;
+    }
+
+    if (g_sample_interval_ns != 0 && now >= g_next_sample_ns) {
+        g_next_sample_ns = now + g_sample_interval_ns;
+        take_sample(rt);
+    }
+    return 0;
+}
+
+/**
+ * @brief Stop running scripts once timeout_ms have passed (0 disarms)
  *
- * @param code_ptr Pointer to JavaScript source code (in WASM linear memory)
- * @param len Number of bytes to read from code_ptr
+ * Arming clears was_interrupted(); disarming keeps it, so the host can read it
+ * after the step. Advertised through ABI_FEATURE_INTERRUPTS.
+ */
+__attribute__((export_name("set_interrupt_deadline")))
+void set_interrupt_deadline(int timeout_ms) {
+    if (timeout_ms > 0) {
+        g_deadline_ns = monotonic_ns() + (int64_t)timeout_ms * 1000000;
+        g_interrupted = 0;
+    } else {
+        g_deadline_ns = 0;
+    }
+}
+
+/**
+ * @brief 1 if the armed deadline passed and interrupted the script, else 0
+ */
+__attribute__((export_name("was_interrupted")))
+int was_interrupted(void) {
+    return g_interrupted;
+}
+
+/**
+ * @brief Start sampling the JavaScript stack every interval_us microseconds (0 stops)
  *
- * @return Status code:
- *   0 = Success (result available via get_result_ptr/get_result_len)
- *   20 = Failed to create runtime
- *   21 = Failed to create context
- *   22 = Evaluation resulted in exception (see get_last_error_ptr)
- *   23 = Global object is null/undefined
- *   24 = code_ptr is NULL
- *   25 = Failed to allocate code buffer
- *   26 = Failed to convert result to string
+ * Starting discards the samples of the previous profile. Samples are taken at
+ * interrupt checks, so the real spacing is at least the interval. Advertised
+ * through ABI_FEATURE_PROFILER.
+ */
+__attribute__((export_name("set_profiler")))
+void set_profiler(int interval_us) {
+    if (interval_us <= 0) {
+        g_sample_interval_ns = 0;
+        return;
+    }
+
+    if (g_profile == NULL) {
+        g_profile = malloc(PROFILE_BUFFER_SIZE);
+    }
+    g_profile_len = 0;
+    g_profile_last = -1;
+    g_profile_samples = 0;
+    g_profile_dropped = 0;
+    g_sample_interval_ns = (int64_t)interval_us * 1000;
+    g_next_sample_ns = monotonic_ns() + g_sample_interval_ns;
+}
+
+/**
+ * @brief Samples of the current profile
+ * @return Pointer to PROFILE_SLOT_COUNT int32 values: records pointer, records
+ *         length, samples stored and samples dropped because the buffer was full
+ */
+__attribute__((export_name("get_profile")))
+const int32_t* get_profile(void) {
+    g_profile_info[PROFILE_SLOT_DATA] = (int32_t)(intptr_t)g_profile;
+    g_profile_info[PROFILE_SLOT_LENGTH] = g_profile_len;
+    g_profile_info[PROFILE_SLOT_SAMPLES] = g_profile_samples;
+    g_profile_info[PROFILE_SLOT_DROPPED] = g_profile_dropped;
+    return g_profile_info;
+}
+
+/**
+ * @brief Drop per-script leftovers from the shared runtime after a context is freed
+ */
+static void recycle_shared_runtime(void) {
+    if (g_shared_rt == NULL) {
+        return;
+    }
+
+    if (JS_IsJobPending(g_shared_rt)) {
+        // Promise jobs keep the script's realm alive; start over with a clean runtime
+#ifdef SCRIPTBOX_SNAPSHOT
+        if (g_snapshot_rt == NULL && g_snapshot_ctx != NULL) {
+            JS_FreeContext(g_snapshot_ctx);
+            g_snapshot_ctx = NULL;
+        }
+#endif
+        JS_FreeRuntime(g_shared_rt);
+        g_shared_rt = NULL;
+        return;
+    }
+
+    JS_RunGC(g_shared_rt);
+}
+
+/**
+ * @brief Free the context opened by context_create
  *
- * On success, call get_result_ptr() and get_result_len() to retrieve the
- * JavaScript return value as a string. Primitives are converted to their
- * string representation, objects and arrays are converted to JSON.
+ * Safe to call when no context is open. The host calls this after the last
+ * evaluation of a script; context_create also calls it to drop a context
+ * left behind by an aborted run.
+ */
+__attribute__((export_name("context_free")))
+void context_free(void) {
+    if (g_active_ctx == NULL) {
+        return;
+    }
+
+    if (g_await_ctx == g_active_ctx) {
+        clear_awaited_result();
+    }
+    drop_pending_calls(g_active_ctx);
+    JS_FreeValue(g_active_ctx, g_error_ctor);
+    JS_FreeContext(g_active_ctx);
+    g_active_ctx = NULL;
+    recycle_shared_runtime();
+}
+
+/**
+ * @brief Open a fresh context (host bridge installed) on the shared runtime
+ * @return 0 on success, otherwise an eval_js status code (20, 21, 22 or 23)
+ */
+__attribute__((export_name("context_create")))
+int context_create(void) {
+    context_free();
+    g_log_len = 0;  // entries of a run that never returned (trapped) are not this script's
+
+    JSRuntime* rt = acquire_shared_runtime();
+    if (!rt) {
+        set_error("Failed to create JavaScript runtime");
+        return 20;
+    }
+
+#ifdef SCRIPTBOX_SNAPSHOT
+    // First context of an instance: the snapshot context, bootstrap already run
+    if (g_snapshot_rt == NULL && g_snapshot_ctx != NULL && !g_snapshot_consumed) {
+        g_active_ctx = g_snapshot_ctx;
+        g_snapshot_ctx = NULL;
+        g_snapshot_consumed = 1;
+    } else
+#endif
+    {
+        int status = create_eval_context(rt, &g_active_ctx);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    // No user script has run in the context yet, so this is the intrinsic
+    JSValue global = JS_GetGlobalObject(g_active_ctx);
+    g_error_ctor = JS_GetPropertyStr(g_active_ctx, global, "Error");
+    JS_FreeValue(g_active_ctx, global);
+    if (JS_IsException(g_error_ctor)) {
+        JS_FreeValue(g_active_ctx, JS_GetException(g_active_ctx));
+        g_error_ctor = JS_UNDEFINED;
+    }
+
+    set_error("OK");
+    return 0;
+}
+
+/**
+ * @brief Evaluate source in the context opened by context_create
+ * @param flags EVAL_FLAG_* bits
+ * @return eval_js status codes, or 27 if no context is open
+ */
+__attribute__((export_name("context_eval")))
+int context_eval(const char* code_ptr, int len, int flags) {
+    if (code_ptr == NULL) {
+        set_error("code_ptr is NULL");
+        return 24;
+    }
+
+    if (g_active_ctx == NULL) {
+        set_error("No active context (call context_create first)");
+        return 27;
+    }
+
+    return eval_in_context(g_shared_rt, g_active_ctx, code_ptr, len, flags);
+}
+
+/**
+ * @brief Evaluate JavaScript code in a fresh context on the instance's shared runtime
  *
- * On error, call get_last_error_ptr() and get_last_error_len() to retrieve
- * a human-readable error message including exception details and stack trace.
+ * Same contract and status codes as eval_js, but only the context is created
+ * and destroyed per call. Advertised through ABI_FEATURE_SHARED_RUNTIME.
  */
-__attribute__((export_name("eval_js")))
-int eval_js(const char* code_ptr, int len)
+__attribute__((export_name("eval_js_shared")))
+int eval_js_shared(const char* code_ptr, int len)
 {
-    // Validate input
     if (code_ptr == NULL) {
         set_error("code_ptr is NULL");
         return 24;
     }
-    
-    // Create fresh runtime and context for this evaluation
-    JSRuntime* rt = JS_NewRuntime();
+
+    int status = context_create();
+    if (status != 0) {
+        return status;
+    }
+
+    status = context_eval(code_ptr, len, 0);
+    context_free();
+    return status;
+}
+
+// ---------- Bytecode ----------
+//
+// compile_js turns source into QuickJS bytecode (JS_WriteObject) that the host
+// caches and replays with context_eval_bytecode (JS_ReadObject + JS_EvalFunction),
+// skipping the parser for bootstrap scripts and repeated user scripts.
+// Bytecode is only valid for the exact module build that produced it.
+
+// Last compile_js output, owned by this module (malloc) so it outlives runtimes
+static uint8_t* g_bytecode = NULL;
+static size_t g_bytecode_len = 0;
+
+/**
+ * @brief Compile source to bytecode without running it
+ * @return 0 on success (see get_bytecode_ptr/len), 22 on syntax error,
+ *         20/21 if no context could be created, 25 on allocation failure,
+ *         29 if serialization failed
+ */
+__attribute__((export_name("compile_js")))
+int compile_js(const char* code_ptr, int len) {
+    if (code_ptr == NULL) {
+        set_error("code_ptr is NULL");
+        return 24;
+    }
+
+    JSRuntime* rt = acquire_shared_runtime();
     if (!rt) {
         set_error("Failed to create JavaScript runtime");
         return 20;
     }
 
-    JSContext* ctx = JS_NewContext(rt);
-    if (!ctx) {
-        set_error("Failed to create JavaScript context");
-        JS_FreeRuntime(rt);
-        return 21;
+    // Compilation has no side effects; a bare context is enough when none is open
+    JSContext* ctx = g_active_ctx;
+    int owned = 0;
+    if (ctx == NULL) {
+        ctx = JS_NewContext(rt);
+        if (!ctx) {
+            set_error("Failed to create JavaScript context");
+            return 21;
+        }
+        owned = 1;
     }
 
-    // Disable stack limit checks for WASI
-    // Setting to 0 disables the check entirely (QuickJS default is very conservative for WASI)
-    JS_SetMaxStackSize(rt, 0);
+    int status = 0;
+    char* code_copy = NULL;
+    const char* code = code_ptr;
+    if (!is_terminated_input(code_ptr, len)) {
+        code_copy = js_malloc_rt(rt, len + 1);
+        if (!code_copy) {
+            set_error("Failed to allocate code buffer (%d bytes)", len + 1);
+            status = 25;
+            goto done;
+        }
+        memcpy(code_copy, code_ptr, len);
+        code_copy[len] = '\0';
+        code = code_copy;
+    }
 
-    // Install console.log and __host_call_json
-    if (install_host_bridge(ctx) != 0) {
-        // install_host_bridge already set an error message
-        JS_FreeContext(ctx);
-        JS_FreeRuntime(rt);
-        return 23;
+    JSValue fn = JS_Eval(ctx, code, len, "eval", JS_EVAL_FLAG_COMPILE_ONLY);
+    if (code_copy) {
+        js_free_rt(rt, code_copy);
+    }
+    if (JS_IsException(fn)) {
+        JSValue exc = JS_GetException(ctx);
+        capture_exception(ctx, exc);
+        JS_FreeValue(ctx, exc);
+        status = 22;
+        goto done;
+    }
+
+    size_t size = 0;
+    uint8_t* buf = JS_WriteObject(ctx, &size, fn, JS_WRITE_OBJ_BYTECODE);
+    JS_FreeValue(ctx, fn);
+    if (!buf) {
+        set_error("Failed to serialize bytecode");
+        status = 29;
+        goto done;
+    }
+
+    free(g_bytecode);
+    g_bytecode = malloc(size);
+    if (!g_bytecode) {
+        g_bytecode_len = 0;
+        js_free(ctx, buf);
+        set_error("Failed to allocate bytecode buffer (%zu bytes)", size);
+        status = 25;
+        goto done;
     }
+    memcpy(g_bytecode, buf, size);
+    g_bytecode_len = size;
+    js_free(ctx, buf);
+    set_error("OK");
 
-    // Create a null-terminated copy of the code buffer
-    // This is necessary because JS_Eval may read past the boundary in certain edge cases
-    char* code_copy = js_malloc_rt(rt, len + 1);
-    if (!code_copy) {
-        set_error("Failed to allocate code buffer (%d bytes)", len + 1);
+done:
+    if (owned) {
         JS_FreeContext(ctx);
-        JS_FreeRuntime(rt);
-        return 25;
+        recycle_shared_runtime();
     }
-    
-    // Copy code and ensure null termination
-    for (int i = 0; i < len; i++) {
-        code_copy[i] = code_ptr[i];
+    return status;
+}
+
+/**
+ * @brief Get pointer to the bytecode produced by the last successful compile_js
+ */
+__attribute__((export_name("get_bytecode_ptr")))
+const uint8_t* get_bytecode_ptr(void) {
+    return g_bytecode;
+}
+
+/**
+ * @brief Get length of the bytecode produced by the last successful compile_js
+ */
+__attribute__((export_name("get_bytecode_len")))
+int get_bytecode_len(void) {
+    return (int)g_bytecode_len;
+}
+
+/**
+ * @brief Run bytecode from compile_js in the context opened by context_create
+ * @param flags EVAL_FLAG_* bits
+ * @return eval_js status codes, 27 if no context is open, 28 if the bytecode is invalid
+ */
+__attribute__((export_name("context_eval_bytecode")))
+int context_eval_bytecode(const uint8_t* ptr, int len, int flags) {
+    if (ptr == NULL) {
+        set_error("bytecode pointer is NULL");
+        return 24;
     }
-    code_copy[len] = '\0';
 
-    // Evaluate the code in the existing global scope (no flags = use current context's global)
-    // Note: JS_EVAL_TYPE_GLOBAL creates a NEW global scope, which would lose our bridge functions!
-    JSValue result = JS_Eval(ctx, code_copy, len, "eval", 0);
+    if (g_active_ctx == NULL) {
+        set_error("No active context (call context_create first)");
+        return 27;
+    }
 
-    // Handle evaluation result
-    if (JS_IsException(result)) {
+    JSValue fn = JS_ReadObject(g_active_ctx, ptr, len, JS_READ_OBJ_BYTECODE);
+    if (JS_IsException(fn)) {
+        JSValue exc = JS_GetException(g_active_ctx);
+        capture_exception(g_active_ctx, exc);
+        JS_FreeValue(g_active_ctx, exc);
+        return 28;
+    }
+
+    // JS_EvalFunction takes ownership of fn
+    JSValue result = JS_EvalFunction(g_active_ctx, fn);
+    return end_step(complete_eval(g_active_ctx, result, flags));
+}
+
+/**
+ * @brief Run bytecode that evaluates to a function, calling it with a JSON argument
+ * @param ptr Bytecode (bytecode_len bytes) followed by the argument as JSON text (args_len bytes;
+ *            0 passes undefined)
+ * @param flags EVAL_FLAG_* bits, applied to the value the function returns
+ * @return context_eval_bytecode status codes; 22 also when the argument is not valid JSON
+ *         or the bytecode does not evaluate to a function
+ *
+ * Lets the host compile a script template once and run it with different inputs
+ * instead of splicing each input into the source. Advertised through ABI_FEATURE_PREPARED_CALL.
+ */
+__attribute__((export_name("context_call_bytecode")))
+int context_call_bytecode(const uint8_t* ptr, int bytecode_len, int args_len, int flags) {
+    if (ptr == NULL || bytecode_len < 0 || args_len < 0) {
+        set_error("Invalid prepared call input");
+        return 24;
+    }
+
+    if (g_active_ctx == NULL) {
+        set_error("No active context (call context_create first)");
+        return 27;
+    }
+
+    JSContext* ctx = g_active_ctx;
+    JSValue fn = JS_ReadObject(ctx, ptr, bytecode_len, JS_READ_OBJ_BYTECODE);
+    if (JS_IsException(fn)) {
         JSValue exc = JS_GetException(ctx);
         capture_exception(ctx, exc);
         JS_FreeValue(ctx, exc);
-        JS_FreeValue(ctx, result);
-        js_free_rt(rt, code_copy);
-        JS_FreeContext(ctx);
-        JS_FreeRuntime(rt);
+        return 28;
+    }
+
+    JSValue target = JS_EvalFunction(ctx, fn);
+    if (JS_IsException(target)) {
+        return end_step(complete_eval(ctx, target, flags));
+    }
+    if (!JS_IsFunction(ctx, target)) {
+        JS_FreeValue(ctx, target);
+        set_error("Exception: prepared script did not evaluate to a function");
         return 22;
     }
 
-    // Success - capture the result value
-    if (js_value_to_string(ctx, result, g_result, sizeof(g_result)) != 0) {
-        // Failed to convert result to string
-        JS_FreeValue(ctx, result);
-        js_free_rt(rt, code_copy);
-        JS_FreeContext(ctx);
-        JS_FreeRuntime(rt);
-        return 26;  // New error code for result conversion failure
+    JSValue arg = JS_UNDEFINED;
+    if (args_len > 0) {
+        // JS_ParseJSON needs a NUL after the text; the host places it last in the input buffer
+        const char* args = (const char*)ptr + bytecode_len;
+        char* args_copy = NULL;
+        if (!is_terminated_input(args, args_len)) {
+            args_copy = js_malloc(ctx, (size_t)args_len + 1);
+            if (!args_copy) {
+                JS_FreeValue(ctx, target);
+                set_error("Failed to allocate prepared call argument (%d bytes)", args_len);
+                return 25;
+            }
+            memcpy(args_copy, args, (size_t)args_len);
+            args_copy[args_len] = '\0';
+            args = args_copy;
+        }
+
+        arg = JS_ParseJSON(ctx, args, (size_t)args_len, "<input>");
+        js_free(ctx, args_copy);
+        if (JS_IsException(arg)) {
+            JS_FreeValue(ctx, target);
+            return end_step(complete_eval(ctx, arg, flags));
+        }
     }
 
-    JS_FreeValue(ctx, result);
-    js_free_rt(rt, code_copy);
-    JS_FreeContext(ctx);
-    JS_FreeRuntime(rt);
-    set_error("OK");
-    return 0;
+    JSValue result = JS_Call(ctx, target, JS_UNDEFINED, 1, (JSValueConst*)&arg);
+    JS_FreeValue(ctx, arg);
+    JS_FreeValue(ctx, target);
+    return end_step(complete_eval(ctx, result, flags));
+}
+
+/**
+ * @brief Deliver the response of an async host call and continue the awaited script
+ *
+ * Resolves the promise returned by __host.bridgeAsync for call_id with the response
+ * string, then runs promise jobs. Responses for unknown ids (calls dropped with their
+ * context) are ignored.
+ *
+ * @param ptr UTF-8 response, same format as a __host.bridge response
+ * @return 0 once the awaited result is available, 22 if it rejected, 30 while more
+ *         host calls are pending, 31 if no evaluation is awaiting host calls
+ */
+__attribute__((export_name("complete_host_call")))
+int complete_host_call(int call_id, const char* ptr, int len) {
+    if (!g_await_active) {
+        set_error("No evaluation is awaiting host calls");
+        return 31;
+    }
+
+    PendingHostCall call;
+    if (take_pending_call(call_id, &call)) {
+        JSValue response = JS_NewStringLen(call.ctx, ptr != NULL ? ptr : "", ptr != NULL ? (size_t)len : 0);
+        JSValue ret = JS_Call(call.ctx, call.resolve, JS_UNDEFINED, 1, &response);
+        JS_FreeValue(call.ctx, ret);
+        JS_FreeValue(call.ctx, response);
+        JS_FreeValue(call.ctx, call.resolve);
+    }
+
+    return end_step(settle_awaited_result());
+}
+
+// ---------- ABI feature discovery ----------
+
+// Bits returned by get_abi_features(). The host only uses optional exports
+// whose bit is set and falls back to eval_js otherwise.
+#define ABI_FEATURE_SHARED_RUNTIME (1 << 0)  // eval_js_shared
+#define ABI_FEATURE_CONTEXT_API    (1 << 1)  // context_create/context_eval/context_free
+#define ABI_FEATURE_BYTECODE       (1 << 2)  // compile_js/context_eval_bytecode
+#define ABI_FEATURE_RESULT_REGION  (1 << 3)  // get_result_region/free_result
+#define ABI_FEATURE_GROW_RESPONSE  (1 << 4)  // grow_response_buffer (two-phase host_call)
+#define ABI_FEATURE_INPUT_ALLOC    (1 << 5)  // alloc_input/free_input
+#define ABI_FEATURE_ASYNC_HOST     (1 << 6)  // __host.bridgeAsync, EVAL_FLAG_AWAIT_RESULT, complete_host_call
+#define ABI_FEATURE_BINARY_HOST    (1 << 7)  // __host.bridgeBinary (MessagePack host calls)
+#define ABI_FEATURE_MEMORY_LIMITS  (1 << 8)  // set_memory_limits/get_heap_in_use (tracked allocator)
+#define ABI_FEATURE_BINARY_RESULT  (1 << 9)  // EVAL_FLAG_BINARY_RESULT (MessagePack results)
+#define ABI_FEATURE_PREPARED_CALL  (1 << 10) // context_call_bytecode (script templates)
+#define ABI_FEATURE_MEMORY_STATS   (1 << 11) // get_memory_stats
+#define ABI_FEATURE_INTERRUPTS     (1 << 12) // set_interrupt_deadline/was_interrupted
+#define ABI_FEATURE_PROFILER       (1 << 13) // set_profiler/get_profile
+
+/**
+ * @brief Report optional capabilities of this module to the host
+ * @return Bitmask of ABI_FEATURE_* flags
+ */
+__attribute__((export_name("get_abi_features")))
+int get_abi_features(void) {
+    return ABI_FEATURE_SHARED_RUNTIME
+         | ABI_FEATURE_CONTEXT_API
+         | ABI_FEATURE_BYTECODE
+         | ABI_FEATURE_RESULT_REGION
+         | ABI_FEATURE_GROW_RESPONSE
+         | ABI_FEATURE_INPUT_ALLOC
+         | ABI_FEATURE_ASYNC_HOST
+         | ABI_FEATURE_BINARY_HOST
+         | ABI_FEATURE_MEMORY_LIMITS
+         | ABI_FEATURE_BINARY_RESULT
+         | ABI_FEATURE_PREPARED_CALL
+         | ABI_FEATURE_MEMORY_STATS
+         | ABI_FEATURE_INTERRUPTS
+         | ABI_FEATURE_PROFILER;
 }
 
 // ---------- Diagnostic Functions ----------
@@ -533,7 +2904,7 @@ int eval_js(const char* code_ptr, int len)
  */
 __attribute__((export_name("quickjs_selftest")))
 int quickjs_selftest(void) {
-    JSRuntime* rt = JS_NewRuntime();
+    JSRuntime* rt = new_runtime();
     if (!rt) {
         set_error("Selftest: Failed to create runtime");
         return 100;
@@ -546,9 +2917,6 @@ int quickjs_selftest(void) {
         return 101;
     }
 
-    // Disable stack checks for testing
-    JS_SetMaxStackSize(rt, 0);
-
     // Simple test: evaluate "1+1"
     const char* src = "1+1";
     JSValue result = JS_Eval(ctx, src, 3, "selftest", JS_EVAL_TYPE_GLOBAL);
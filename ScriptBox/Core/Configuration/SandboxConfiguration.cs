@@ -47,6 +47,52 @@ public sealed class SandboxConfiguration
     /// </summary>
     public int HttpTimeoutMs { get; set; } = 30000; // 30 seconds
 
+    /// <summary>
+    /// Maximum number of HTTP bodies and files a script may hold open through the streaming API
+    /// (<c>http.open</c>, <c>fs.open</c>) at once. Defaults to 16.
+    /// </summary>
+    public int MaxOpenStreams { get; set; } = 16;
+
+    /// <summary>
+    /// Largest chunk, in bytes, a single streaming read returns; larger requests are clamped.
+    /// Streamed bodies are read incrementally and are not subject to <see cref="MaxHttpResponseSize"/>.
+    /// Defaults to 64KB.
+    /// </summary>
+    public int MaxStreamReadSize { get; set; } = 64 * 1024; // 64KB
+
+    /// <summary>
+    /// Upper bound, in bytes, on the linear memory of each WebAssembly instance, enforced by
+    /// Wasmtime store limits. Growing past it fails inside the guest, so the script gets an
+    /// "out of memory" error instead of the process growing. Null leaves memory unbounded (up to 4GB).
+    /// </summary>
+    public long? MaxGuestMemoryBytes { get; set; }
+
+    /// <summary>
+    /// Largest total of live QuickJS allocations per instance, in bytes. Allocations past it
+    /// fail with an "out of memory" InternalError the script can observe. Null means no limit.
+    /// Ignored by modules built before the guest tracked its allocations.
+    /// </summary>
+    public long? ScriptHeapLimitBytes { get; set; }
+
+    /// <summary>
+    /// Bytes QuickJS may allocate between automatic GC runs. Lower values trade CPU for a
+    /// smaller heap. Null keeps the QuickJS default (256KB).
+    /// </summary>
+    public long? GcThresholdBytes { get; set; }
+
+    /// <summary>
+    /// Most console entries kept per script run; later ones are dropped and counted in a final
+    /// note. Bounds the memory a script that logs in a loop can hold on the host side.
+    /// Null keeps every entry. Defaults to 10,000.
+    /// </summary>
+    public int? MaxLogEntries { get; set; } = 10_000;
+
+    /// <summary>
+    /// Share of console entries kept, between 0 (exclusive) and 1. Entries are thinned evenly
+    /// (0.1 keeps every tenth) before <see cref="MaxLogEntries"/> applies. Defaults to 1 (keep all).
+    /// </summary>
+    public double LogSampleRate { get; set; } = 1.0;
+
     /// <summary>
     /// Scripts that should be prepended before every user script.
     /// Developers can remove scriptbox-api.js from this list to provide their own API surface.
@@ -69,6 +115,13 @@ public sealed class SandboxConfiguration
     /// </summary>
     public Func<HttpClient>? HttpClientFactory { get; set; }
 
+    /// <summary>
+    /// When set, HTTP calls go through a process-wide pooled handler shared by every configuration
+    /// with equal options, instead of a handler owned by each host API instance.
+    /// Ignored when <see cref="HttpClientFactory"/> is set.
+    /// </summary>
+    public SharedHttpHandlerOptions? SharedHttpHandler { get; set; }
+
     /// <summary>
     /// Optional hook to request consent for file system access that would otherwise be denied.
     /// Return true to allow, false to deny.
@@ -109,6 +162,43 @@ public sealed class SandboxConfiguration
             throw new InvalidOperationException("HttpTimeoutMs must be positive");
         }
 
+        if (MaxOpenStreams < 0)
+        {
+            throw new InvalidOperationException("MaxOpenStreams cannot be negative");
+        }
+
+        if (MaxStreamReadSize <= 0)
+        {
+            throw new InvalidOperationException("MaxStreamReadSize must be positive");
+        }
+
+        if (MaxGuestMemoryBytes <= 0)
+        {
+            throw new InvalidOperationException("MaxGuestMemoryBytes must be positive");
+        }
+
+        if (ScriptHeapLimitBytes is <= 0 or > uint.MaxValue)
+        {
+            throw new InvalidOperationException($"ScriptHeapLimitBytes must be between 1 and {uint.MaxValue}");
+        }
+
+        if (GcThresholdBytes is <= 0 or > uint.MaxValue)
+        {
+            throw new InvalidOperationException($"GcThresholdBytes must be between 1 and {uint.MaxValue}");
+        }
+
+        if (MaxLogEntries < 0)
+        {
+            throw new InvalidOperationException("MaxLogEntries cannot be negative");
+        }
+
+        if (LogSampleRate is not (> 0 and <= 1))
+        {
+            throw new InvalidOperationException("LogSampleRate must be greater than 0 and at most 1");
+        }
+
+        SharedHttpHandler?.Validate();
+
         StartupScripts ??= new List<string>();
     }
 
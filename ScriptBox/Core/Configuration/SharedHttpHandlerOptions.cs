@@ -0,0 +1,50 @@
+namespace ScriptBox.Core.Configuration;
+
+/// <summary>
+/// Connection pool settings for the process-wide HTTP handler used by sandbox HTTP calls.
+/// Configurations with equal settings share one handler, so scripts calling the same
+/// backends reuse warm connections instead of paying a TCP and TLS handshake per ScriptBox.
+/// </summary>
+public sealed class SharedHttpHandlerOptions
+{
+    /// <summary>
+    /// Maximum concurrent connections per server. Defaults to unlimited.
+    /// </summary>
+    public int MaxConnectionsPerServer { get; set; } = int.MaxValue;
+
+    /// <summary>
+    /// How long a connection may be reused before it is replaced; this is what picks up DNS changes.
+    /// Defaults to 2 minutes. Ignored before .NET 6.
+    /// </summary>
+    public TimeSpan PooledConnectionLifetime { get; set; } = TimeSpan.FromMinutes(2);
+
+    /// <summary>
+    /// How long an idle connection stays in the pool. Defaults to 1 minute. Ignored before .NET 6.
+    /// </summary>
+    public TimeSpan PooledConnectionIdleTimeout { get; set; } = TimeSpan.FromMinutes(1);
+
+    /// <summary>
+    /// Request HTTP/2 for https URLs, multiplexing requests over one connection and opening
+    /// more when the server's stream limit is reached. Falls back to HTTP/1.1. Defaults to true.
+    /// Ignored before .NET 6.
+    /// </summary>
+    public bool EnableHttp2 { get; set; } = true;
+
+    internal void Validate()
+    {
+        if (MaxConnectionsPerServer <= 0)
+        {
+            throw new InvalidOperationException("MaxConnectionsPerServer must be positive");
+        }
+
+        if (PooledConnectionLifetime <= TimeSpan.Zero && PooledConnectionLifetime != Timeout.InfiniteTimeSpan)
+        {
+            throw new InvalidOperationException("PooledConnectionLifetime must be positive or infinite");
+        }
+
+        if (PooledConnectionIdleTimeout <= TimeSpan.Zero && PooledConnectionIdleTimeout != Timeout.InfiniteTimeSpan)
+        {
+            throw new InvalidOperationException("PooledConnectionIdleTimeout must be positive or infinite");
+        }
+    }
+}
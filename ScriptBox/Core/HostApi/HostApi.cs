@@ -1,5 +1,7 @@
+using System.Net;
 using System.Text;
 using System.Text.Json;
+using System.Threading;
 using ScriptBox.Core.Configuration;
 
 namespace ScriptBox.Core.HostApi;
@@ -13,6 +15,9 @@ internal sealed class HostApiImpl : IHostApi
     private readonly SandboxConfiguration _config;
     private readonly string _sandboxRoot;
     private readonly HttpClient _httpClient;
+#if NET6_0_OR_GREATER
+    private readonly bool _requestHttp2;
+#endif
 
     public HostApiImpl(SandboxConfiguration? config = null)
     {
@@ -25,6 +30,16 @@ internal sealed class HostApiImpl : IHostApi
             _httpClient = _config.HttpClientFactory();
             _httpClient.Timeout = TimeSpan.FromMilliseconds(_config.HttpTimeoutMs);
         }
+        else if (_config.SharedHttpHandler != null)
+        {
+            _httpClient = new HttpClient(SharedHttpHandlers.Get(_config.SharedHttpHandler), disposeHandler: false)
+            {
+                Timeout = TimeSpan.FromMilliseconds(_config.HttpTimeoutMs)
+            };
+#if NET6_0_OR_GREATER
+            _requestHttp2 = _config.SharedHttpHandler.EnableHttp2;
+#endif
+        }
         else
         {
             _httpClient = new HttpClient
@@ -112,6 +127,18 @@ internal sealed class HostApiImpl : IHostApi
         return File.ReadAllText(fullPath, Encoding.UTF8);
     }
 
+    public Stream FileSystemOpenRead(string path)
+    {
+        var fullPath = ValidateAndResolvePath(path, "Read");
+
+        if (!File.Exists(fullPath))
+        {
+            throw new FileNotFoundException($"File not found: {path}");
+        }
+
+        return new FileStream(fullPath, FileMode.Open, FileAccess.Read, FileShare.Read, 4096, FileOptions.SequentialScan);
+    }
+
     public void FileSystemWriteFile(string path, string content)
     {
         var fullPath = ValidateAndResolvePath(path, "Write");
@@ -242,19 +269,33 @@ internal sealed class HostApiImpl : IHostApi
         }
     }
 
+    private HttpRequestMessage CreateRequest(HttpMethod method, string url)
+    {
+        var request = new HttpRequestMessage(method, url);
+#if NET6_0_OR_GREATER
+        if (_requestHttp2)
+        {
+            // Negotiated through ALPN on https; plain http stays on HTTP/1.1
+            request.Version = HttpVersion.Version20;
+            request.VersionPolicy = HttpVersionPolicy.RequestVersionOrLower;
+        }
+#endif
+        return request;
+    }
+
     /// <summary>
     /// Validates that the response size is within limits.
     /// </summary>
-    private async Task<string> ReadResponseWithLimitAsync(HttpResponseMessage response)
+    private async Task<string> ReadResponseWithLimitAsync(HttpResponseMessage response, CancellationToken cancellationToken)
     {
-        using var stream = await response.Content.ReadAsStreamAsync();
+        using var stream = await response.Content.ReadAsStreamAsync().ConfigureAwait(false);
         using var memoryStream = new MemoryStream();
 
         var buffer = new byte[8192];
         var totalRead = 0;
         int bytesRead;
 
-        while ((bytesRead = await stream.ReadAsync(buffer, 0, buffer.Length)) > 0)
+        while ((bytesRead = await stream.ReadAsync(buffer, 0, buffer.Length, cancellationToken).ConfigureAwait(false)) > 0)
         {
             totalRead += bytesRead;
             if (totalRead > _config.MaxHttpResponseSize)
@@ -268,119 +309,121 @@ internal sealed class HostApiImpl : IHostApi
 
         memoryStream.Position = 0;
         using var reader = new StreamReader(memoryStream, Encoding.UTF8);
-        return await reader.ReadToEndAsync();
+        return await reader.ReadToEndAsync().ConfigureAwait(false);
     }
 
-    public string HttpGet(string url)
+    public string HttpGet(string url) => HttpGetAsync(url).GetAwaiter().GetResult();
+
+    public async Task<string> HttpGetAsync(string url, CancellationToken cancellationToken = default)
     {
         if (string.IsNullOrWhiteSpace(url)) throw new ArgumentException("URL cannot be null or empty");
         
-        using var request = new HttpRequestMessage(HttpMethod.Get, url);
+        using var request = CreateRequest(HttpMethod.Get, url);
         ValidateRequest(request);
 
         try
         {
-            var response = _httpClient.SendAsync(request).GetAwaiter().GetResult();
+            var response = await _httpClient.SendAsync(request, cancellationToken).ConfigureAwait(false);
             response.EnsureSuccessStatusCode();
-            return ReadResponseWithLimitAsync(response).GetAwaiter().GetResult();
+            return await ReadResponseWithLimitAsync(response, cancellationToken).ConfigureAwait(false);
         }
         catch (HttpRequestException ex)
         {
             throw new InvalidOperationException($"HTTP GET request failed: {ex.Message}", ex);
         }
-        catch (TaskCanceledException)
+        catch (TaskCanceledException) when (!cancellationToken.IsCancellationRequested)
         {
             throw new TimeoutException($"HTTP GET request timed out after {_config.HttpTimeoutMs}ms");
         }
     }
 
-    public string HttpPost(string url, string dataJson)
+    public string HttpPost(string url, string dataJson) => HttpPostAsync(url, dataJson).GetAwaiter().GetResult();
+
+    public async Task<string> HttpPostAsync(string url, string dataJson, CancellationToken cancellationToken = default)
     {
         if (string.IsNullOrWhiteSpace(url)) throw new ArgumentException("URL cannot be null or empty");
 
-        using var request = new HttpRequestMessage(HttpMethod.Post, url);
+        using var request = CreateRequest(HttpMethod.Post, url);
         request.Content = new StringContent(dataJson, Encoding.UTF8, "application/json");
         ValidateRequest(request);
 
         try
         {
-            var response = _httpClient.SendAsync(request).GetAwaiter().GetResult();
+            var response = await _httpClient.SendAsync(request, cancellationToken).ConfigureAwait(false);
             response.EnsureSuccessStatusCode();
-            return ReadResponseWithLimitAsync(response).GetAwaiter().GetResult();
+            return await ReadResponseWithLimitAsync(response, cancellationToken).ConfigureAwait(false);
         }
         catch (HttpRequestException ex)
         {
             throw new InvalidOperationException($"HTTP POST request failed: {ex.Message}", ex);
         }
-        catch (TaskCanceledException)
+        catch (TaskCanceledException) when (!cancellationToken.IsCancellationRequested)
         {
             throw new TimeoutException($"HTTP POST request timed out after {_config.HttpTimeoutMs}ms");
         }
     }
 
-    public string HttpRequest(string optionsJson)
+    public string HttpRequest(string optionsJson) => HttpRequestAsync(optionsJson).GetAwaiter().GetResult();
+
+    public async Task<string> HttpRequestAsync(string optionsJson, CancellationToken cancellationToken = default)
     {
         try
         {
-            using var doc = JsonDocument.Parse(optionsJson);
-            var root = doc.RootElement;
-
-            var url = root.GetProperty("url").GetString()
-                ?? throw new ArgumentException("url is required");
-            var method = root.GetProperty("method").GetString()
-                ?? throw new ArgumentException("method is required");
+            var request = ParseRequestOptions(optionsJson);
+            ValidateRequest(request);
 
-            var request = new HttpRequestMessage(new HttpMethod(method.ToUpperInvariant()), url);
+            var response = await _httpClient.SendAsync(request, cancellationToken).ConfigureAwait(false);
+            var responseBody = await ReadResponseWithLimitAsync(response, cancellationToken).ConfigureAwait(false);
 
-            // Add custom headers if provided
-            if (root.TryGetProperty("headers", out var headersElement))
+            var result = new
             {
-                foreach (var header in headersElement.EnumerateObject())
-                {
-                    request.Headers.TryAddWithoutValidation(header.Name, header.Value.GetString());
-                }
-            }
+                status = (int)response.StatusCode,
+                headers = CollectHeaders(response),
+                body = responseBody
+            };
 
-            // Add body if provided
-            if (root.TryGetProperty("body", out var bodyElement))
-            {
-                var body = bodyElement.GetString();
-                if (!string.IsNullOrEmpty(body))
-                {
-                    request.Content = new StringContent(body, Encoding.UTF8, "application/json");
-                }
-            }
+            return JsonSerializer.Serialize(result);
+        }
+        catch (HttpRequestException ex)
+        {
+            throw new InvalidOperationException($"HTTP request failed: {ex.Message}", ex);
+        }
+        catch (TaskCanceledException) when (!cancellationToken.IsCancellationRequested)
+        {
+            throw new TimeoutException($"HTTP request timed out after {_config.HttpTimeoutMs}ms");
+        }
+        catch (JsonException ex)
+        {
+            throw new ArgumentException($"Invalid JSON in request options: {ex.Message}", ex);
+        }
+    }
 
+    public async Task<HostHttpStream> HttpOpenAsync(string optionsJson, CancellationToken cancellationToken = default)
+    {
+        try
+        {
+            using var request = ParseRequestOptions(optionsJson);
             ValidateRequest(request);
 
-            var response = _httpClient.SendAsync(request).GetAwaiter().GetResult();
-            var responseBody = ReadResponseWithLimitAsync(response).GetAwaiter().GetResult();
-
-            // Build response headers dictionary
-            var responseHeaders = new Dictionary<string, string>();
-            foreach (var header in response.Headers)
+            // Returns once the headers are in; the body is pulled chunk by chunk through the stream table
+            var response = await _httpClient.SendAsync(request, HttpCompletionOption.ResponseHeadersRead, cancellationToken)
+                .ConfigureAwait(false);
+            try
             {
-                responseHeaders[header.Key] = string.Join(", ", header.Value);
+                var body = await response.Content.ReadAsStreamAsync().ConfigureAwait(false);
+                return new HostHttpStream((int)response.StatusCode, CollectHeaders(response), body, response);
             }
-            foreach (var header in response.Content.Headers)
+            catch
             {
-                responseHeaders[header.Key] = string.Join(", ", header.Value);
+                response.Dispose();
+                throw;
             }
-
-            var result = new
-            {
-                status = (int)response.StatusCode,
-                headers = responseHeaders,
-                body = responseBody
-            };
-
-            return JsonSerializer.Serialize(result);
         }
         catch (HttpRequestException ex)
         {
             throw new InvalidOperationException($"HTTP request failed: {ex.Message}", ex);
         }
-        catch (TaskCanceledException)
+        catch (TaskCanceledException) when (!cancellationToken.IsCancellationRequested)
         {
             throw new TimeoutException($"HTTP request timed out after {_config.HttpTimeoutMs}ms");
         }
@@ -390,6 +433,58 @@ internal sealed class HostApiImpl : IHostApi
         }
     }
 
+    /// <summary>
+    /// Builds a request from the <c>{ url, method, headers, body }</c> options object of <c>http.request</c>.
+    /// </summary>
+    private HttpRequestMessage ParseRequestOptions(string optionsJson)
+    {
+        using var doc = JsonDocument.Parse(optionsJson);
+        var root = doc.RootElement;
+
+        var url = root.GetProperty("url").GetString()
+            ?? throw new ArgumentException("url is required");
+        var method = root.GetProperty("method").GetString()
+            ?? throw new ArgumentException("method is required");
+
+        var request = CreateRequest(new HttpMethod(method.ToUpperInvariant()), url);
+
+        // Add custom headers if provided
+        if (root.TryGetProperty("headers", out var headersElement))
+        {
+            foreach (var header in headersElement.EnumerateObject())
+            {
+                request.Headers.TryAddWithoutValidation(header.Name, header.Value.GetString());
+            }
+        }
+
+        // Add body if provided
+        if (root.TryGetProperty("body", out var bodyElement))
+        {
+            var body = bodyElement.GetString();
+            if (!string.IsNullOrEmpty(body))
+            {
+                request.Content = new StringContent(body, Encoding.UTF8, "application/json");
+            }
+        }
+
+        return request;
+    }
+
+    private static Dictionary<string, string> CollectHeaders(HttpResponseMessage response)
+    {
+        var responseHeaders = new Dictionary<string, string>();
+        foreach (var header in response.Headers)
+        {
+            responseHeaders[header.Key] = string.Join(", ", header.Value);
+        }
+        foreach (var header in response.Content.Headers)
+        {
+            responseHeaders[header.Key] = string.Join(", ", header.Value);
+        }
+
+        return responseHeaders;
+    }
+
     #endregion
 }
 
@@ -0,0 +1,228 @@
+using System.Text;
+using System.Threading;
+
+namespace ScriptBox.Core.HostApi;
+
+/// <summary>
+/// Open HTTP bodies and files of one script run, addressed by the integer handles the guest
+/// passes to <c>StreamRead</c>/<c>StreamClose</c>. Each read decodes at most the requested
+/// number of UTF-8 bytes, so peak memory is bounded by the chunk size rather than the payload.
+/// Disposing the table closes whatever the script left open.
+/// </summary>
+internal sealed class HostStreamTable : IDisposable
+{
+    private readonly Dictionary<int, Entry> _entries = new();
+    private readonly int _maxOpen;
+    private readonly int _maxChunkBytes;
+    private int _nextHandle;
+    private bool _disposed;
+
+    public HostStreamTable(int maxOpen, int maxChunkBytes)
+    {
+        _maxOpen = maxOpen;
+        _maxChunkBytes = maxChunkBytes;
+    }
+
+    /// <summary>
+    /// Takes ownership of <paramref name="stream"/> (and <paramref name="owner"/>, disposed with it).
+    /// </summary>
+    public int Add(Stream stream, IDisposable? owner = null)
+    {
+        lock (_entries)
+        {
+            if (_disposed || _entries.Count >= _maxOpen)
+            {
+                stream.Dispose();
+                owner?.Dispose();
+                throw new InvalidOperationException(_disposed
+                    ? "The script has finished"
+                    : $"Too many open streams (limit {_maxOpen})");
+            }
+
+            var handle = ++_nextHandle;
+            _entries[handle] = new Entry(stream, owner);
+            return handle;
+        }
+    }
+
+    /// <summary>
+    /// Reads up to <paramref name="maxBytes"/> bytes and returns them decoded, or null at the end of the stream.
+    /// </summary>
+    public string? Read(int handle, int maxBytes)
+    {
+        var entry = Begin(handle);
+        try
+        {
+            var chunk = ClampChunk(maxBytes);
+            var buffer = entry.GetBuffer(chunk);
+            var builder = new StringBuilder();
+            while (true)
+            {
+                var read = entry.Ended ? 0 : entry.Stream.Read(buffer, 0, chunk);
+                if (entry.Append(buffer, read, builder))
+                {
+                    return builder.Length > 0 ? builder.ToString() : null;
+                }
+            }
+        }
+        finally
+        {
+            entry.Reading = false;
+        }
+    }
+
+    public async Task<string?> ReadAsync(int handle, int maxBytes, CancellationToken cancellationToken)
+    {
+        var entry = Begin(handle);
+        try
+        {
+            var chunk = ClampChunk(maxBytes);
+            var buffer = entry.GetBuffer(chunk);
+            var builder = new StringBuilder();
+            while (true)
+            {
+                var read = entry.Ended
+                    ? 0
+                    : await entry.Stream.ReadAsync(buffer, 0, chunk, cancellationToken).ConfigureAwait(false);
+                if (entry.Append(buffer, read, builder))
+                {
+                    return builder.Length > 0 ? builder.ToString() : null;
+                }
+            }
+        }
+        finally
+        {
+            entry.Reading = false;
+        }
+    }
+
+    public bool Close(int handle)
+    {
+        Entry? entry;
+        lock (_entries)
+        {
+            if (!_entries.TryGetValue(handle, out entry))
+            {
+                return false;
+            }
+
+            _entries.Remove(handle);
+        }
+
+        entry.Dispose();
+        return true;
+    }
+
+    public void Dispose()
+    {
+        List<Entry> open;
+        lock (_entries)
+        {
+            if (_disposed)
+            {
+                return;
+            }
+
+            _disposed = true;
+            open = new List<Entry>(_entries.Values);
+            _entries.Clear();
+        }
+
+        foreach (var entry in open)
+        {
+            entry.Dispose();
+        }
+    }
+
+    private int ClampChunk(int maxBytes)
+    {
+        if (maxBytes <= 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxBytes), "Read size must be positive");
+        }
+
+        return Math.Min(maxBytes, _maxChunkBytes);
+    }
+
+    private Entry Begin(int handle)
+    {
+        lock (_entries)
+        {
+            if (!_entries.TryGetValue(handle, out var entry))
+            {
+                throw new InvalidOperationException($"Unknown stream handle: {handle}");
+            }
+
+            if (entry.Reading)
+            {
+                throw new InvalidOperationException($"A read is already in progress on stream {handle}");
+            }
+
+            entry.Reading = true;
+            return entry;
+        }
+    }
+
+    private sealed class Entry : IDisposable
+    {
+        private readonly IDisposable? _owner;
+        private readonly Decoder _decoder = new UTF8Encoding(false).GetDecoder();
+        private byte[]? _buffer;
+        private char[]? _chars;
+
+        public Entry(Stream stream, IDisposable? owner)
+        {
+            Stream = stream;
+            _owner = owner;
+        }
+
+        public Stream Stream { get; }
+
+        public bool Reading { get; set; }
+
+        public bool Ended { get; private set; }
+
+        public byte[] GetBuffer(int size)
+        {
+            if (_buffer is null || _buffer.Length < size)
+            {
+                _buffer = new byte[size];
+            }
+
+            return _buffer;
+        }
+
+        /// <summary>
+        /// Decodes <paramref name="count"/> bytes into <paramref name="builder"/>; zero means end of stream.
+        /// Returns true once there is something to hand back (or nothing more will come). A chunk that
+        /// ends inside a multi-byte character keeps reading, so the guest never sees half a character.
+        /// </summary>
+        public bool Append(byte[] buffer, int count, StringBuilder builder)
+        {
+            if (count == 0)
+            {
+                Ended = true;
+            }
+
+            var charCount = _decoder.GetCharCount(buffer, 0, count, flush: Ended);
+            if (charCount > 0)
+            {
+                if (_chars is null || _chars.Length < charCount)
+                {
+                    _chars = new char[Math.Max(charCount, buffer.Length)];
+                }
+
+                var written = _decoder.GetChars(buffer, 0, count, _chars, 0, flush: Ended);
+                builder.Append(_chars, 0, written);
+            }
+
+            return builder.Length > 0 || Ended;
+        }
+
+        public void Dispose()
+        {
+            Stream.Dispose();
+            _owner?.Dispose();
+        }
+    }
+}
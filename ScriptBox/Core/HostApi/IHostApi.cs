@@ -1,3 +1,5 @@
+using System.Threading;
+
 namespace ScriptBox.Core.HostApi;
 
 /// <summary>
@@ -30,6 +32,14 @@ internal interface IHostApi
     /// <returns>File contents as a string.</returns>
     string FileSystemReadFile(string path);
 
+    /// <summary>
+    /// Opens a file for chunked reading instead of loading it whole.
+    /// Path must be within the configured sandbox directory.
+    /// </summary>
+    /// <param name="path">Relative path to the file within the sandbox.</param>
+    /// <returns>A read-only stream owned by the caller.</returns>
+    Stream FileSystemOpenRead(string path);
+
     /// <summary>
     /// Writes a string to a file, creating parent directories if needed.
     /// Path must be within the configured sandbox directory.
@@ -91,4 +101,32 @@ internal interface IHostApi
     /// <param name="optionsJson">JSON object containing url, method, headers, and body.</param>
     /// <returns>JSON object containing status, headers, and body.</returns>
     string HttpRequest(string optionsJson);
+
+    /// <summary>
+    /// Asynchronous <see cref="HttpGet"/>, used for host calls made through <c>__host.bridgeAsync</c>.
+    /// </summary>
+    Task<string> HttpGetAsync(string url, CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Asynchronous <see cref="HttpPost"/>, used for host calls made through <c>__host.bridgeAsync</c>.
+    /// </summary>
+    Task<string> HttpPostAsync(string url, string dataJson, CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Asynchronous <see cref="HttpRequest"/>, used for host calls made through <c>__host.bridgeAsync</c>.
+    /// </summary>
+    Task<string> HttpRequestAsync(string optionsJson, CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Sends a request like <see cref="HttpRequest"/> but returns as soon as the response headers
+    /// arrive, leaving the body unread. The body is not subject to the response size limit.
+    /// </summary>
+    /// <param name="optionsJson">JSON object containing url, method, headers, and body.</param>
+    /// <returns>Status, headers and the open body; disposing the response releases the connection.</returns>
+    Task<HostHttpStream> HttpOpenAsync(string optionsJson, CancellationToken cancellationToken = default);
 }
+
+/// <summary>
+/// An HTTP response whose body has not been read yet.
+/// </summary>
+internal sealed record HostHttpStream(int Status, Dictionary<string, string> Headers, Stream Body, HttpResponseMessage Response);
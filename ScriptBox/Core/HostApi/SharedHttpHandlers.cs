@@ -0,0 +1,128 @@
+using System.Collections.Concurrent;
+#if NET6_0_OR_GREATER
+using System.Net.Sockets;
+#endif
+using ScriptBox.Core.Configuration;
+
+namespace ScriptBox.Core.HostApi;
+
+/// <summary>
+/// Connection reuse counters for one shared HTTP handler.
+/// </summary>
+/// <param name="Requests">Requests sent through the handler.</param>
+/// <param name="ConnectionsOpened">TCP connections the handler opened. Only tracked on .NET 6 and later; 0 elsewhere.</param>
+public readonly record struct HttpConnectionMetrics(long Requests, long ConnectionsOpened)
+{
+    /// <summary>
+    /// Requests served on an already open connection.
+    /// </summary>
+    public long ReusedRequests => Math.Max(0, Requests - ConnectionsOpened);
+}
+
+/// <summary>
+/// Process-wide HTTP handlers for <see cref="SandboxConfiguration.SharedHttpHandler"/>,
+/// one per distinct set of <see cref="SharedHttpHandlerOptions"/>. The handlers live for the
+/// whole process; HttpClients created over them must not dispose them.
+/// </summary>
+public static class SharedHttpHandlers
+{
+    private static readonly ConcurrentDictionary<HandlerKey, Lazy<CountingHandler>> _handlers = new();
+
+    /// <summary>
+    /// Returns the connection reuse counters of the handler for <paramref name="options"/>,
+    /// or zeros if no request has created it yet.
+    /// </summary>
+    public static HttpConnectionMetrics GetMetrics(SharedHttpHandlerOptions options)
+    {
+        if (options is null)
+        {
+            throw new ArgumentNullException(nameof(options));
+        }
+
+        return _handlers.TryGetValue(HandlerKey.From(options), out var handler) && handler.IsValueCreated
+            ? handler.Value.Snapshot()
+            : default;
+    }
+
+    internal static HttpMessageHandler Get(SharedHttpHandlerOptions options)
+    {
+        options.Validate();
+        var key = HandlerKey.From(options);
+        return _handlers.GetOrAdd(key, k => new Lazy<CountingHandler>(() => new CountingHandler(k))).Value;
+    }
+
+    private readonly record struct HandlerKey(
+        int MaxConnectionsPerServer,
+        TimeSpan PooledConnectionLifetime,
+        TimeSpan PooledConnectionIdleTimeout,
+        bool EnableHttp2)
+    {
+        public static HandlerKey From(SharedHttpHandlerOptions options) => new(
+            options.MaxConnectionsPerServer,
+            options.PooledConnectionLifetime,
+            options.PooledConnectionIdleTimeout,
+            options.EnableHttp2);
+    }
+
+    private sealed class CountingHandler : DelegatingHandler
+    {
+        private long _requests;
+        private long _connections;
+
+        public CountingHandler(HandlerKey key)
+        {
+            InnerHandler = CreateInnerHandler(key);
+        }
+
+        public HttpConnectionMetrics Snapshot() =>
+            new(Interlocked.Read(ref _requests), Interlocked.Read(ref _connections));
+
+        protected override Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken cancellationToken)
+        {
+            Interlocked.Increment(ref _requests);
+            return base.SendAsync(request, cancellationToken);
+        }
+
+        // Shared for the life of the process, so never torn down by an HttpClient
+        protected override void Dispose(bool disposing)
+        {
+        }
+
+        private HttpMessageHandler CreateInnerHandler(HandlerKey key)
+        {
+#if NET6_0_OR_GREATER
+            return new SocketsHttpHandler
+            {
+                MaxConnectionsPerServer = key.MaxConnectionsPerServer,
+                PooledConnectionLifetime = key.PooledConnectionLifetime,
+                PooledConnectionIdleTimeout = key.PooledConnectionIdleTimeout,
+                EnableMultipleHttp2Connections = key.EnableHttp2,
+                ConnectCallback = ConnectAsync
+            };
+#else
+            return new HttpClientHandler
+            {
+                MaxConnectionsPerServer = key.MaxConnectionsPerServer
+            };
+#endif
+        }
+
+#if NET6_0_OR_GREATER
+        private async ValueTask<Stream> ConnectAsync(SocketsHttpConnectionContext context, CancellationToken cancellationToken)
+        {
+            var socket = new Socket(SocketType.Stream, ProtocolType.Tcp) { NoDelay = true };
+            try
+            {
+                await socket.ConnectAsync(context.DnsEndPoint, cancellationToken).ConfigureAwait(false);
+                Interlocked.Increment(ref _connections);
+                return new NetworkStream(socket, ownsSocket: true);
+            }
+            catch
+            {
+                socket.Dispose();
+                throw;
+            }
+        }
+#endif
+    }
+}
@@ -1,5 +1,5 @@
 using System.Diagnostics.CodeAnalysis;
-using System.Globalization;
+using System.Linq.Expressions;
 using System.Reflection;
 using System.Text;
 using System.Text.Json;
@@ -13,28 +13,44 @@ internal static class AttributedSandboxApiRegistry
         var sb = new StringBuilder();
         foreach (var api in apis)
         {
-            if (api.Methods.Count == 0)
-            {
-                continue;
-            }
+            sb.Append(BuildApiBootstrap(api.JsNamespace, api.Methods.Select(m => m.JsMethodName)));
+        }
 
-            sb.AppendLine("(function(root){");
-            sb.AppendLine("  if (typeof __scriptbox === 'undefined') {");
-            sb.AppendLine("    throw new Error('Missing __scriptbox helper.');");
-            sb.AppendLine("  }");
-            sb.AppendLine("  var api = {};");
-            foreach (var method in api.Methods)
+        return sb.ToString();
+    }
+
+    /// <summary>
+    /// Builds the JS proxy object for one API. The source generator emits the same proxy at
+    /// compile time (<see cref="GeneratedSandboxApi.Bootstrap"/>); keep the two in sync.
+    /// </summary>
+    public static string BuildApiBootstrap(string jsNamespace, IEnumerable<string> jsMethodNames)
+    {
+        var sb = new StringBuilder();
+        foreach (var jsMethodName in jsMethodNames)
+        {
+            if (sb.Length == 0)
             {
-                sb.AppendLine($"  api.{method.JsMethodName} = __scriptbox.createMethod('{method.HostMethodName}');");
+                sb.AppendLine("(function(root){");
+                sb.AppendLine("  if (typeof __scriptbox === 'undefined') {");
+                sb.AppendLine("    throw new Error('Missing __scriptbox helper.');");
+                sb.AppendLine("  }");
+                sb.AppendLine("  var api = {};");
             }
-            sb.AppendLine($"  root.{api.JsNamespace} = api;");
-            sb.Append("})(");
-            sb.Append("typeof globalThis !== 'undefined' ? globalThis : ");
-            sb.Append("typeof global !== 'undefined' ? global : ");
-            sb.Append("typeof self !== 'undefined' ? self : this");
-            sb.AppendLine(");");
+
+            sb.AppendLine($"  api.{jsMethodName} = __scriptbox.createMethod('{jsNamespace}.{jsMethodName}');");
         }
 
+        if (sb.Length == 0)
+        {
+            return string.Empty;
+        }
+
+        sb.AppendLine($"  root.{jsNamespace} = api;");
+        sb.Append("})(");
+        sb.Append("typeof globalThis !== 'undefined' ? globalThis : ");
+        sb.Append("typeof global !== 'undefined' ? global : ");
+        sb.Append("typeof self !== 'undefined' ? self : this");
+        sb.AppendLine(");");
         return sb.ToString();
     }
 
@@ -63,6 +79,31 @@ internal static class AttributedSandboxApiRegistry
         }
     }
 
+    /// <summary>
+    /// Registers the handlers of a source-generated API under <paramref name="jsNamespace"/>.
+    /// </summary>
+    public static void RegisterGeneratedHandlers(
+        GeneratedSandboxApi api,
+        string jsNamespace,
+        object? instance,
+        HostApiBuilder builder)
+    {
+        foreach (var method in api.Methods)
+        {
+            var hostMethodName = $"{jsNamespace}.{method.JsMethodName}";
+            builder.RegisterJsonHandler(hostMethodName, ctx =>
+            {
+                if (ctx.ArgumentCount < method.ArgumentCount)
+                {
+                    return Task.FromException<object?>(new InvalidOperationException(
+                        $"Not enough arguments supplied for method '{hostMethodName}'. Expected {method.ParameterCount}"));
+                }
+
+                return method.Invoke(instance, new GeneratedSandboxArguments(ctx));
+            });
+        }
+    }
+
     private static object? DefaultInstanceFactory(Type type)
     {
         var instance = Activator.CreateInstance(type);
@@ -78,11 +119,77 @@ internal static class AttributedSandboxApiRegistry
         SandboxMethodDescriptor descriptor,
         object? target)
     {
-        return async ctx =>
+        if (!CanCompileInvoker(descriptor.Method))
         {
-            var arguments = BindArguments(descriptor, ctx);
-            var result = descriptor.Method.Invoke(target, arguments);
-            return await UnwrapResultAsync(result);
+            return async ctx =>
+            {
+                var arguments = BindArguments(descriptor, ctx);
+                var result = descriptor.Method.Invoke(target, arguments);
+                return await UnwrapResultAsync(result).ConfigureAwait(false);
+            };
+        }
+
+        var invoke = CompileInvoker(descriptor, target);
+        return async ctx => await UnwrapResultAsync(invoke(ctx)).ConfigureAwait(false);
+    }
+
+    private static bool CanCompileInvoker(MethodInfo method)
+    {
+        return !method.ContainsGenericParameters &&
+               method.GetParameters().All(p => !p.ParameterType.IsByRef && !p.ParameterType.IsPointer);
+    }
+
+    /// <summary>
+    /// Compiles a delegate that binds every parameter with <see cref="HostArgumentBinder.Bind{T}"/>
+    /// and calls the method directly, instead of <see cref="MethodBase.Invoke(object, object[])"/>
+    /// with an array of boxed arguments.
+    /// </summary>
+    private static Func<HostCallContext, object?> CompileInvoker(SandboxMethodDescriptor descriptor, object? target)
+    {
+        var method = descriptor.Method;
+        var parameters = method.GetParameters();
+        var context = Expression.Parameter(typeof(HostCallContext), "ctx");
+        var arguments = new Expression[parameters.Length];
+        var argCount = 0;
+
+        for (int i = 0; i < parameters.Length; i++)
+        {
+            var parameterType = parameters[i].ParameterType;
+            if (parameterType == typeof(HostCallContext))
+            {
+                arguments[i] = context;
+            }
+            else if (parameterType == typeof(CancellationToken))
+            {
+                arguments[i] = Expression.Property(context, nameof(HostCallContext.CancellationToken));
+            }
+            else
+            {
+                arguments[i] = Expression.Call(
+                    typeof(HostArgumentBinder),
+                    nameof(HostArgumentBinder.Bind),
+                    new[] { parameterType },
+                    context,
+                    Expression.Constant(argCount++));
+            }
+        }
+
+        var instance = method.IsStatic ? null : Expression.Constant(target, method.DeclaringType!);
+        Expression call = Expression.Call(instance, method, arguments);
+        Expression body = method.ReturnType == typeof(void)
+            ? Expression.Block(call, Expression.Constant(null, typeof(object)))
+            : Expression.Convert(call, typeof(object));
+        var invoker = Expression.Lambda<Func<HostCallContext, object?>>(body, context).Compile();
+
+        return ctx =>
+        {
+            if (ctx.ArgumentCount < argCount)
+            {
+                throw new InvalidOperationException(
+                    $"Not enough arguments supplied for method '{descriptor.HostMethodName}'. Expected {parameters.Length}");
+            }
+
+            return invoker(ctx);
         };
     }
 
@@ -114,43 +221,12 @@ internal static class AttributedSandboxApiRegistry
             }
 
             var raw = ctx.Arguments[argIndex++];
-            values[i] = ConvertValue(raw, parameter.ParameterType);
+            values[i] = HostArgumentBinder.ConvertValue(raw, parameter.ParameterType);
         }
 
         return values;
     }
 
-    private static object? ConvertValue(object? raw, Type targetType)
-    {
-        if (raw is null)
-        {
-            return targetType.IsValueType ? Activator.CreateInstance(targetType) : null;
-        }
-
-        if (targetType.IsInstanceOfType(raw))
-        {
-            return raw;
-        }
-
-        if (raw is JsonElement element)
-        {
-            var json = element.GetRawText();
-            return JsonSerializer.Deserialize(json, targetType);
-        }
-
-        if (targetType.IsEnum)
-        {
-            if (raw is string enumName)
-            {
-                return Enum.Parse(targetType, enumName, ignoreCase: true);
-            }
-
-            return Enum.ToObject(targetType, raw);
-        }
-
-        return Convert.ChangeType(raw, targetType, CultureInfo.InvariantCulture);
-    }
-
     private static async Task<object?> UnwrapResultAsync(object? result)
     {
         switch (result)
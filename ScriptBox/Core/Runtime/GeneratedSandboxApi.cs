@@ -0,0 +1,110 @@
+using System;
+using System.Collections.Generic;
+using System.ComponentModel;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ScriptBox.Core.Runtime;
+
+/// <summary>
+/// Bindings emitted by the ScriptBox source generator for a <see cref="SandboxApiAttribute"/> type.
+/// The generated module initializer registers them with <see cref="GeneratedSandboxApiRegistry"/>,
+/// and <see cref="ScriptBoxBuilder"/> uses them instead of scanning the type with reflection.
+/// </summary>
+[EditorBrowsable(EditorBrowsableState.Never)]
+public sealed class GeneratedSandboxApi
+{
+    public GeneratedSandboxApi(
+        Type apiType,
+        string jsNamespace,
+        bool requiresInstance,
+        Func<object>? createInstance,
+        IReadOnlyList<GeneratedSandboxMethod> methods,
+        string bootstrap)
+    {
+        ApiType = apiType ?? throw new ArgumentNullException(nameof(apiType));
+        JsNamespace = jsNamespace ?? throw new ArgumentNullException(nameof(jsNamespace));
+        RequiresInstance = requiresInstance;
+        CreateInstance = createInstance;
+        Methods = methods ?? throw new ArgumentNullException(nameof(methods));
+        Bootstrap = bootstrap ?? string.Empty;
+    }
+
+    public Type ApiType { get; }
+
+    /// <summary>
+    /// The namespace from <see cref="SandboxApiAttribute"/>.
+    /// </summary>
+    public string JsNamespace { get; }
+
+    public bool RequiresInstance { get; }
+
+    /// <summary>
+    /// Calls the public parameterless constructor, or null when the type has none.
+    /// </summary>
+    public Func<object>? CreateInstance { get; }
+
+    public IReadOnlyList<GeneratedSandboxMethod> Methods { get; }
+
+    /// <summary>
+    /// The JS proxy for <see cref="JsNamespace"/>, emitted at compile time.
+    /// </summary>
+    public string Bootstrap { get; }
+}
+
+/// <summary>
+/// A generated handler for one <see cref="SandboxMethodAttribute"/> method.
+/// </summary>
+[EditorBrowsable(EditorBrowsableState.Never)]
+public sealed class GeneratedSandboxMethod
+{
+    public GeneratedSandboxMethod(
+        string jsMethodName,
+        int argumentCount,
+        int parameterCount,
+        Func<object?, GeneratedSandboxArguments, Task<object?>> invoke)
+    {
+        JsMethodName = jsMethodName ?? throw new ArgumentNullException(nameof(jsMethodName));
+        ArgumentCount = argumentCount;
+        ParameterCount = parameterCount;
+        Invoke = invoke ?? throw new ArgumentNullException(nameof(invoke));
+    }
+
+    public string JsMethodName { get; }
+
+    /// <summary>
+    /// Number of arguments the script must pass (parameters other than the cancellation token).
+    /// </summary>
+    public int ArgumentCount { get; }
+
+    public int ParameterCount { get; }
+
+    /// <summary>
+    /// Calls the method on the API instance (null for static methods).
+    /// </summary>
+    public Func<object?, GeneratedSandboxArguments, Task<object?>> Invoke { get; }
+}
+
+/// <summary>
+/// The arguments of a host call as seen by generated handlers.
+/// </summary>
+[EditorBrowsable(EditorBrowsableState.Never)]
+public readonly struct GeneratedSandboxArguments
+{
+    private readonly HostCallContext _context;
+
+    internal GeneratedSandboxArguments(HostCallContext context)
+    {
+        _context = context;
+    }
+
+    public int Count => _context.ArgumentCount;
+
+    public CancellationToken CancellationToken => _context.CancellationToken;
+
+    /// <summary>
+    /// Converts argument <paramref name="index"/> to <typeparamref name="T"/> the same way
+    /// reflection-bound handlers do.
+    /// </summary>
+    public T Get<T>(int index) => HostArgumentBinder.Bind<T>(_context, index);
+}
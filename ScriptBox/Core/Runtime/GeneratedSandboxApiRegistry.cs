@@ -0,0 +1,31 @@
+using System;
+using System.Collections.Concurrent;
+using System.ComponentModel;
+using System.Diagnostics.CodeAnalysis;
+
+namespace ScriptBox.Core.Runtime;
+
+/// <summary>
+/// Process-wide table of source-generated API bindings, filled by module initializers
+/// in the assemblies that declare <see cref="SandboxApiAttribute"/> types.
+/// </summary>
+[EditorBrowsable(EditorBrowsableState.Never)]
+public static class GeneratedSandboxApiRegistry
+{
+    private static readonly ConcurrentDictionary<Type, GeneratedSandboxApi> _apis = new();
+
+    public static void Register(GeneratedSandboxApi api)
+    {
+        if (api is null)
+        {
+            throw new ArgumentNullException(nameof(api));
+        }
+
+        _apis[api.ApiType] = api;
+    }
+
+    internal static bool TryGet(Type type, [NotNullWhen(true)] out GeneratedSandboxApi? api)
+    {
+        return _apis.TryGetValue(type, out api);
+    }
+}
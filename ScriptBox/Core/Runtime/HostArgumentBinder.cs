@@ -0,0 +1,80 @@
+using System;
+using System.Globalization;
+using System.Text.Json;
+
+namespace ScriptBox.Core.Runtime;
+
+/// <summary>
+/// Converts host call arguments to handler parameter types.
+/// <see cref="Bind{T}"/> is called from the compiled invokers of attributed API methods; for
+/// binary calls it reads <see cref="int"/>, <see cref="long"/>, <see cref="double"/>,
+/// <see cref="bool"/> and <see cref="string"/> straight from the payload without boxing.
+/// </summary>
+internal static class HostArgumentBinder
+{
+    public static T Bind<T>(HostCallContext context, int index)
+    {
+        if (context.TryGetBinaryArgument(index, out var reader))
+        {
+            if (typeof(T) == typeof(int) && reader.TryReadInt64(out var int32))
+            {
+                return (T)(object)checked((int)int32);
+            }
+
+            if (typeof(T) == typeof(long) && reader.TryReadInt64(out var int64))
+            {
+                return (T)(object)int64;
+            }
+
+            if (typeof(T) == typeof(double) && reader.TryReadDouble(out var number))
+            {
+                return (T)(object)number;
+            }
+
+            if (typeof(T) == typeof(bool) && reader.TryReadBoolean(out var boolean))
+            {
+                return (T)(object)boolean;
+            }
+
+            if (typeof(T) == typeof(string) && reader.TryReadString(out var text))
+            {
+                return (T)(object)text!;
+            }
+
+            return (T)ConvertValue(reader.ReadObject(), typeof(T))!;
+        }
+
+        return (T)ConvertValue(context.Arguments[index], typeof(T))!;
+    }
+
+    public static object? ConvertValue(object? raw, Type targetType)
+    {
+        if (raw is null)
+        {
+            return targetType.IsValueType ? Activator.CreateInstance(targetType) : null;
+        }
+
+        if (targetType.IsInstanceOfType(raw))
+        {
+            return raw;
+        }
+
+        if (raw is JsonElement element)
+        {
+            var json = element.GetRawText();
+            return JsonSerializer.Deserialize(json, targetType);
+        }
+
+        if (targetType.IsEnum)
+        {
+            if (raw is string enumName)
+            {
+                return Enum.Parse(targetType, enumName, ignoreCase: true);
+            }
+
+            return Enum.ToObject(targetType, raw);
+        }
+
+        return Convert.ChangeType(raw, targetType, CultureInfo.InvariantCulture);
+    }
+}
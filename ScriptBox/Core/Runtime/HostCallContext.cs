@@ -10,6 +10,14 @@ namespace ScriptBox.Core.Runtime;
 /// </summary>
 internal sealed class HostCallContext
 {
+    private static readonly IReadOnlyDictionary<string, object?> NoParameters =
+        new Dictionary<string, object?>(StringComparer.OrdinalIgnoreCase);
+
+    // Binary calls keep the encoded arguments and only box them when Arguments is read
+    private readonly byte[]? _binaryArguments;
+    private readonly int[]? _argumentOffsets;
+    private IReadOnlyList<object?>? _arguments;
+
     private HostCallContext(
         string method,
         IReadOnlyList<object?> arguments,
@@ -17,17 +25,80 @@ internal sealed class HostCallContext
         CancellationToken cancellationToken)
     {
         Method = method;
-        Arguments = arguments;
+        _arguments = arguments;
         Params = parameters;
         CancellationToken = cancellationToken;
     }
 
+    private HostCallContext(
+        string method,
+        byte[] binaryArguments,
+        int[] argumentOffsets,
+        CancellationToken cancellationToken)
+    {
+        Method = method;
+        _binaryArguments = binaryArguments;
+        _argumentOffsets = argumentOffsets;
+        Params = NoParameters;
+        CancellationToken = cancellationToken;
+    }
+
     public string Method { get; }
-    public IReadOnlyList<object?> Arguments { get; }
+    public IReadOnlyList<object?> Arguments => _arguments ??= DecodeBinaryArguments();
     public IReadOnlyList<object?> Args => Arguments;
     public IReadOnlyDictionary<string, object?> Params { get; }
     public CancellationToken CancellationToken { get; }
 
+    public int ArgumentCount => _argumentOffsets?.Length ?? Arguments.Count;
+
+    /// <summary>
+    /// Positions a reader on argument <paramref name="index"/> of a binary call, so typed
+    /// binders read it without boxing. Returns false for JSON calls.
+    /// </summary>
+    internal bool TryGetBinaryArgument(int index, out MessagePackReader reader)
+    {
+        if (_argumentOffsets is null)
+        {
+            reader = default;
+            return false;
+        }
+
+        reader = new MessagePackReader(_binaryArguments!, _argumentOffsets[index]);
+        return true;
+    }
+
+    /// <summary>
+    /// Wraps the arguments array of a binary host call that starts at <paramref name="argsOffset"/>
+    /// in <paramref name="payload"/>. Only the element offsets are read up front.
+    /// </summary>
+    internal static HostCallContext FromMessagePack(
+        string method,
+        byte[] payload,
+        int argsOffset,
+        CancellationToken cancellationToken)
+    {
+        var reader = new MessagePackReader(payload, argsOffset);
+        var offsets = new int[reader.ReadArrayHeader()];
+        for (var i = 0; i < offsets.Length; i++)
+        {
+            offsets[i] = reader.Position;
+            reader.Skip();
+        }
+
+        return new HostCallContext(method, payload, offsets, cancellationToken);
+    }
+
+    private IReadOnlyList<object?> DecodeBinaryArguments()
+    {
+        var values = new object?[_argumentOffsets!.Length];
+        for (var i = 0; i < values.Length; i++)
+        {
+            values[i] = new MessagePackReader(_binaryArguments!, _argumentOffsets[i]).ReadObject();
+        }
+
+        return values;
+    }
+
     internal static HostCallContext FromJson(
         string method,
         JsonElement root,
@@ -0,0 +1,94 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Text.Json;
+using System.Threading.Tasks;
+
+namespace ScriptBox.Core.Runtime;
+
+/// <summary>
+/// Numeric IDs for the registered host handlers, fixed when the executor is built.
+/// The IDs are emitted into the bootstrap so the guest sends <c>{"id":N,"args":[...]}</c>
+/// and the host indexes an array instead of hashing the method name on every call.
+/// IDs follow the ordinal order of the names, so the same handlers always get the same IDs.
+/// </summary>
+internal sealed class HostMethodTable
+{
+    private readonly string[] _names;
+    private readonly Func<HostCallContext, Task<object?>>[] _handlers;
+
+    private HostMethodTable(string[] names, Func<HostCallContext, Task<object?>>[] handlers)
+    {
+        _names = names;
+        _handlers = handlers;
+    }
+
+    public int Count => _names.Length;
+
+    public static HostMethodTable Create(IReadOnlyDictionary<string, Func<HostCallContext, Task<object?>>> handlers)
+    {
+        if (handlers is null)
+        {
+            throw new ArgumentNullException(nameof(handlers));
+        }
+
+        var names = handlers.Keys.OrderBy(name => name, StringComparer.Ordinal).ToArray();
+        var table = new Func<HostCallContext, Task<object?>>[names.Length];
+        for (var i = 0; i < names.Length; i++)
+        {
+            table[i] = handlers[names[i]];
+        }
+
+        return new HostMethodTable(names, table);
+    }
+
+    /// <summary>
+    /// Resolves a method ID sent by the guest.
+    /// </summary>
+    public bool TryGet(int id, out string name, out Func<HostCallContext, Task<object?>> handler)
+    {
+        if ((uint)id >= (uint)_names.Length)
+        {
+            name = string.Empty;
+            handler = null!;
+            return false;
+        }
+
+        name = _names[id];
+        handler = _handlers[id];
+        return true;
+    }
+
+    /// <summary>
+    /// Builds the startup segment that hands the table to <c>__scriptbox.registerMethodIds</c>.
+    /// Keys are lower-cased because host method names are case-insensitive.
+    /// Returns an empty string when no handlers are registered.
+    /// </summary>
+    /// <param name="binaryHostCalls">Tell the SDK to call these methods through <c>__host.bridgeBinary</c>.</param>
+    public string BuildBootstrap(bool binaryHostCalls = false)
+    {
+        if (_names.Length == 0)
+        {
+            return string.Empty;
+        }
+
+        var sb = new StringBuilder();
+        sb.Append("if (typeof __scriptbox !== 'undefined' && typeof __scriptbox.registerMethodIds === 'function') {\n");
+        sb.Append("  __scriptbox.registerMethodIds({");
+        for (var i = 0; i < _names.Length; i++)
+        {
+            if (i > 0)
+            {
+                sb.Append(',');
+            }
+
+            sb.Append(JsonSerializer.Serialize(_names[i].ToLowerInvariant()));
+            sb.Append(':');
+            sb.Append(i);
+        }
+
+        sb.Append(binaryHostCalls ? "}, { binary: true });\n}\n" : "});\n}\n");
+        return sb.ToString();
+    }
+}
@@ -0,0 +1,345 @@
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace ScriptBox.Core.Runtime;
+
+/// <summary>
+/// Reads the MessagePack subset used by binary host calls (<c>__host.bridgeBinary</c>):
+/// nil, bool, integers, float64, str, array and maps with string keys.
+/// Values decode to the same types as JSON host calls: <see cref="long"/>, <see cref="double"/>,
+/// <see cref="string"/>, <see cref="bool"/>, lists and case-insensitive dictionaries.
+/// </summary>
+internal struct MessagePackReader
+{
+    private const int MaxDepth = 64;
+
+    private readonly byte[] _buffer;
+    private int _position;
+
+    public MessagePackReader(byte[] buffer, int position)
+    {
+        _buffer = buffer ?? throw new ArgumentNullException(nameof(buffer));
+        _position = position;
+    }
+
+    public int Position => _position;
+
+    public bool TryReadNil()
+    {
+        if (Peek() != 0xc0)
+        {
+            return false;
+        }
+
+        _position++;
+        return true;
+    }
+
+    /// <summary>
+    /// Reads an integer; leaves the reader unchanged and returns false for any other type.
+    /// </summary>
+    public bool TryReadInt64(out long value)
+    {
+        var code = Peek();
+        if (code <= 0x7f)
+        {
+            _position++;
+            value = code;
+            return true;
+        }
+
+        if (code >= 0xe0)
+        {
+            _position++;
+            value = (sbyte)code;
+            return true;
+        }
+
+        switch (code)
+        {
+            case 0xcc: _position++; value = (long)ReadBigEndian(1); return true;
+            case 0xcd: _position++; value = (long)ReadBigEndian(2); return true;
+            case 0xce: _position++; value = (long)ReadBigEndian(4); return true;
+            case 0xcf:
+                _position++;
+                value = checked((long)ReadBigEndian(8));
+                return true;
+            case 0xd0: _position++; value = (sbyte)ReadBigEndian(1); return true;
+            case 0xd1: _position++; value = (short)ReadBigEndian(2); return true;
+            case 0xd2: _position++; value = (int)ReadBigEndian(4); return true;
+            case 0xd3: _position++; value = (long)ReadBigEndian(8); return true;
+            default:
+                value = 0;
+                return false;
+        }
+    }
+
+    /// <summary>
+    /// Reads a float64 or an integer as a double; returns false for any other type.
+    /// </summary>
+    public bool TryReadDouble(out double value)
+    {
+        if (Peek() == 0xcb)
+        {
+            _position++;
+            value = BitConverter.Int64BitsToDouble((long)ReadBigEndian(8));
+            return true;
+        }
+
+        if (TryReadInt64(out var integer))
+        {
+            value = integer;
+            return true;
+        }
+
+        value = 0;
+        return false;
+    }
+
+    public bool TryReadBoolean(out bool value)
+    {
+        var code = Peek();
+        if (code != 0xc2 && code != 0xc3)
+        {
+            value = false;
+            return false;
+        }
+
+        _position++;
+        value = code == 0xc3;
+        return true;
+    }
+
+    /// <summary>
+    /// Reads a str; nil reads as null. Returns false for any other type.
+    /// </summary>
+    public bool TryReadString(out string? value)
+    {
+        if (TryReadNil())
+        {
+            value = null;
+            return true;
+        }
+
+        if (!TryReadStringLength(out var length))
+        {
+            value = null;
+            return false;
+        }
+
+        value = Encoding.UTF8.GetString(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    public int ReadArrayHeader()
+    {
+        var code = ReadByte();
+        var count = code switch
+        {
+            >= 0x90 and <= 0x9f => code & 0x0f,
+            0xdc => (long)ReadBigEndian(2),
+            0xdd => (long)ReadBigEndian(4),
+            _ => throw Malformed(code)
+        };
+
+        // Every element takes at least one byte
+        return count <= _buffer.Length - _position
+            ? (int)count
+            : throw new FormatException("MessagePack array is longer than its payload");
+    }
+
+    public int ReadMapHeader()
+    {
+        var code = ReadByte();
+        var count = code switch
+        {
+            >= 0x80 and <= 0x8f => code & 0x0f,
+            0xde => (long)ReadBigEndian(2),
+            0xdf => (long)ReadBigEndian(4),
+            _ => throw Malformed(code)
+        };
+
+        // Every entry takes at least two bytes
+        return count <= (_buffer.Length - _position) / 2
+            ? (int)count
+            : throw new FormatException("MessagePack map is longer than its payload");
+    }
+
+    /// <summary>
+    /// Reads any value into the object model used by <see cref="HostCallContext.Arguments"/>.
+    /// </summary>
+    public object? ReadObject() => ReadObject(0);
+
+    /// <summary>
+    /// Advances past the next value without materializing it.
+    /// </summary>
+    public void Skip() => Skip(0);
+
+    private object? ReadObject(int depth)
+    {
+        if (depth > MaxDepth)
+        {
+            throw new FormatException("MessagePack value nested too deeply");
+        }
+
+        if (TryReadNil())
+        {
+            return null;
+        }
+
+        if (TryReadBoolean(out var boolean))
+        {
+            return boolean;
+        }
+
+        if (TryReadInt64(out var integer))
+        {
+            return integer;
+        }
+
+        if (TryReadDouble(out var number))
+        {
+            return number;
+        }
+
+        if (TryReadString(out var text))
+        {
+            return text;
+        }
+
+        var code = Peek();
+        if (code is (>= 0x90 and <= 0x9f) or 0xdc or 0xdd)
+        {
+            var count = ReadArrayHeader();
+            var list = new List<object?>(count);
+            for (var i = 0; i < count; i++)
+            {
+                list.Add(ReadObject(depth + 1));
+            }
+
+            return list;
+        }
+
+        if (code is (>= 0x80 and <= 0x8f) or 0xde or 0xdf)
+        {
+            var count = ReadMapHeader();
+            var map = new Dictionary<string, object?>(count, StringComparer.OrdinalIgnoreCase);
+            for (var i = 0; i < count; i++)
+            {
+                if (!TryReadString(out var key) || key is null)
+                {
+                    throw new FormatException("MessagePack map keys must be strings");
+                }
+
+                map[key] = ReadObject(depth + 1);
+            }
+
+            return map;
+        }
+
+        throw Malformed(code);
+    }
+
+    private void Skip(int depth)
+    {
+        if (depth > MaxDepth)
+        {
+            throw new FormatException("MessagePack value nested too deeply");
+        }
+
+        if (TryReadNil() || TryReadBoolean(out _) || TryReadDouble(out _))
+        {
+            return;
+        }
+
+        if (TryReadStringLength(out var length))
+        {
+            _position += length;
+            return;
+        }
+
+        var code = Peek();
+        if (code is (>= 0x90 and <= 0x9f) or 0xdc or 0xdd)
+        {
+            var count = ReadArrayHeader();
+            for (var i = 0; i < count; i++)
+            {
+                Skip(depth + 1);
+            }
+
+            return;
+        }
+
+        var entries = ReadMapHeader();
+        for (var i = 0; i < entries * 2; i++)
+        {
+            Skip(depth + 1);
+        }
+    }
+
+    private bool TryReadStringLength(out int length)
+    {
+        var code = Peek();
+        long value;
+        if (code is >= 0xa0 and <= 0xbf)
+        {
+            _position++;
+            value = code & 0x1f;
+        }
+        else if (code is 0xd9 or 0xda or 0xdb)
+        {
+            _position++;
+            value = (long)ReadBigEndian(1 << (code - 0xd9));
+        }
+        else
+        {
+            length = 0;
+            return false;
+        }
+
+        if (value > _buffer.Length - _position)
+        {
+            throw new FormatException("MessagePack string is longer than its payload");
+        }
+
+        length = (int)value;
+        return true;
+    }
+
+    private byte Peek()
+    {
+        return _position < _buffer.Length
+            ? _buffer[_position]
+            : throw new FormatException("Unexpected end of MessagePack payload");
+    }
+
+    private byte ReadByte()
+    {
+        var value = Peek();
+        _position++;
+        return value;
+    }
+
+    private ulong ReadBigEndian(int size)
+    {
+        if (_buffer.Length - _position < size)
+        {
+            throw new FormatException("Unexpected end of MessagePack payload");
+        }
+
+        ulong value = 0;
+        for (var i = 0; i < size; i++)
+        {
+            value = (value << 8) | _buffer[_position++];
+        }
+
+        return value;
+    }
+
+    private static FormatException Malformed(byte code)
+    {
+        return new FormatException($"Unsupported MessagePack type 0x{code:x2}");
+    }
+}
@@ -0,0 +1,287 @@
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Text;
+using System.Text.Json;
+
+namespace ScriptBox.Core.Runtime;
+
+/// <summary>
+/// Writes the MessagePack subset read by the guest for binary host call responses.
+/// See <see cref="MessagePackReader"/> for the supported types.
+/// </summary>
+internal sealed class MessagePackWriter
+{
+    private const int MaxDepth = 64;
+
+    private byte[] _buffer;
+    private int _length;
+
+    public MessagePackWriter(int initialCapacity = 256)
+    {
+        _buffer = new byte[Math.Max(initialCapacity, 16)];
+    }
+
+    public ReadOnlySpan<byte> WrittenSpan => new(_buffer, 0, _length);
+
+    public void Reset() => _length = 0;
+
+    public void WriteRaw(byte value)
+    {
+        Ensure(1);
+        _buffer[_length++] = value;
+    }
+
+    public void WriteNil() => WriteRaw(0xc0);
+
+    public void WriteBoolean(bool value) => WriteRaw(value ? (byte)0xc3 : (byte)0xc2);
+
+    public void WriteInt64(long value)
+    {
+        if (value is >= 0 and <= 0x7f)
+        {
+            WriteRaw((byte)value);
+        }
+        else if (value is < 0 and >= -32)
+        {
+            WriteRaw((byte)(0xe0 | (value & 0x1f)));
+        }
+        else if (value is >= int.MinValue and <= int.MaxValue)
+        {
+            WriteTagged(0xd2, (ulong)value, 4);
+        }
+        else
+        {
+            WriteTagged(0xd3, (ulong)value, 8);
+        }
+    }
+
+    public void WriteDouble(double value)
+    {
+        WriteTagged(0xcb, (ulong)BitConverter.DoubleToInt64Bits(value), 8);
+    }
+
+    public void WriteString(string value)
+    {
+        var byteCount = Encoding.UTF8.GetByteCount(value);
+        if (byteCount < 32)
+        {
+            WriteRaw((byte)(0xa0 | byteCount));
+        }
+        else if (byteCount <= 0xff)
+        {
+            WriteTagged(0xd9, (ulong)byteCount, 1);
+        }
+        else if (byteCount <= 0xffff)
+        {
+            WriteTagged(0xda, (ulong)byteCount, 2);
+        }
+        else
+        {
+            WriteTagged(0xdb, (ulong)byteCount, 4);
+        }
+
+        Ensure(byteCount);
+        _length += Encoding.UTF8.GetBytes(value, 0, value.Length, _buffer, _length);
+    }
+
+    public void WriteArrayHeader(int count)
+    {
+        if (count < 16)
+        {
+            WriteRaw((byte)(0x90 | count));
+        }
+        else if (count <= 0xffff)
+        {
+            WriteTagged(0xdc, (ulong)count, 2);
+        }
+        else
+        {
+            WriteTagged(0xdd, (ulong)count, 4);
+        }
+    }
+
+    public void WriteMapHeader(int count)
+    {
+        if (count < 16)
+        {
+            WriteRaw((byte)(0x80 | count));
+        }
+        else if (count <= 0xffff)
+        {
+            WriteTagged(0xde, (ulong)count, 2);
+        }
+        else
+        {
+            WriteTagged(0xdf, (ulong)count, 4);
+        }
+    }
+
+    /// <summary>
+    /// Writes a handler result. Primitives, strings, string-keyed dictionaries and lists are
+    /// written directly; anything else goes through <see cref="JsonSerializer"/> with
+    /// <paramref name="options"/>, so it arrives in the guest exactly as a JSON host call would.
+    /// </summary>
+    public void WriteObject(object? value, JsonSerializerOptions options) => WriteObject(value, options, 0);
+
+    public void WriteJsonElement(JsonElement element) => WriteJsonElement(element, 0);
+
+    private void WriteObject(object? value, JsonSerializerOptions options, int depth)
+    {
+        if (depth > MaxDepth)
+        {
+            throw new InvalidOperationException("Host call result nested too deeply");
+        }
+
+        switch (value)
+        {
+            case null:
+                WriteNil();
+                return;
+            case string text:
+                WriteString(text);
+                return;
+            case bool boolean:
+                WriteBoolean(boolean);
+                return;
+            case int i:
+                WriteInt64(i);
+                return;
+            case long l:
+                WriteInt64(l);
+                return;
+            case short s:
+                WriteInt64(s);
+                return;
+            case byte b:
+                WriteInt64(b);
+                return;
+            case sbyte sb:
+                WriteInt64(sb);
+                return;
+            case ushort us:
+                WriteInt64(us);
+                return;
+            case uint ui:
+                WriteInt64(ui);
+                return;
+            case ulong ul when ul <= long.MaxValue:
+                WriteInt64((long)ul);
+                return;
+            case double d:
+                WriteDouble(d);
+                return;
+            case float f:
+                WriteDouble(f);
+                return;
+            case decimal m:
+                WriteDouble((double)m);
+                return;
+            case JsonElement element:
+                WriteJsonElement(element, depth);
+                return;
+            case IDictionary<string, object?> map:
+                WriteMapHeader(map.Count);
+                foreach (var entry in map)
+                {
+                    WriteString(entry.Key);
+                    WriteObject(entry.Value, options, depth + 1);
+                }
+                return;
+            case IList list when value is not byte[]:
+                WriteArrayHeader(list.Count);
+                foreach (var item in list)
+                {
+                    WriteObject(item, options, depth + 1);
+                }
+                return;
+            default:
+                using (var document = JsonDocument.Parse(JsonSerializer.SerializeToUtf8Bytes(value, value.GetType(), options)))
+                {
+                    WriteJsonElement(document.RootElement, depth);
+                }
+                return;
+        }
+    }
+
+    private void WriteJsonElement(JsonElement element, int depth)
+    {
+        if (depth > MaxDepth)
+        {
+            throw new InvalidOperationException("Host call result nested too deeply");
+        }
+
+        switch (element.ValueKind)
+        {
+            case JsonValueKind.String:
+                WriteString(element.GetString()!);
+                break;
+            case JsonValueKind.Number:
+                if (element.TryGetInt64(out var integer))
+                {
+                    WriteInt64(integer);
+                }
+                else
+                {
+                    WriteDouble(element.GetDouble());
+                }
+                break;
+            case JsonValueKind.True:
+                WriteBoolean(true);
+                break;
+            case JsonValueKind.False:
+                WriteBoolean(false);
+                break;
+            case JsonValueKind.Array:
+                WriteArrayHeader(element.GetArrayLength());
+                foreach (var item in element.EnumerateArray())
+                {
+                    WriteJsonElement(item, depth + 1);
+                }
+                break;
+            case JsonValueKind.Object:
+                var count = 0;
+                foreach (var _ in element.EnumerateObject())
+                {
+                    count++;
+                }
+
+                WriteMapHeader(count);
+                foreach (var property in element.EnumerateObject())
+                {
+                    WriteString(property.Name);
+                    WriteJsonElement(property.Value, depth + 1);
+                }
+                break;
+            default:
+                WriteNil();
+                break;
+        }
+    }
+
+    private void WriteTagged(byte code, ulong value, int size)
+    {
+        Ensure(1 + size);
+        _buffer[_length++] = code;
+        for (var shift = (size - 1) * 8; shift >= 0; shift -= 8)
+        {
+            _buffer[_length++] = (byte)(value >> shift);
+        }
+    }
+
+    private void Ensure(int extra)
+    {
+        if (_length + extra <= _buffer.Length)
+        {
+            return;
+        }
+
+        var capacity = _buffer.Length * 2;
+        while (capacity < _length + extra)
+        {
+            capacity *= 2;
+        }
+
+        Array.Resize(ref _buffer, capacity);
+    }
+}
@@ -0,0 +1,122 @@
+using System.Collections.Generic;
+using System.Threading;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Host calls started by a script through <c>__host.bridgeAsync</c> that are still running.
+/// The executor awaits them between guest steps and hands each response back with
+/// <see cref="WasmInstance.TryCompleteHostCall"/>. Disposing cancels the calls that are left.
+/// </summary>
+internal sealed class AsyncHostCalls : IDisposable
+{
+    private readonly CancellationTokenSource _cts;
+    private readonly List<PendingCall> _pending = new();
+    private readonly object _gate = new();
+
+    public AsyncHostCalls(CancellationToken cancellationToken)
+    {
+        _cts = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken);
+        Token = _cts.Token;
+    }
+
+    /// <summary>
+    /// Passed to host call handlers; cancelled when the script ends, times out or is cancelled.
+    /// </summary>
+    public CancellationToken Token { get; }
+
+    public int Count
+    {
+        get
+        {
+            lock (_gate)
+            {
+                return _pending.Count;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Tracks a call the guest is waiting on.
+    /// </summary>
+    public void Add(int callId, Task<string> response)
+    {
+        lock (_gate)
+        {
+            _pending.Add(new PendingCall(callId, response));
+        }
+    }
+
+    /// <summary>
+    /// Waits until one of the pending calls has finished and removes it.
+    /// </summary>
+    /// <param name="timeoutMs">Milliseconds to wait, or <see cref="Timeout.Infinite"/>.</param>
+    /// <returns>The finished call, or null if <paramref name="timeoutMs"/> elapsed first.</returns>
+    /// <exception cref="OperationCanceledException">The caller's token was cancelled.</exception>
+    public async Task<(int CallId, string Response)?> WaitForNextAsync(int timeoutMs)
+    {
+        Task<string>[] responses;
+        lock (_gate)
+        {
+            if (_pending.Count == 0)
+            {
+                throw new InvalidOperationException("The script is waiting on host calls, but none are pending");
+            }
+
+            responses = new Task<string>[_pending.Count];
+            for (var i = 0; i < _pending.Count; i++)
+            {
+                responses[i] = _pending[i].Response;
+            }
+        }
+
+        var next = Task.WhenAny(responses);
+        using (var delayCts = CancellationTokenSource.CreateLinkedTokenSource(Token))
+        {
+            var delay = Task.Delay(timeoutMs, delayCts.Token);
+            if (await Task.WhenAny(next, delay).ConfigureAwait(false) != next)
+            {
+                Token.ThrowIfCancellationRequested();
+                return null;
+            }
+
+            delayCts.Cancel();
+        }
+
+        var finished = await next.ConfigureAwait(false);
+        int callId;
+        lock (_gate)
+        {
+            var index = _pending.FindIndex(call => ReferenceEquals(call.Response, finished));
+            callId = _pending[index].CallId;
+            _pending.RemoveAt(index);
+        }
+
+        return (callId, await finished.ConfigureAwait(false));
+    }
+
+    public void Dispose()
+    {
+        try
+        {
+            _cts.Cancel();
+        }
+        finally
+        {
+            _cts.Dispose();
+        }
+    }
+
+    private readonly struct PendingCall
+    {
+        public PendingCall(int callId, Task<string> response)
+        {
+            CallId = callId;
+            Response = response;
+        }
+
+        public int CallId { get; }
+
+        public Task<string> Response { get; }
+    }
+}
@@ -0,0 +1,47 @@
+using System.Threading;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Bootstrap code that runs before every script, fixed when its owner is built. Runs replay the
+/// bytecode compiled by <see cref="Compile"/> instead of hashing or rereading the source, so a
+/// request costs no file I/O and no allocation proportional to the bootstrap. Bytecode is only
+/// valid for the module that produced it, so an artifact belongs to one <see cref="WasmScriptExecutor"/>.
+/// </summary>
+internal sealed class BootstrapArtifact
+{
+    public static readonly BootstrapArtifact Empty = new(string.Empty);
+
+    private byte[]? _bytecode;
+
+    public BootstrapArtifact(string source)
+    {
+        Source = source ?? throw new ArgumentNullException(nameof(source));
+        IsEmpty = string.IsNullOrWhiteSpace(source);
+    }
+
+    /// <summary>
+    /// The bootstrap text, evaluated as is by modules without the bytecode ABI.
+    /// </summary>
+    public string Source { get; }
+
+    public bool IsEmpty { get; }
+
+    public bool IsCompiled => Volatile.Read(ref _bytecode) is not null;
+
+    /// <summary>
+    /// Returns the bytecode, compiling it on <paramref name="instance"/> the first time.
+    /// Concurrent first calls may both compile; one result wins and the other is dropped.
+    /// </summary>
+    public byte[] Compile(WasmInstance instance)
+    {
+        var bytecode = Volatile.Read(ref _bytecode);
+        if (bytecode is not null)
+        {
+            return bytecode;
+        }
+
+        bytecode = instance.Compile(Source);
+        return Interlocked.CompareExchange(ref _bytecode, bytecode, null) ?? bytecode;
+    }
+}
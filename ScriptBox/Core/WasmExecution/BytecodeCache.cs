@@ -0,0 +1,99 @@
+using System.Collections.Generic;
+using System.Security.Cryptography;
+using System.Text;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// LRU cache of QuickJS bytecode keyed by the SHA-256 of the source text.
+/// Bytecode is only valid for the module that produced it, so each
+/// <see cref="WasmScriptExecutor"/> owns its caches. Thread-safe.
+/// </summary>
+internal sealed class BytecodeCache
+{
+    private readonly int _capacity;
+    private readonly Dictionary<string, LinkedListNode<Entry>> _entries;
+    private readonly LinkedList<Entry> _lru = new();
+    private readonly object _gate = new();
+
+    public BytecodeCache(int capacity)
+    {
+        if (capacity <= 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(capacity), "Capacity must be positive");
+        }
+
+        _capacity = capacity;
+        _entries = new Dictionary<string, LinkedListNode<Entry>>(capacity, StringComparer.Ordinal);
+    }
+
+    public int Count
+    {
+        get
+        {
+            lock (_gate)
+            {
+                return _entries.Count;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns cached bytecode for <paramref name="source"/>, compiling it on a miss.
+    /// Compilation runs outside the lock; concurrent misses for the same source may compile twice.
+    /// Failed compilations are not cached.
+    /// </summary>
+    public byte[] GetOrAdd(string source, Func<string, byte[]> compile)
+    {
+        var key = ComputeKey(source);
+
+        lock (_gate)
+        {
+            if (_entries.TryGetValue(key, out var node))
+            {
+                _lru.Remove(node);
+                _lru.AddFirst(node);
+                return node.Value.Bytecode;
+            }
+        }
+
+        var bytecode = compile(source);
+
+        lock (_gate)
+        {
+            if (_entries.TryGetValue(key, out var existing))
+            {
+                return existing.Value.Bytecode;
+            }
+
+            _entries[key] = _lru.AddFirst(new Entry(key, bytecode));
+            if (_entries.Count > _capacity)
+            {
+                var last = _lru.Last!;
+                _lru.RemoveLast();
+                _entries.Remove(last.Value.Key);
+            }
+        }
+
+        return bytecode;
+    }
+
+    private static string ComputeKey(string source)
+    {
+        using var sha = SHA256.Create();
+        return Convert.ToBase64String(sha.ComputeHash(Encoding.UTF8.GetBytes(source)));
+    }
+
+    private sealed class Entry
+    {
+        public Entry(string key, byte[] bytecode)
+        {
+            Key = key;
+            Bytecode = bytecode;
+        }
+
+        public string Key { get; }
+
+        public byte[] Bytecode { get; }
+    }
+}
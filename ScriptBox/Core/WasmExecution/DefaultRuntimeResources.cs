@@ -8,12 +8,37 @@ namespace ScriptBox.Core.WasmExecution;
 internal static class DefaultRuntimeResources
 {
     private const string WasmResourceName = "ScriptBox.Wasm.scriptbox.wasm";
+    private const string ReleaseWasmResourceName = "ScriptBox.Wasm.scriptbox.release.wasm";
+    private const string SnapshotWasmResourceName = "ScriptBox.Wasm.scriptbox.snapshot.wasm";
     private const string CoreBootstrapResourceName = "ScriptBox.Js.sandbox-api.js";
     private const string ToolsBootstrapResourceName = "ScriptBox.Js.bootstrap-utils.js";
 
+    /// <summary>
+    /// Loads the embedded module, preferring the release build when it was packaged.
+    /// </summary>
     public static ReadOnlyMemory<byte> LoadEmbeddedWasm()
     {
-        return ReadAllBytes(WasmResourceName);
+        return TryLoadEmbeddedWasm(WasmBuildProfile.Release, out var release)
+            ? release
+            : ReadAllBytes(WasmResourceName);
+    }
+
+    /// <summary>
+    /// Loads the embedded module of the given profile. The release module
+    /// (<c>build.sh --release</c>) is optional; the debug module is always packaged.
+    /// </summary>
+    public static bool TryLoadEmbeddedWasm(WasmBuildProfile profile, out ReadOnlyMemory<byte> moduleBytes)
+    {
+        return TryReadAllBytes(profile == WasmBuildProfile.Release ? ReleaseWasmResourceName : WasmResourceName, out moduleBytes);
+    }
+
+    /// <summary>
+    /// Loads the pre-initialized snapshot module (<c>build.sh --snapshot</c>) if it
+    /// was present when the package was built.
+    /// </summary>
+    public static bool TryLoadEmbeddedSnapshotWasm(out ReadOnlyMemory<byte> moduleBytes)
+    {
+        return TryReadAllBytes(SnapshotWasmResourceName, out moduleBytes);
     }
 
     public static string LoadCoreBootstrap()
@@ -38,6 +63,22 @@ internal static class DefaultRuntimeResources
         return ms.ToArray();
     }
 
+    private static bool TryReadAllBytes(string resourceName, out ReadOnlyMemory<byte> bytes)
+    {
+        var assembly = typeof(DefaultRuntimeResources).GetTypeInfo().Assembly;
+        using var stream = assembly.GetManifestResourceStream(resourceName);
+        if (stream is null)
+        {
+            bytes = ReadOnlyMemory<byte>.Empty;
+            return false;
+        }
+
+        using var ms = new MemoryStream();
+        stream.CopyTo(ms);
+        bytes = ms.ToArray();
+        return true;
+    }
+
     private static string ReadAllText(string resourceName)
     {
         using var stream = OpenResourceStream(resourceName);
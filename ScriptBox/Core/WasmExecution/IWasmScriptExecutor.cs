@@ -1,3 +1,5 @@
+using System.Threading;
+
 namespace ScriptBox.Core.WasmExecution;
 
 /// <summary>
@@ -16,4 +18,55 @@ internal interface IWasmScriptExecutor
     /// <exception cref="InvalidOperationException">Thrown when WASM initialization or script execution fails.</exception>
     /// <exception cref="TimeoutException">Thrown when script execution exceeds the timeout limit.</exception>
     WasmExecutionResult ExecuteScript(string jsCode, int? timeoutMs = null);
+
+    /// <summary>
+    /// Executes JavaScript code on the instance held by <paramref name="lease"/>.
+    /// Scripts sharing a lease run sequentially; each gets a fresh JavaScript context unless the
+    /// lease persists state, in which case the bootstrap runs only in the first script's context.
+    /// </summary>
+    /// <param name="lease">Lease created by <see cref="CreateLease"/>.</param>
+    /// <param name="bootstrap">Session bootstrap evaluated before <paramref name="jsCode"/> in the same context. May be empty.</param>
+    /// <param name="jsCode">The JavaScript source code to execute.</param>
+    /// <param name="timeoutMs">Optional timeout in milliseconds, as for <see cref="ExecuteScript(string, int?)"/>.</param>
+    WasmExecutionResult ExecuteScript(WasmInstanceLease lease, BootstrapArtifact? bootstrap, string jsCode, int? timeoutMs = null);
+
+    /// <summary>
+    /// Executes JavaScript code like <see cref="ExecuteScript(string, int?)"/> without blocking a thread
+    /// while the script awaits host calls made through <c>__host.bridgeAsync</c>.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels waiting on host calls; guest code that is already running finishes its step.</param>
+    Task<WasmExecutionResult> ExecuteScriptAsync(string jsCode, int? timeoutMs = null, CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Executes JavaScript code on the instance held by <paramref name="lease"/>, like
+    /// <see cref="ExecuteScriptAsync(string, int?, CancellationToken)"/>.
+    /// </summary>
+    Task<WasmExecutionResult> ExecuteScriptAsync(
+        WasmInstanceLease lease,
+        BootstrapArtifact? bootstrap,
+        string jsCode,
+        int? timeoutMs = null,
+        CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Runs <paramref name="script"/> on the instance held by <paramref name="lease"/> with
+    /// <paramref name="input"/>, serialized to JSON and parsed in the guest rather than spliced into the source.
+    /// </summary>
+    Task<WasmExecutionResult> ExecuteScriptAsync(
+        WasmInstanceLease lease,
+        BootstrapArtifact? bootstrap,
+        PreparedScript script,
+        object? input,
+        int? timeoutMs = null,
+        CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Creates a lease that keeps a warm WASM instance for a session. Dispose it to return the instance.
+    /// </summary>
+    /// <param name="persistState">
+    /// Keep one JavaScript context for all scripts on the lease, so globals set by one script are
+    /// visible to the next. Needs a module with the context API.
+    /// </param>
+    /// <param name="maxMemoryBytes">Linear memory limit for a lease that persists state; null for none.</param>
+    WasmInstanceLease CreateLease(bool persistState = false, long? maxMemoryBytes = null);
 }
@@ -0,0 +1,66 @@
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Console output of one script run, bounded by <see cref="Configuration.SandboxConfiguration.MaxLogEntries"/>
+/// and thinned by <see cref="Configuration.SandboxConfiguration.LogSampleRate"/>. The host asks
+/// <see cref="Admit"/> before decoding an entry, so dropped entries cost no allocation.
+/// </summary>
+internal sealed class ScriptLog
+{
+    private readonly List<string> _entries = new();
+    private readonly int? _maxEntries;
+    private readonly double _sampleRate;
+    private double _sampleCredit;
+
+    public ScriptLog(int? maxEntries, double sampleRate)
+    {
+        _maxEntries = maxEntries;
+        _sampleRate = sampleRate;
+        // Start one step short of a full credit, so the first entry is always kept
+        _sampleCredit = 1 - sampleRate;
+    }
+
+    /// <summary>
+    /// Entries dropped by the cap or by sampling so far.
+    /// </summary>
+    public int DroppedCount { get; private set; }
+
+    /// <summary>
+    /// Decides whether the next entry is kept; entries that are not are counted as dropped.
+    /// Sampling keeps an evenly spaced share of the entries, so the same script logs the same lines.
+    /// </summary>
+    public bool Admit()
+    {
+        _sampleCredit += _sampleRate;
+        if (_sampleCredit < 1)
+        {
+            DroppedCount++;
+            return false;
+        }
+
+        _sampleCredit -= 1;
+        if (_entries.Count >= _maxEntries)
+        {
+            DroppedCount++;
+            return false;
+        }
+
+        return true;
+    }
+
+    public void Add(string message) => _entries.Add(message);
+
+    /// <summary>
+    /// The kept entries, followed by a note on how many were dropped, if any.
+    /// Call once, when the run has finished.
+    /// </summary>
+    public IList<string> Complete()
+    {
+        if (DroppedCount > 0)
+        {
+            _entries.Add($"[scriptbox] {DroppedCount} log entries dropped (MaxLogEntries/LogSampleRate)");
+        }
+
+        return _entries;
+    }
+}
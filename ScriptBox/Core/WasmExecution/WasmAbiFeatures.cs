@@ -0,0 +1,94 @@
+using System;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Optional guest capabilities reported by the <c>get_abi_features</c> export.
+/// Modules built before the export existed report <see cref="None"/>, and the host
+/// then sticks to the original <c>eval_js</c> protocol.
+/// </summary>
+[Flags]
+internal enum WasmAbiFeatures
+{
+    None = 0,
+
+    /// <summary>
+    /// <c>eval_js_shared</c>: one QuickJS runtime per instance, a fresh context per script.
+    /// </summary>
+    SharedRuntime = 1 << 0,
+
+    /// <summary>
+    /// <c>context_create</c>/<c>context_eval</c>/<c>context_free</c>: several evaluations in one context.
+    /// </summary>
+    ContextApi = 1 << 1,
+
+    /// <summary>
+    /// <c>compile_js</c>/<c>context_eval_bytecode</c>: compile to QuickJS bytecode and replay it.
+    /// </summary>
+    Bytecode = 1 << 2,
+
+    /// <summary>
+    /// <c>get_result_region</c>/<c>free_result</c>: results in a guest-allocated, length-prefixed
+    /// region sized to fit, instead of the fixed 64KB buffer that truncated large results.
+    /// </summary>
+    ResultRegion = 1 << 3,
+
+    /// <summary>
+    /// <c>grow_response_buffer</c>: host-call responses of any size. The host asks the guest to
+    /// grow its response buffer from inside <c>host.call</c> instead of truncating.
+    /// </summary>
+    GrowResponseBuffer = 1 << 4,
+
+    /// <summary>
+    /// <c>alloc_input</c>/<c>free_input</c>: script input in a right-sized, NUL-terminated guest
+    /// allocation parsed in place, instead of the fixed 1MB script buffer.
+    /// </summary>
+    InputAlloc = 1 << 5,
+
+    /// <summary>
+    /// <c>__host.bridgeAsync</c> and <c>complete_host_call</c>: scripts await host calls that run
+    /// asynchronously on the host; evaluations report "pending" instead of blocking the guest.
+    /// </summary>
+    AsyncHostCalls = 1 << 6,
+
+    /// <summary>
+    /// <c>__host.bridgeBinary</c>: host calls encoded as MessagePack natively in the guest.
+    /// The host recognises them by their first byte, so it needs no export for this.
+    /// </summary>
+    BinaryHostCalls = 1 << 7,
+
+    /// <summary>
+    /// <c>set_memory_limits</c>/<c>get_heap_in_use</c>: QuickJS runtimes use an allocator that
+    /// tracks block sizes, so heap limits are enforced and live heap usage can be reported.
+    /// </summary>
+    MemoryLimits = 1 << 8,
+
+    /// <summary>
+    /// <c>context_eval</c> flag <see cref="WasmConfiguration.EvalFlagBinaryResult"/>: results encoded
+    /// as MessagePack straight into the result region, decoded by the host without a JSON string.
+    /// </summary>
+    BinaryResults = 1 << 9,
+
+    /// <summary>
+    /// <c>context_call_bytecode</c>: run a compiled function expression and call it with an argument
+    /// parsed from JSON, so prepared scripts reuse one bytecode blob for every input.
+    /// </summary>
+    PreparedCalls = 1 << 10,
+
+    /// <summary>
+    /// <c>get_memory_stats</c>: QuickJS heap statistics (<c>JS_ComputeMemoryUsage</c>) surfaced
+    /// as <see cref="GuestMemoryStats"/>.
+    /// </summary>
+    MemoryStats = 1 << 11,
+
+    /// <summary>
+    /// <c>set_interrupt_deadline</c>/<c>was_interrupted</c>: the guest stops a script that runs
+    /// past its deadline from the QuickJS interrupt handler, and the instance stays usable.
+    /// </summary>
+    Interrupts = 1 << 12,
+
+    /// <summary>
+    /// <c>set_profiler</c>/<c>get_profile</c>: sampled JavaScript stacks surfaced as <see cref="ScriptProfile"/>.
+    /// </summary>
+    Profiler = 1 << 13,
+}
@@ -14,7 +14,7 @@ internal static class WasmConfiguration
 
     /// <summary>
     /// Maximum allowed size for a script in WASM memory (1MB).
-    /// Prevents memory exhaustion and provides a clear boundary.
+    /// Only applies to modules without <c>alloc_input</c>, which are limited by their fixed buffer.
     /// </summary>
     public const int MaxScriptSize = 0x100000;
 
@@ -28,6 +28,47 @@ internal static class WasmConfiguration
     /// </summary>
     public const string EvalFunctionName = "eval_js";
 
+    /// <summary>
+    /// WASM function name for evaluating JavaScript on the instance's long-lived runtime
+    /// (fresh context per call). Only used when <see cref="WasmAbiFeatures.SharedRuntime"/> is reported.
+    /// </summary>
+    public const string EvalSharedFunctionName = "eval_js_shared";
+
+    /// <summary>
+    /// WASM function name reporting optional guest capabilities as a <see cref="WasmAbiFeatures"/> bitmask.
+    /// </summary>
+    public const string GetAbiFeaturesFunctionName = "get_abi_features";
+
+    /// <summary>
+    /// WASM function names of the context API (<see cref="WasmAbiFeatures.ContextApi"/>).
+    /// </summary>
+    public const string ContextCreateFunctionName = "context_create";
+    public const string ContextEvalFunctionName = "context_eval";
+    public const string ContextFreeFunctionName = "context_free";
+
+    /// <summary>
+    /// WASM function names for bytecode compilation and replay (<see cref="WasmAbiFeatures.Bytecode"/>).
+    /// </summary>
+    public const string CompileFunctionName = "compile_js";
+    public const string ContextEvalBytecodeFunctionName = "context_eval_bytecode";
+    public const string GetBytecodePtrFunctionName = "get_bytecode_ptr";
+    public const string GetBytecodeLenFunctionName = "get_bytecode_len";
+
+    /// <summary>
+    /// context_eval flag: evaluate for side effects only, skip result conversion.
+    /// </summary>
+    public const int EvalFlagDiscardResult = 1 << 0;
+
+    /// <summary>
+    /// context_eval flag: if the result is a promise, run the job queue and report its settled value.
+    /// </summary>
+    public const int EvalFlagAwaitResult = 1 << 1;
+
+    /// <summary>
+    /// context_eval flag: store the result as MessagePack in the result region instead of text.
+    /// </summary>
+    public const int EvalFlagBinaryResult = 1 << 2;
+
     /// <summary>
     /// WASM function name for retrieving error buffer pointer.
     /// </summary>
@@ -48,6 +89,82 @@ internal static class WasmConfiguration
     /// </summary>
     public const string GetResultLenFunctionName = "get_result_len";
 
+    /// <summary>
+    /// WASM function names for the length-prefixed result region (<see cref="WasmAbiFeatures.ResultRegion"/>).
+    /// </summary>
+    public const string GetResultRegionFunctionName = "get_result_region";
+    public const string FreeResultFunctionName = "free_result";
+
+    /// <summary>
+    /// Size of the little-endian uint32 length that precedes the result bytes.
+    /// </summary>
+    public const int ResultRegionHeaderSize = 4;
+
+    /// <summary>
+    /// WASM function name the host calls during host.call to enlarge the response buffer.
+    /// </summary>
+    public const string GrowResponseBufferFunctionName = "grow_response_buffer";
+
+    /// <summary>
+    /// WASM function name allocating the input buffer for one script or bytecode blob.
+    /// </summary>
+    public const string AllocInputFunctionName = "alloc_input";
+
+    /// <summary>
+    /// WASM function name releasing the buffer returned by <see cref="AllocInputFunctionName"/>.
+    /// </summary>
+    public const string FreeInputFunctionName = "free_input";
+
+    /// <summary>
+    /// WASM function name delivering the response of an async host call to the guest.
+    /// </summary>
+    public const string CompleteHostCallFunctionName = "complete_host_call";
+
+    /// <summary>
+    /// WASM function name setting the QuickJS heap limit and GC threshold of an instance.
+    /// </summary>
+    public const string SetMemoryLimitsFunctionName = "set_memory_limits";
+
+    /// <summary>
+    /// WASM function name running bytecode that yields a function and calling it with a JSON argument.
+    /// </summary>
+    public const string ContextCallBytecodeFunctionName = "context_call_bytecode";
+
+    /// <summary>
+    /// WASM function name reporting the bytes QuickJS currently has allocated.
+    /// </summary>
+    public const string GetHeapInUseFunctionName = "get_heap_in_use";
+
+    /// <summary>
+    /// WASM function name computing QuickJS heap statistics; returns a pointer to eight int64 values.
+    /// </summary>
+    public const string GetMemoryStatsFunctionName = "get_memory_stats";
+
+    /// <summary>
+    /// Bytes of the little-endian length before each entry of a <c>host.log_batch</c> batch.
+    /// </summary>
+    public const int LogEntryHeaderSize = 4;
+
+    /// <summary>
+    /// WASM function name arming (milliseconds) or disarming (0) the cooperative deadline.
+    /// </summary>
+    public const string SetInterruptDeadlineFunctionName = "set_interrupt_deadline";
+
+    /// <summary>
+    /// WASM function name reporting whether the armed deadline interrupted the script.
+    /// </summary>
+    public const string WasInterruptedFunctionName = "was_interrupted";
+
+    /// <summary>
+    /// WASM function name starting (interval in microseconds) or stopping (0) stack sampling.
+    /// </summary>
+    public const string SetProfilerFunctionName = "set_profiler";
+
+    /// <summary>
+    /// WASM function name returning a pointer to four int32 values describing the samples.
+    /// </summary>
+    public const string GetProfileFunctionName = "get_profile";
+
     /// <summary>
     /// WASM function name for retrieving script buffer pointer.
     /// </summary>
@@ -58,11 +175,40 @@ internal static class WasmConfiguration
     /// </summary>
     public const string GetScriptBufferLenFunctionName = "get_script_buffer_len";
 
+    /// <summary>
+    /// WASM function name reporting whether the module was snapshotted after bootstrap
+    /// (<c>build.sh --snapshot</c>). Returns 1 for pre-initialized modules.
+    /// </summary>
+    public const string IsPreinitializedFunctionName = "is_preinitialized";
+
     /// <summary>
     /// Success status code returned by eval_js.
     /// </summary>
     public const int SuccessStatusCode = 0;
 
+    /// <summary>
+    /// Status code returned by eval_js when the script threw. The instance stays usable;
+    /// every other non-zero status marks it as faulted.
+    /// </summary>
+    public const int ScriptExceptionStatusCode = 22;
+
+    /// <summary>
+    /// Status code returned while an awaited script result waits on async host calls.
+    /// The context stays open until the responses are delivered with <c>complete_host_call</c>.
+    /// </summary>
+    public const int PendingStatusCode = 30;
+
+    /// <summary>
+    /// First byte of binary host call requests and responses (<c>__host.bridgeBinary</c>).
+    /// 0xC1 is never used by MessagePack, and JSON requests always start with '{'.
+    /// </summary>
+    public const byte BinaryHostCallMarker = 0xC1;
+
+    /// <summary>
+    /// Default number of user scripts whose bytecode is kept (LRU).
+    /// </summary>
+    public const int DefaultScriptBytecodeCacheSize = 128;
+
     /// <summary>
     /// Default timeout for script execution in milliseconds.
     /// Scripts exceeding this time will be terminated.
@@ -75,4 +221,32 @@ internal static class WasmConfiguration
     /// Calibrated based on typical QuickJS instruction execution rates.
     /// </summary>
     public const long FuelPerMs = 100000; // Approximately 100K fuel units per millisecond
+
+    /// <summary>
+    /// Default interval between epoch ticks; a timed-out guest step is interrupted within about one tick.
+    /// </summary>
+    public const int DefaultEpochTickMs = 10;
+
+    /// <summary>
+    /// Epoch deadline (in ticks) armed while no script step runs, so host-driven guest calls such as
+    /// <c>context_free</c> are never interrupted. Wasmtime adds it to the current epoch, so it must
+    /// stay well clear of <see cref="ulong.MaxValue"/>.
+    /// </summary>
+    public const ulong UnboundedEpochDeadline = 1UL << 48;
+
+    /// <summary>
+    /// Extra time the epoch deadline and the watchdog allow past the timeout on modules with
+    /// cooperative deadlines, so the guest can stop the script itself and the instance is kept.
+    /// </summary>
+    public const int CooperativeTimeoutGraceMs = 50;
+
+    /// <summary>
+    /// Default time between profiler samples.
+    /// </summary>
+    public static readonly TimeSpan DefaultProfileSampleInterval = TimeSpan.FromMilliseconds(1);
+
+    /// <summary>
+    /// Fuel left in a store while no fuel budget applies.
+    /// </summary>
+    public const ulong UnboundedFuel = long.MaxValue;
 }
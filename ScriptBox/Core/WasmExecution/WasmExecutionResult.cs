@@ -1,4 +1,5 @@
 using System.Collections.Generic;
+using System.Text.Json;
 
 namespace ScriptBox.Core.WasmExecution;
 
@@ -7,19 +8,45 @@ namespace ScriptBox.Core.WasmExecution;
 /// </summary>
 internal sealed class WasmExecutionResult
 {
+    private string? _result;
+
     /// <summary>
     /// The string result returned by the script (JSON or primitive string).
+    /// Structured results are serialized to JSON on first access.
+    /// </summary>
+    public string Result => _result ??= Value as string ?? JsonSerializer.Serialize(Value);
+
+    /// <summary>
+    /// The value handed to callers: <see cref="Result"/>, or the decoded value
+    /// (numbers, strings, lists, dictionaries) when structured results are enabled.
     /// </summary>
-    public string Result { get; }
+    public object? Value { get; }
 
     /// <summary>
     /// The console logs captured during execution.
     /// </summary>
     public IList<string> Logs { get; }
 
+    /// <summary>
+    /// Guest heap statistics at the end of the run, when they were collected.
+    /// </summary>
+    public GuestMemoryStats? Memory { get; init; }
+
+    /// <summary>
+    /// Sampled JavaScript stacks of the run, when profiling was enabled.
+    /// </summary>
+    public ScriptProfile? Profile { get; init; }
+
     public WasmExecutionResult(string result, IList<string> logs)
     {
-        Result = result;
+        _result = result;
+        Value = result;
+        Logs = logs;
+    }
+
+    public WasmExecutionResult(object? value, IList<string> logs)
+    {
+        Value = value;
         Logs = logs;
     }
 }
@@ -0,0 +1,134 @@
+using System;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Execution tuning passed from <see cref="ScriptBoxBuilder"/> to <see cref="WasmScriptExecutor"/>.
+/// </summary>
+internal sealed class WasmExecutorOptions
+{
+    /// <summary>
+    /// Keep WASM instances (and their QuickJS runtime) alive between scripts.
+    /// When false every script gets a freshly instantiated module, as before pooling existed.
+    /// </summary>
+    public bool ReuseInstances { get; set; } = true;
+
+    /// <summary>
+    /// Idle instances the pool keeps ready. Created in the background at startup and
+    /// after every rent, so request threads do not pay for instantiation.
+    /// </summary>
+    public int MinIdleInstances { get; set; }
+
+    /// <summary>
+    /// Upper bound on idle instances kept by the pool. Extra instances are disposed on return.
+    /// </summary>
+    public int MaxIdleInstances { get; set; } = Environment.ProcessorCount;
+
+    /// <summary>
+    /// Number of scripts an instance may run before it is recycled. Linear memory never
+    /// shrinks, so recycling bounds the footprint left behind by large scripts.
+    /// </summary>
+    public int MaxUsesPerInstance { get; set; } = 500;
+
+    /// <summary>
+    /// User scripts whose compiled bytecode is kept (LRU, keyed by source hash).
+    /// 0 disables caching of user scripts; bootstrap code is always cached.
+    /// Only used with modules that export the bytecode ABI.
+    /// </summary>
+    public int ScriptBytecodeCacheSize { get; set; } = WasmConfiguration.DefaultScriptBytecodeCacheSize;
+
+    /// <summary>
+    /// Share the engine and compiled module with other executors in the process that load the
+    /// same module with the same engine settings, so only the first of them compiles it.
+    /// </summary>
+    public bool ShareModule { get; set; } = true;
+
+    /// <summary>
+    /// Enable Wasmtime's on-disk compilation cache, so compiled machine code is reused
+    /// across process starts instead of running Cranelift on every startup.
+    /// </summary>
+    public bool UseCompilationCache { get; set; }
+
+    /// <summary>
+    /// Wasmtime cache configuration file (TOML, <c>[cache]</c> section with <c>directory</c> etc.).
+    /// Null uses Wasmtime's default configuration and platform cache directory.
+    /// </summary>
+    public string? CompilationCacheConfigPath { get; set; }
+
+    /// <summary>
+    /// Compile the module with Wasmtime epoch interruption, so a guest step that outlives its
+    /// timeout traps instead of running on in the background. Precompiled artifacts must be
+    /// built with the same setting (<c>wasmtime compile -W epoch-interruption=y</c>).
+    /// </summary>
+    public bool EpochInterruption { get; set; } = true;
+
+    /// <summary>
+    /// Milliseconds between epoch ticks; the precision of epoch interruption.
+    /// </summary>
+    public int EpochTickMs { get; set; } = WasmConfiguration.DefaultEpochTickMs;
+
+    /// <summary>
+    /// Fuel (roughly one unit per WASM instruction) a script may consume, bootstrap included.
+    /// Null disables fuel metering. Unlike timeouts this limit is deterministic, but metering
+    /// slows guest code down and precompiled artifacts need <c>-W consume-fuel=y</c>.
+    /// </summary>
+    public ulong? FuelPerScript { get; set; }
+
+    /// <summary>
+    /// Return script results as .NET values decoded from MessagePack instead of JSON text.
+    /// Only used with modules that report <see cref="WasmAbiFeatures.BinaryResults"/>.
+    /// </summary>
+    public bool StructuredResults { get; set; }
+
+    /// <summary>
+    /// Compute <see cref="GuestMemoryStats"/> after every script. Walks the QuickJS heap, so it
+    /// adds time proportional to the heap. Only used with modules that report <see cref="WasmAbiFeatures.MemoryStats"/>.
+    /// </summary>
+    public bool CollectMemoryStats { get; set; }
+
+    /// <summary>
+    /// Time between JavaScript stack samples, or null to not profile. Only used with modules
+    /// that report <see cref="WasmAbiFeatures.Profiler"/>.
+    /// </summary>
+    public TimeSpan? ProfileSampleInterval { get; set; }
+
+    public static WasmExecutorOptions CreateDefault() => new();
+
+    public void Validate()
+    {
+        if (MinIdleInstances < 0)
+        {
+            throw new InvalidOperationException("MinIdleInstances cannot be negative");
+        }
+
+        if (MaxIdleInstances < MinIdleInstances)
+        {
+            throw new InvalidOperationException("MaxIdleInstances cannot be less than MinIdleInstances");
+        }
+
+        if (MaxUsesPerInstance <= 0)
+        {
+            throw new InvalidOperationException("MaxUsesPerInstance must be positive");
+        }
+
+        if (ScriptBytecodeCacheSize < 0)
+        {
+            throw new InvalidOperationException("ScriptBytecodeCacheSize cannot be negative");
+        }
+
+        if (EpochTickMs <= 0)
+        {
+            throw new InvalidOperationException("EpochTickMs must be positive");
+        }
+
+        if (ProfileSampleInterval is { } interval && interval <= TimeSpan.Zero)
+        {
+            throw new InvalidOperationException("ProfileSampleInterval must be positive");
+        }
+
+        if (FuelPerScript is 0 or > WasmConfiguration.UnboundedFuel)
+        {
+            throw new InvalidOperationException($"FuelPerScript must be between 1 and {WasmConfiguration.UnboundedFuel}");
+        }
+    }
+}
@@ -0,0 +1,820 @@
+using System.Text;
+using System.Threading;
+using ScriptBox.Core.HostApi;
+using ScriptBox.Core.Runtime;
+using Wasmtime;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// A live instantiation of the QuickJS module: its <see cref="Store"/>, <see cref="Instance"/>,
+/// linear memory and resolved exports. Instances are reused across scripts via
+/// <see cref="WasmInstancePool"/>; they are not thread-safe and run one script at a time.
+/// </summary>
+internal sealed class WasmInstance : IDisposable
+{
+    private readonly Linker _linker;
+    private readonly Store _store;
+    private readonly Func<int, int, int> _eval;
+    private readonly Func<int> _getErrorPtr;
+    private readonly Func<int> _getErrorLen;
+    private readonly Func<int> _getResultPtr;
+    private readonly Func<int> _getResultLen;
+    private readonly Func<int>? _getResultRegion;
+    private readonly Action? _freeResult;
+    private readonly Func<int, int>? _growResponseBuffer;
+    private readonly Func<int, int>? _allocInput;
+    private readonly Action? _freeInput;
+    private readonly Func<int>? _contextCreate;
+    private readonly Action? _contextFree;
+    private readonly Func<int, int, int, int>? _contextEval;
+    private readonly Func<int, int, int, int>? _contextEvalBytecode;
+    private readonly Func<int, int, int>? _compile;
+    private readonly Func<int, int, int, int>? _completeHostCall;
+    private readonly Func<int, int, int, int, int>? _contextCallBytecode;
+    private readonly Action<int, int>? _setMemoryLimits;
+    private readonly Func<int>? _getHeapInUse;
+    private readonly Func<int>? _getMemoryStats;
+    private readonly Action<int>? _setInterruptDeadline;
+    private readonly Func<int>? _wasInterrupted;
+    private readonly Action<int>? _setProfiler;
+    private readonly Func<int>? _getProfile;
+    private bool _structuredResults;
+    private readonly Func<int>? _getBytecodePtr;
+    private readonly Func<int>? _getBytecodeLen;
+    private readonly int _scriptBufferPtr;
+    private readonly int _scriptBufferLen;
+    private int _abandoned;
+    private bool _disposed;
+
+    /// <summary>
+    /// Instantiates <paramref name="module"/> in a new store.
+    /// </summary>
+    /// <param name="engine">Engine the module was compiled with.</param>
+    /// <param name="module">The QuickJS module.</param>
+    /// <param name="defineImports">Defines WASI and host imports; receives this instance so callbacks can reach <see cref="LogSink"/>.</param>
+    /// <param name="preferSharedRuntime">Use <c>eval_js_shared</c> when the module supports it.</param>
+    public WasmInstance(
+        Engine engine,
+        Module module,
+        Action<Store, Linker, WasmInstance> defineImports,
+        bool preferSharedRuntime)
+    {
+        _linker = new Linker(engine);
+        _store = new Store(engine);
+
+        try
+        {
+            defineImports(_store, _linker, this);
+
+            Instance = _linker.Instantiate(_store, module);
+            Memory = Instance.GetMemory(WasmConfiguration.MemoryExportName)
+                     ?? throw new InvalidOperationException($"No {WasmConfiguration.MemoryExportName} export found");
+
+            var getAbiFeatures = Instance.GetFunction<int>(WasmConfiguration.GetAbiFeaturesFunctionName);
+            AbiFeatures = getAbiFeatures is null ? WasmAbiFeatures.None : (WasmAbiFeatures)getAbiFeatures();
+
+            Func<int, int, int>? eval = null;
+            if (preferSharedRuntime && (AbiFeatures & WasmAbiFeatures.SharedRuntime) != 0)
+            {
+                eval = Instance.GetFunction<int, int, int>(WasmConfiguration.EvalSharedFunctionName);
+            }
+
+            UsesSharedRuntime = eval is not null;
+            _eval = eval
+                    ?? Instance.GetFunction<int, int, int>(WasmConfiguration.EvalFunctionName)
+                    ?? throw new InvalidOperationException($"{WasmConfiguration.EvalFunctionName} function not found");
+
+            _getErrorPtr = RequireFunction(WasmConfiguration.GetErrorPtrFunctionName);
+            _getErrorLen = RequireFunction(WasmConfiguration.GetErrorLenFunctionName);
+            _getResultPtr = RequireFunction(WasmConfiguration.GetResultPtrFunctionName);
+            _getResultLen = RequireFunction(WasmConfiguration.GetResultLenFunctionName);
+
+            if ((AbiFeatures & WasmAbiFeatures.InputAlloc) != 0)
+            {
+                _allocInput = Instance.GetFunction<int, int>(WasmConfiguration.AllocInputFunctionName);
+                _freeInput = Instance.GetAction(WasmConfiguration.FreeInputFunctionName);
+                if (_freeInput is null)
+                {
+                    _allocInput = null;
+                }
+            }
+
+            if (_allocInput is null)
+            {
+                // Only legacy modules need the fixed buffer; newer ones allocate it lazily
+                (_scriptBufferPtr, _scriptBufferLen) = GetScriptBufferLocation(Instance);
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.ResultRegion) != 0)
+            {
+                _getResultRegion = Instance.GetFunction<int>(WasmConfiguration.GetResultRegionFunctionName);
+                _freeResult = Instance.GetAction(WasmConfiguration.FreeResultFunctionName);
+                if (_freeResult is null)
+                {
+                    _getResultRegion = null;
+                }
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.ContextApi) != 0)
+            {
+                _contextCreate = Instance.GetFunction<int>(WasmConfiguration.ContextCreateFunctionName);
+                _contextFree = Instance.GetAction(WasmConfiguration.ContextFreeFunctionName);
+                _contextEval = Instance.GetFunction<int, int, int, int>(WasmConfiguration.ContextEvalFunctionName);
+                if (_contextCreate is null || _contextFree is null || _contextEval is null)
+                {
+                    _contextCreate = null;
+                }
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.GrowResponseBuffer) != 0)
+            {
+                _growResponseBuffer = Instance.GetFunction<int, int>(WasmConfiguration.GrowResponseBufferFunctionName);
+            }
+
+            if (_contextCreate is not null && (AbiFeatures & WasmAbiFeatures.Bytecode) != 0)
+            {
+                _compile = Instance.GetFunction<int, int, int>(WasmConfiguration.CompileFunctionName);
+                _contextEvalBytecode = Instance.GetFunction<int, int, int, int>(WasmConfiguration.ContextEvalBytecodeFunctionName);
+                _getBytecodePtr = Instance.GetFunction<int>(WasmConfiguration.GetBytecodePtrFunctionName);
+                _getBytecodeLen = Instance.GetFunction<int>(WasmConfiguration.GetBytecodeLenFunctionName);
+                if (_contextEvalBytecode is null || _getBytecodePtr is null || _getBytecodeLen is null)
+                {
+                    _compile = null;
+                }
+            }
+
+            if (_contextCreate is not null && _allocInput is not null && (AbiFeatures & WasmAbiFeatures.AsyncHostCalls) != 0)
+            {
+                _completeHostCall = Instance.GetFunction<int, int, int, int>(WasmConfiguration.CompleteHostCallFunctionName);
+            }
+
+            if (_compile is not null && (AbiFeatures & WasmAbiFeatures.PreparedCalls) != 0)
+            {
+                _contextCallBytecode = Instance.GetFunction<int, int, int, int, int>(WasmConfiguration.ContextCallBytecodeFunctionName);
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.MemoryLimits) != 0)
+            {
+                _setMemoryLimits = Instance.GetAction<int, int>(WasmConfiguration.SetMemoryLimitsFunctionName);
+                _getHeapInUse = Instance.GetFunction<int>(WasmConfiguration.GetHeapInUseFunctionName);
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.MemoryStats) != 0)
+            {
+                _getMemoryStats = Instance.GetFunction<int>(WasmConfiguration.GetMemoryStatsFunctionName);
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.Interrupts) != 0)
+            {
+                _setInterruptDeadline = Instance.GetAction<int>(WasmConfiguration.SetInterruptDeadlineFunctionName);
+                _wasInterrupted = Instance.GetFunction<int>(WasmConfiguration.WasInterruptedFunctionName);
+            }
+
+            if ((AbiFeatures & WasmAbiFeatures.Profiler) != 0)
+            {
+                _setProfiler = Instance.GetAction<int>(WasmConfiguration.SetProfilerFunctionName);
+                _getProfile = Instance.GetFunction<int>(WasmConfiguration.GetProfileFunctionName);
+            }
+        }
+        catch
+        {
+            _store.Dispose();
+            _linker.Dispose();
+            throw;
+        }
+    }
+
+    public Instance Instance { get; }
+
+    public Memory Memory { get; }
+
+    public WasmAbiFeatures AbiFeatures { get; }
+
+    /// <summary>
+    /// True when scripts run through <c>eval_js_shared</c> (runtime kept, fresh context per script).
+    /// </summary>
+    public bool UsesSharedRuntime { get; }
+
+    /// <summary>
+    /// True when scripts can be evaluated in several steps (bootstrap segments, then user code)
+    /// within one context via <see cref="BeginContext"/>.
+    /// </summary>
+    public bool SupportsContexts => _contextCreate is not null;
+
+    /// <summary>
+    /// True when the module can compile source to bytecode and replay it (<see cref="Compile"/>).
+    /// </summary>
+    public bool SupportsBytecode => _compile is not null;
+
+    /// <summary>
+    /// True when host-call responses larger than the guest's buffer can be delivered whole.
+    /// </summary>
+    public bool CanGrowResponseBuffer => _growResponseBuffer is not null;
+
+    /// <summary>
+    /// True when scripts can await host calls made through <c>__host.bridgeAsync</c>
+    /// (<see cref="TryEvaluate(string, out string)"/>, <see cref="TryCompleteHostCall"/>).
+    /// </summary>
+    public bool SupportsAsyncHostCalls => _completeHostCall is not null;
+
+    /// <summary>
+    /// True when compiled function expressions can be called with a JSON argument (<see cref="TryCall"/>).
+    /// </summary>
+    public bool SupportsPreparedCalls => _contextCallBytecode is not null;
+
+    /// <summary>
+    /// Bytes QuickJS currently has allocated in this instance, or null for modules without a
+    /// tracked allocator. Unlike <see cref="Memory"/>'s length this shrinks again after GC.
+    /// </summary>
+    public long? HeapBytesInUse => _getHeapInUse is null ? null : _getHeapInUse();
+
+    /// <summary>
+    /// Heap statistics of the open context's runtime, or null for modules that cannot compute
+    /// them. Walks the whole QuickJS heap, and resets the peak reported by the next call.
+    /// </summary>
+    public GuestMemoryStats? ReadMemoryStats()
+    {
+        var ptr = _getMemoryStats is null ? 0 : Call(_getMemoryStats);
+        if (ptr == 0)
+        {
+            return null;
+        }
+
+        // int64 slots in the order of the guest's MEMORY_STAT_* enum
+        return new GuestMemoryStats(
+            Memory.ReadInt64(ptr),
+            Memory.ReadInt64(ptr + 8),
+            Memory.ReadInt64(ptr + 16),
+            Memory.ReadInt64(ptr + 24),
+            Memory.ReadInt64(ptr + 32),
+            Memory.ReadInt64(ptr + 40),
+            Memory.ReadInt64(ptr + 48),
+            Memory.ReadInt64(ptr + 56));
+    }
+
+    /// <summary>
+    /// True when the guest can stop a script at a deadline itself (<see cref="SetInterruptDeadline"/>),
+    /// leaving the instance usable instead of trapping it.
+    /// </summary>
+    public bool SupportsCooperativeTimeouts => _setInterruptDeadline is not null && _wasInterrupted is not null;
+
+    /// <summary>
+    /// Arms the guest's deadline <paramref name="timeoutMs"/> from now, or disarms it with 0.
+    /// A script still running then fails with an uncatchable "interrupted" error.
+    /// </summary>
+    public void SetInterruptDeadline(int timeoutMs)
+    {
+        if (_setInterruptDeadline is not null)
+        {
+            _setInterruptDeadline(timeoutMs);
+        }
+    }
+
+    /// <summary>
+    /// True when the last armed deadline passed and interrupted the script.
+    /// </summary>
+    public bool WasInterrupted => _wasInterrupted is not null && Call(_wasInterrupted) != 0;
+
+    /// <summary>
+    /// True when the module can sample JavaScript stacks (<see cref="StartProfiling"/>).
+    /// </summary>
+    public bool SupportsProfiling => _setProfiler is not null && _getProfile is not null;
+
+    /// <summary>
+    /// Starts sampling the stack of the open context, discarding earlier samples.
+    /// </summary>
+    public void StartProfiling(TimeSpan sampleInterval)
+    {
+        if (_setProfiler is not null)
+        {
+            // 10 ticks per microsecond
+            _setProfiler((int)Math.Min(int.MaxValue, Math.Max(1, sampleInterval.Ticks / 10)));
+        }
+    }
+
+    /// <summary>
+    /// Stops sampling and returns the samples taken since <see cref="StartProfiling"/>.
+    /// </summary>
+    public ScriptProfile? StopProfiling(TimeSpan sampleInterval)
+    {
+        if (_setProfiler is null || _getProfile is null)
+        {
+            return null;
+        }
+
+        _setProfiler(0);
+        // int32 slots in the order of the guest's PROFILE_SLOT_* enum
+        var info = Call(_getProfile);
+        var data = Memory.ReadInt32(info);
+        var length = Memory.ReadInt32(info + 4);
+        var dropped = Memory.ReadInt32(info + 12);
+        var records = data == 0 || length <= 0
+            ? Array.Empty<byte>()
+            : Memory.GetSpan(data, length).ToArray();
+        return ScriptProfile.Parse(records, sampleInterval, dropped);
+    }
+
+    /// <summary>
+    /// When set, script results (<see cref="TryEvaluate(string, out object?)"/> and
+    /// <see cref="TryCompleteHostCall"/>) arrive as MessagePack and are decoded to .NET values
+    /// instead of JSON text. Stays false for modules that cannot encode them.
+    /// </summary>
+    public bool StructuredResults
+    {
+        get => _structuredResults;
+        set => _structuredResults = value
+                                    && _getResultRegion is not null
+                                    && (AbiFeatures & WasmAbiFeatures.BinaryResults) != 0;
+    }
+
+    /// <summary>
+    /// Number of scripts evaluated on this instance.
+    /// </summary>
+    public int UseCount { get; private set; }
+
+    /// <summary>
+    /// Set when the guest trapped, reported an internal failure or was retired. Faulted instances are never reused.
+    /// </summary>
+    public bool IsFaulted { get; private set; }
+
+    /// <summary>
+    /// Set when a timed-out script is still running on this instance. Ownership has moved
+    /// to the running task, which disposes the instance once it finishes.
+    /// </summary>
+    public bool IsAbandoned => Volatile.Read(ref _abandoned) != 0;
+
+    /// <summary>
+    /// Receives console output of the script currently running on this instance.
+    /// </summary>
+    public ScriptLog? LogSink { get; set; }
+
+    /// <summary>
+    /// Receives the async host calls started by the script currently running on this instance.
+    /// </summary>
+    public AsyncHostCalls? HostCalls { get; set; }
+
+    /// <summary>
+    /// Streams opened by the script currently running on this instance.
+    /// </summary>
+    public HostStreamTable? Streams { get; set; }
+
+    /// <summary>
+    /// Evaluates <paramref name="jsCode"/> and returns its string result.
+    /// </summary>
+    /// <exception cref="InvalidOperationException">The script threw or the guest reported an error.</exception>
+    public string Evaluate(string jsCode)
+    {
+        if (_disposed)
+        {
+            throw new ObjectDisposedException(nameof(WasmInstance));
+        }
+
+        UseCount++;
+        CheckStatus(EvaluateInput(jsCode, _eval));
+        using var phase = ScriptBoxDiagnostics.StartPhase("result");
+        return ReadResultMessage();
+    }
+
+    /// <summary>
+    /// Asks the guest for a host-call response buffer of at least <paramref name="length"/> bytes.
+    /// Only valid while a host call is in progress.
+    /// </summary>
+    /// <returns>Address of the buffer, or 0 if the guest could not allocate it.</returns>
+    public int GrowResponseBuffer(int length)
+    {
+        var grow = _growResponseBuffer ?? throw new NotSupportedException("WASM module cannot grow the response buffer");
+        return grow(length);
+    }
+
+    /// <summary>
+    /// Opens a fresh JavaScript context for a multi-step evaluation. Pair with <see cref="EndContext"/>.
+    /// </summary>
+    public void BeginContext()
+    {
+        var contextCreate = _contextCreate ?? throw new NotSupportedException("WASM module does not support the context API");
+
+        UseCount++;
+        CheckStatus(Call(contextCreate));
+    }
+
+    /// <summary>
+    /// Evaluates source in the context opened by <see cref="BeginContext"/>.
+    /// </summary>
+    /// <returns>The string result, or null when <paramref name="discardResult"/> is set.</returns>
+    public string? EvaluateInContext(string jsCode, bool discardResult)
+    {
+        var contextEval = _contextEval ?? throw new NotSupportedException("WASM module does not support the context API");
+
+        var flags = EvalFlags(discardResult);
+        CheckStatus(EvaluateInput(jsCode, (ptr, len) => contextEval(ptr, len, flags)));
+        return discardResult ? null : ReadResultMessage();
+    }
+
+    /// <summary>
+    /// Runs bytecode produced by <see cref="Compile"/> in the context opened by <see cref="BeginContext"/>.
+    /// </summary>
+    /// <returns>The string result, or null when <paramref name="discardResult"/> is set.</returns>
+    public string? EvaluateBytecode(byte[] bytecode, bool discardResult)
+    {
+        var contextEvalBytecode = _contextEvalBytecode ?? throw new NotSupportedException("WASM module does not support bytecode");
+
+        var flags = EvalFlags(discardResult);
+        var ptr = ReserveInput(bytecode.Length);
+        WasmMemory.Write(Memory, ptr, bytecode);
+        CheckStatus(CallWithInput(ptr, bytecode.Length, (p, len) => contextEvalBytecode(p, len, flags)));
+        return discardResult ? null : ReadResultMessage();
+    }
+
+    /// <summary>
+    /// Evaluates a script in the context opened by <see cref="BeginContext"/>. A promise result is
+    /// settled first when the module supports async host calls.
+    /// </summary>
+    /// <returns>
+    /// False while the promise waits on calls in <see cref="HostCalls"/>; pass their responses to
+    /// <see cref="TryCompleteHostCall"/>.
+    /// </returns>
+    public bool TryEvaluate(string jsCode, out object? result)
+    {
+        var contextEval = _contextEval ?? throw new NotSupportedException("WASM module does not support the context API");
+
+        var flags = ScriptFlags;
+        return CompleteStatus(EvaluateInput(jsCode, (ptr, len) => contextEval(ptr, len, flags)), out result);
+    }
+
+    /// <summary>
+    /// Runs bytecode produced by <see cref="Compile"/> like <see cref="TryEvaluate(string, out object?)"/>.
+    /// </summary>
+    public bool TryEvaluate(byte[] bytecode, out object? result)
+    {
+        var contextEvalBytecode = _contextEvalBytecode ?? throw new NotSupportedException("WASM module does not support bytecode");
+
+        var flags = ScriptFlags;
+        var ptr = ReserveInput(bytecode.Length);
+        WasmMemory.Write(Memory, ptr, bytecode);
+        return CompleteStatus(CallWithInput(ptr, bytecode.Length, (p, len) => contextEvalBytecode(p, len, flags)), out result);
+    }
+
+    /// <summary>
+    /// Runs bytecode of a function expression in the context opened by <see cref="BeginContext"/> and
+    /// calls the function with <paramref name="argumentJson"/> parsed in the guest. The result is
+    /// handled like <see cref="TryEvaluate(string, out object?)"/>.
+    /// </summary>
+    public bool TryCall(byte[] bytecode, string argumentJson, out object? result)
+    {
+        var contextCallBytecode = _contextCallBytecode ?? throw new NotSupportedException("WASM module does not support prepared calls");
+
+        var flags = ScriptFlags;
+        var argumentBytes = Encoding.UTF8.GetByteCount(argumentJson);
+        var ptr = ReserveInput(bytecode.Length + argumentBytes);
+        WasmMemory.Write(Memory, ptr, bytecode);
+        WasmMemory.WriteUtf8(Memory, ptr + bytecode.Length, argumentJson, argumentBytes);
+        return CompleteStatus(
+            CallWithInput(ptr, bytecode.Length + argumentBytes, (p, _) => contextCallBytecode(p, bytecode.Length, argumentBytes, flags)),
+            out result);
+    }
+
+    /// <summary>
+    /// Delivers the response of a pending async host call and lets the awaiting script continue.
+    /// </summary>
+    /// <returns>False while the script still waits on other host calls.</returns>
+    public bool TryCompleteHostCall(int callId, string response, out object? result)
+    {
+        var completeHostCall = _completeHostCall ?? throw new NotSupportedException("WASM module does not support async host calls");
+
+        var byteCount = Encoding.UTF8.GetByteCount(response);
+        var ptr = ReserveInput(byteCount);
+        WasmMemory.WriteUtf8(Memory, ptr, response, byteCount);
+        return CompleteStatus(CallWithInput(ptr, byteCount, (p, len) => completeHostCall(callId, p, len)), out result);
+    }
+
+    /// <summary>
+    /// Frees the context opened by <see cref="BeginContext"/>. Skipped on faulted instances.
+    /// </summary>
+    public void EndContext()
+    {
+        if (_contextFree is null || IsFaulted || _disposed)
+        {
+            return;
+        }
+
+        Call(() =>
+        {
+            _contextFree();
+            return 0;
+        });
+    }
+
+    /// <summary>
+    /// Compiles source to QuickJS bytecode without running it. The bytecode can be replayed
+    /// on any instance of the same module.
+    /// </summary>
+    /// <exception cref="InvalidOperationException">The source has a syntax error.</exception>
+    public byte[] Compile(string jsCode)
+    {
+        var compile = _compile ?? throw new NotSupportedException("WASM module does not support bytecode");
+
+        CheckStatus(EvaluateInput(jsCode, compile));
+
+        var ptr = _getBytecodePtr!();
+        var bytecodeLen = _getBytecodeLen!();
+        return Memory.GetSpan(ptr, bytecodeLen).ToArray();
+    }
+
+    /// <summary>
+    /// Applies a QuickJS heap limit and GC threshold (null: QuickJS defaults) to every runtime
+    /// of this instance. Returns false, changing nothing, when the module cannot enforce them.
+    /// </summary>
+    public bool SetMemoryLimits(long? heapLimitBytes, long? gcThresholdBytes)
+    {
+        if (_setMemoryLimits is null)
+        {
+            return false;
+        }
+
+        // The guest reads both as unsigned 32-bit values
+        _setMemoryLimits(unchecked((int)(uint)(heapLimitBytes ?? 0)), unchecked((int)(uint)(gcThresholdBytes ?? 0)));
+        return true;
+    }
+
+    /// <summary>
+    /// Sets how many epoch ticks guest code may run before Wasmtime interrupts it.
+    /// Only meaningful when the engine was created with epoch interruption.
+    /// </summary>
+    public void SetEpochDeadline(ulong ticks)
+    {
+        _store.SetEpochDeadline(ticks);
+    }
+
+    /// <summary>
+    /// Fuel left in the store. Only valid when the engine was created with fuel consumption.
+    /// </summary>
+    public ulong Fuel
+    {
+        get => _store.Fuel;
+        set => _store.Fuel = value;
+    }
+
+    /// <summary>
+    /// Marks a healthy instance as not reusable, e.g. because it grew past a memory limit.
+    /// The pool disposes it when it is returned.
+    /// </summary>
+    public void Retire()
+    {
+        IsFaulted = true;
+    }
+
+    /// <summary>
+    /// Hands the instance over to a script that outlived its timeout; it is disposed when the script ends.
+    /// </summary>
+    public void Abandon(Task running)
+    {
+        IsFaulted = true;
+        Interlocked.Exchange(ref _abandoned, 1);
+        running.ContinueWith(_ => Dispose(), CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+    }
+
+    public void Dispose()
+    {
+        if (_disposed)
+        {
+            return;
+        }
+
+        _disposed = true;
+        LogSink = null;
+        HostCalls = null;
+        Streams = null;
+        _store.Dispose();
+        _linker.Dispose();
+    }
+
+    private static int EvalFlags(bool discardResult) =>
+        discardResult ? WasmConfiguration.EvalFlagDiscardResult : 0;
+
+    private int ScriptFlags =>
+        (_completeHostCall is not null ? WasmConfiguration.EvalFlagAwaitResult : 0)
+        | (_structuredResults ? WasmConfiguration.EvalFlagBinaryResult : 0);
+
+    /// <summary>
+    /// Reads the result of a finished evaluation, or reports that it waits on host calls.
+    /// </summary>
+    private bool CompleteStatus(int status, out object? result)
+    {
+        if (status == WasmConfiguration.PendingStatusCode && _completeHostCall is not null)
+        {
+            result = null;
+            return false;
+        }
+
+        CheckStatus(status);
+        using var phase = ScriptBoxDiagnostics.StartPhase("result");
+        result = _structuredResults ? ReadStructuredResult() : ReadResultMessage();
+        return true;
+    }
+
+    /// <summary>
+    /// Invokes a guest export, marking the instance faulted if it traps.
+    /// </summary>
+    private int Call(Func<int> export)
+    {
+        try
+        {
+            return export();
+        }
+        catch
+        {
+            // Traps (including those raised by host callbacks) leave the guest in an unknown state
+            IsFaulted = true;
+            throw;
+        }
+    }
+
+    private void CheckStatus(int status)
+    {
+        if (status == WasmConfiguration.SuccessStatusCode)
+        {
+            return;
+        }
+
+        if (status != WasmConfiguration.ScriptExceptionStatusCode)
+        {
+            IsFaulted = true;
+        }
+
+        var errorMessage = ReadErrorMessage();
+        throw new InvalidOperationException(
+            $"eval_js failed with status {status}. Error: {errorMessage}");
+    }
+
+    private Func<int> RequireFunction(string name)
+    {
+        return Instance.GetFunction<int>(name)
+               ?? throw new InvalidOperationException($"{name} function not found");
+    }
+
+    /// <summary>
+    /// Encodes JavaScript source as UTF-8 straight into guest input memory and passes it to
+    /// <paramref name="export"/> as <c>(ptr, len)</c>.
+    /// </summary>
+    /// <returns>The status returned by the export.</returns>
+    private int EvaluateInput(string jsCode, Func<int, int, int> export)
+    {
+        var byteCount = Encoding.UTF8.GetByteCount(jsCode);
+        var ptr = ReserveInput(byteCount);
+        WasmMemory.WriteUtf8(Memory, ptr, jsCode, byteCount);
+        return CallWithInput(ptr, byteCount, export);
+    }
+
+    /// <summary>
+    /// Runs <paramref name="export"/> on input written at <paramref name="ptr"/>, then releases
+    /// the guest allocation holding it.
+    /// </summary>
+    private int CallWithInput(int ptr, int length, Func<int, int, int> export)
+    {
+        try
+        {
+            return Call(() => export(ptr, length));
+        }
+        finally
+        {
+            if (_freeInput is not null && !IsFaulted)
+            {
+                _freeInput();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns guest memory for <paramref name="byteCount"/> bytes of input: a right-sized,
+    /// NUL-terminated <c>alloc_input</c> buffer, or the fixed script buffer of older modules.
+    /// </summary>
+    private int ReserveInput(int byteCount)
+    {
+        if (_allocInput is null)
+        {
+            if (byteCount > _scriptBufferLen)
+            {
+                throw new InvalidOperationException(
+                    $"Script too large ({byteCount} bytes) for available WASM memory " +
+                    $"(max {_scriptBufferLen} bytes)");
+            }
+
+            return _scriptBufferPtr;
+        }
+
+        var ptr = Call(() => _allocInput(byteCount));
+        if (ptr == 0)
+        {
+            throw new InvalidOperationException(
+                $"Script too large ({byteCount} bytes) for available WASM memory");
+        }
+
+        return ptr;
+    }
+
+    /// <summary>
+    /// Reads the error message from WASM memory after evaluation.
+    /// </summary>
+    private string ReadErrorMessage()
+    {
+        int errorPtr = _getErrorPtr();
+        int errorLen = _getErrorLen();
+
+        if (errorLen <= 0)
+        {
+            return string.Empty;
+        }
+
+        return WasmMemory.ReadUtf8(Memory, errorPtr, errorLen);
+    }
+
+    /// <summary>
+    /// Reads the result value from WASM memory after successful evaluation.
+    /// </summary>
+    private string ReadResultMessage()
+    {
+        if (_getResultRegion is not null)
+        {
+            return ReadResultRegion();
+        }
+
+        int resultPtr = _getResultPtr();
+        int resultLen = _getResultLen();
+
+        if (resultLen <= 0)
+        {
+            return string.Empty;
+        }
+
+        return WasmMemory.ReadUtf8(Memory, resultPtr, resultLen);
+    }
+
+    /// <summary>
+    /// Decodes the length-prefixed result straight from linear memory, then lets the guest free it.
+    /// </summary>
+    private string ReadResultRegion()
+    {
+        var regionPtr = _getResultRegion!();
+        if (regionPtr == 0)
+        {
+            return string.Empty;
+        }
+
+        try
+        {
+            var length = Memory.ReadInt32(regionPtr);
+            return WasmMemory.ReadUtf8(Memory, regionPtr + WasmConfiguration.ResultRegionHeaderSize, length);
+        }
+        finally
+        {
+            _freeResult!();
+        }
+    }
+
+    /// <summary>
+    /// Decodes a MessagePack result (<see cref="WasmConfiguration.EvalFlagBinaryResult"/>) from the
+    /// result region, then lets the guest free it.
+    /// </summary>
+    private object? ReadStructuredResult()
+    {
+        var regionPtr = _getResultRegion!();
+        if (regionPtr == 0)
+        {
+            return null;
+        }
+
+        byte[] encoded;
+        try
+        {
+            var length = Memory.ReadInt32(regionPtr);
+            encoded = Memory.GetSpan(regionPtr + WasmConfiguration.ResultRegionHeaderSize, length).ToArray();
+        }
+        finally
+        {
+            _freeResult!();
+        }
+
+        return encoded.Length == 0 ? null : new MessagePackReader(encoded, 0).ReadObject();
+    }
+
+    /// <summary>
+    /// Determines the location and size of the script buffer in WASM memory.
+    /// Prefers dynamic lookup via exported functions, falls back to hardcoded defaults.
+    /// </summary>
+    private static (int ptr, int len) GetScriptBufferLocation(Instance instance)
+    {
+        // Try to get the dynamic script buffer from the WASM module
+        var getScriptBufferPtr = instance.GetFunction<int>(WasmConfiguration.GetScriptBufferPtrFunctionName);
+        var getScriptBufferLen = instance.GetFunction<int>(WasmConfiguration.GetScriptBufferLenFunctionName);
+
+        if (getScriptBufferPtr != null && getScriptBufferLen != null)
+        {
+            return (getScriptBufferPtr(), getScriptBufferLen());
+        }
+
+        // Fallback to hardcoded offset for backward compatibility with older WASM modules
+        return (WasmConfiguration.ScriptMemoryOffset,
+                WasmConfiguration.MaxScriptSize - WasmConfiguration.ScriptMemoryOffset);
+    }
+}
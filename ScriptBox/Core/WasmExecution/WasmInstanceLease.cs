@@ -0,0 +1,139 @@
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Holds one pooled <see cref="WasmInstance"/> for the lifetime of a <see cref="ScriptSession"/>.
+/// The instance is rented on first use and replaced transparently if it faults.
+/// Scripts still run in a fresh JavaScript context each time unless the lease persists state;
+/// then the context opened by the first script stays open for the following ones, and is
+/// freed when the lease is disposed or its instance is replaced. An instance holding that state
+/// is exempt from use-count recycling; it is only replaced when a script faults it, and that
+/// script reports the error.
+/// </summary>
+internal sealed class WasmInstanceLease : IDisposable
+{
+    private readonly WasmInstancePool _pool;
+    private WasmInstance? _instance;
+    private bool _disposed;
+
+    internal WasmInstanceLease(WasmInstancePool pool, bool persistState = false, long? maxMemoryBytes = null)
+    {
+        _pool = pool;
+        PersistsState = persistState;
+        MaxMemoryBytes = maxMemoryBytes;
+    }
+
+    /// <summary>
+    /// Keep one JavaScript context across the scripts of this lease.
+    /// </summary>
+    internal bool PersistsState { get; }
+
+    /// <summary>
+    /// Largest linear memory the leased instance may reach while it holds session state.
+    /// </summary>
+    internal long? MaxMemoryBytes { get; }
+
+    /// <summary>
+    /// The leased instance while its open context holds this session's state; null before the
+    /// first script and after the state was discarded. Call while holding <see cref="Gate"/>.
+    /// </summary>
+    internal WasmInstance? StateInstance { get; set; }
+
+    /// <summary>
+    /// Serializes scripts that share this lease. Instances run one script at a time;
+    /// a semaphore rather than a lock because scripts await host calls while holding it.
+    /// </summary>
+    internal SemaphoreSlim Gate { get; } = new(1, 1);
+
+    /// <summary>
+    /// Returns the leased instance, renting a new one if needed. Call while holding <see cref="Gate"/>.
+    /// </summary>
+    internal WasmInstance Acquire()
+    {
+        if (_disposed)
+        {
+            throw new ObjectDisposedException(nameof(WasmInstanceLease));
+        }
+
+        if (_instance is not null && !CanKeep(_instance))
+        {
+            Detach();
+        }
+
+        return _instance ??= _pool.Rent();
+    }
+
+    /// <summary>
+    /// Drops the current instance if it faulted, timed out or is due for recycling.
+    /// Call while holding <see cref="Gate"/>.
+    /// </summary>
+    internal void Release(WasmInstance instance)
+    {
+        if (ReferenceEquals(_instance, instance) && !CanKeep(instance))
+        {
+            Detach();
+        }
+    }
+
+    /// <summary>
+    /// Frees the lease without blocking. A script may hold <see cref="Gate"/> across awaited host
+    /// calls, so waiting for it here could deadlock; the instance then goes back to the pool once
+    /// that script finishes.
+    /// </summary>
+    public void Dispose()
+    {
+        _ = DisposeAsync();
+    }
+
+    /// <summary>
+    /// Frees the lease once the script running on it, if any, has finished.
+    /// </summary>
+    public async Task DisposeAsync()
+    {
+        await Gate.WaitAsync().ConfigureAwait(false);
+        try
+        {
+            if (_disposed)
+            {
+                return;
+            }
+
+            _disposed = true;
+            Detach();
+        }
+        finally
+        {
+            Gate.Release();
+        }
+    }
+
+    /// <summary>
+    /// True while the lease may keep <paramref name="instance"/>. Recycling it by use count would
+    /// silently drop the session's state, so an instance holding state stays until it faults.
+    /// </summary>
+    private bool CanKeep(WasmInstance instance)
+    {
+        return ReferenceEquals(StateInstance, instance)
+            ? !instance.IsFaulted && !instance.IsAbandoned
+            : _pool.CanReuse(instance);
+    }
+
+    private void Detach()
+    {
+        var instance = _instance;
+        _instance = null;
+        if (instance is not null)
+        {
+            if (ReferenceEquals(StateInstance, instance))
+            {
+                // Frees the session's globals before the instance serves anyone else
+                instance.EndContext();
+            }
+
+            StateInstance = null;
+            _pool.Return(instance);
+        }
+    }
+}
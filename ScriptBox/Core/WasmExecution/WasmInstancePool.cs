@@ -0,0 +1,188 @@
+using System.Collections.Concurrent;
+using System.Threading;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Keeps warm <see cref="WasmInstance"/>s so scripts skip linking and instantiation.
+/// Instances that faulted, were abandoned after a timeout or reached their use limit
+/// are disposed instead of being returned to the idle set.
+/// When a minimum is configured, a background task tops the idle set back up after
+/// rents, so bursts are served from ready instances instead of instantiating inline.
+/// </summary>
+internal sealed class WasmInstancePool : IDisposable
+{
+    private readonly Func<WasmInstance> _factory;
+    private readonly ConcurrentBag<WasmInstance> _idle = new();
+    private readonly int _minIdle;
+    private readonly int _maxIdle;
+    private readonly int _maxUsesPerInstance;
+    private int _idleCount;
+    private int _refilling;
+    private int _disposed;
+
+    /// <param name="factory">Creates a linked, instantiated module.</param>
+    /// <param name="minIdle">Idle instances to keep ready; refilled in the background.</param>
+    /// <param name="maxIdle">Idle instances retained at most; extra returns are disposed.</param>
+    /// <param name="maxUsesPerInstance">Scripts an instance may run before it is recycled.</param>
+    public WasmInstancePool(Func<WasmInstance> factory, int minIdle, int maxIdle, int maxUsesPerInstance)
+    {
+        _factory = factory ?? throw new ArgumentNullException(nameof(factory));
+        _minIdle = minIdle;
+        _maxIdle = Math.Max(minIdle, maxIdle);
+        _maxUsesPerInstance = maxUsesPerInstance;
+    }
+
+    /// <summary>
+    /// Number of instances currently waiting to be rented.
+    /// </summary>
+    public int IdleCount => Volatile.Read(ref _idleCount);
+
+    /// <summary>
+    /// Takes an idle instance, or creates one when none is available.
+    /// </summary>
+    public WasmInstance Rent()
+    {
+        if (Volatile.Read(ref _disposed) != 0)
+        {
+            throw new ObjectDisposedException(nameof(WasmInstancePool));
+        }
+
+        if (_idle.TryTake(out var instance))
+        {
+            Interlocked.Decrement(ref _idleCount);
+            RequestRefill();
+            return instance;
+        }
+
+        RequestRefill();
+        return _factory();
+    }
+
+    /// <summary>
+    /// Starts a background refill if the idle set is below the configured minimum.
+    /// At most one refill task runs at a time.
+    /// </summary>
+    public void RequestRefill()
+    {
+        if (_minIdle == 0 || Volatile.Read(ref _disposed) != 0 || IdleCount >= _minIdle)
+        {
+            return;
+        }
+
+        if (Interlocked.CompareExchange(ref _refilling, 1, 0) != 0)
+        {
+            return;
+        }
+
+        Task.Run(Refill);
+    }
+
+    /// <summary>
+    /// Gives an instance back after a script finished running on it.
+    /// </summary>
+    public void Return(WasmInstance instance)
+    {
+        if (instance is null || instance.IsAbandoned)
+        {
+            // Abandoned instances are disposed by the task still running on them
+            return;
+        }
+
+        if (Volatile.Read(ref _disposed) != 0 || !CanReuse(instance))
+        {
+            instance.Dispose();
+            RequestRefill();
+            return;
+        }
+
+        AddIdle(instance);
+    }
+
+    /// <summary>
+    /// True while the instance may run further scripts.
+    /// </summary>
+    public bool CanReuse(WasmInstance instance)
+    {
+        return !instance.IsFaulted
+               && !instance.IsAbandoned
+               && instance.UseCount < _maxUsesPerInstance;
+    }
+
+    /// <summary>
+    /// Creates a lease that keeps one instance for a caller across several scripts.
+    /// </summary>
+    /// <param name="persistState">Keep the JavaScript context, and so the script state, between scripts.</param>
+    /// <param name="maxMemoryBytes">With <paramref name="persistState"/>, the linear memory at which the state is discarded.</param>
+    public WasmInstanceLease CreateLease(bool persistState = false, long? maxMemoryBytes = null) =>
+        new(this, persistState, maxMemoryBytes);
+
+    public void Dispose()
+    {
+        if (Interlocked.Exchange(ref _disposed, 1) != 0)
+        {
+            return;
+        }
+
+        DrainIdle();
+    }
+
+    private void AddIdle(WasmInstance instance)
+    {
+        if (Interlocked.Increment(ref _idleCount) > _maxIdle)
+        {
+            Interlocked.Decrement(ref _idleCount);
+            instance.Dispose();
+            return;
+        }
+
+        instance.LogSink = null;
+        instance.HostCalls = null;
+        instance.Streams = null;
+        _idle.Add(instance);
+
+        // Dispose raced with the return; make sure nothing stays behind
+        if (Volatile.Read(ref _disposed) != 0)
+        {
+            DrainIdle();
+        }
+    }
+
+    private void Refill()
+    {
+        try
+        {
+            while (Volatile.Read(ref _disposed) == 0 && IdleCount < _minIdle)
+            {
+                WasmInstance instance;
+                try
+                {
+                    instance = _factory();
+                }
+                catch
+                {
+                    // Instantiation errors resurface on the next inline Rent; don't spin on them here
+                    return;
+                }
+
+                AddIdle(instance);
+            }
+        }
+        finally
+        {
+            Volatile.Write(ref _refilling, 0);
+        }
+
+        // A rent may have happened between the last check and clearing the flag
+        RequestRefill();
+    }
+
+    private void DrainIdle()
+    {
+        while (_idle.TryTake(out var instance))
+        {
+            Interlocked.Decrement(ref _idleCount);
+            instance.Dispose();
+        }
+    }
+}
@@ -0,0 +1,66 @@
+using System.Text;
+using Wasmtime;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Bulk transfers between host strings and guest linear memory.
+/// Every <c>Memory.Read</c>/<c>Memory.Write</c> call is a bounds-checked interop call, so the
+/// boundary helpers work on one <see cref="Memory.GetSpan(long, int)"/> per transfer instead
+/// and encode or decode UTF-8 in place.
+/// </summary>
+internal static class WasmMemory
+{
+    /// <summary>
+    /// Decodes <paramref name="length"/> bytes of UTF-8 at <paramref name="ptr"/>.
+    /// </summary>
+    public static string ReadUtf8(Memory memory, int ptr, int length)
+    {
+        if (length <= 0)
+        {
+            return string.Empty;
+        }
+
+        var bytes = memory.GetSpan(ptr, length);
+#if NETSTANDARD2_0
+        return Encoding.UTF8.GetString(bytes.ToArray());
+#else
+        return Encoding.UTF8.GetString(bytes);
+#endif
+    }
+
+    /// <summary>
+    /// Encodes <paramref name="value"/> as UTF-8 directly into guest memory.
+    /// </summary>
+    /// <param name="byteCount">
+    /// <c>Encoding.UTF8.GetByteCount(value)</c>, computed by the caller to check it against the
+    /// destination capacity.
+    /// </param>
+    public static void WriteUtf8(Memory memory, int ptr, string value, int byteCount)
+    {
+        if (byteCount == 0)
+        {
+            return;
+        }
+
+        var destination = memory.GetSpan(ptr, byteCount);
+#if NETSTANDARD2_0
+        Encoding.UTF8.GetBytes(value).AsSpan().CopyTo(destination);
+#else
+        Encoding.UTF8.GetBytes(value.AsSpan(), destination);
+#endif
+    }
+
+    /// <summary>
+    /// Copies <paramref name="bytes"/> into guest memory at <paramref name="ptr"/>.
+    /// </summary>
+    public static void Write(Memory memory, int ptr, ReadOnlySpan<byte> bytes)
+    {
+        if (bytes.IsEmpty)
+        {
+            return;
+        }
+
+        bytes.CopyTo(memory.GetSpan(ptr, bytes.Length));
+    }
+}
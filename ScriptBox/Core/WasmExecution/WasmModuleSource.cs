@@ -1,49 +1,118 @@
 using System;
 using System.IO;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
 using Wasmtime;
 
 namespace ScriptBox.Core.WasmExecution;
 
 /// <summary>
 /// Describes how to load the QuickJS WASM module. Either from disk or from
-/// an in-memory byte array supplied by the builder.
+/// an in-memory byte array supplied by the builder, as WebAssembly or as
+/// Wasmtime-precompiled native code (<c>.cwasm</c>, see <c>build.sh --precompile</c>).
 /// </summary>
 internal sealed class WasmModuleSource
 {
+    /// <summary>
+    /// File name pattern of precompiled modules in a <c>build.sh --precompile</c> output directory.
+    /// </summary>
+    public const string PrecompiledFileNameFormat = "scriptbox.{0}.cwasm";
+    public const string PrecompiledSnapshotFileNameFormat = "scriptbox.snapshot.{0}.cwasm";
+
     private readonly string? _path;
     private readonly byte[]? _moduleBytes;
     private readonly string _description;
+    private readonly bool _isPrecompiled;
+    private readonly WasmModuleSource? _fallback;
+    private string? _cacheKey;
 
-    private WasmModuleSource(string path)
+    private WasmModuleSource(string path, bool isPreinitialized)
     {
         _path = Path.GetFullPath(path);
         _description = $"file://{_path}";
+        IsPreinitialized = isPreinitialized;
     }
 
-    private WasmModuleSource(byte[] moduleBytes)
+    private WasmModuleSource(byte[] moduleBytes, bool isPreinitialized)
     {
         _moduleBytes = moduleBytes ?? throw new ArgumentNullException(nameof(moduleBytes));
-        _description = "in-memory module";
+        _description = isPreinitialized ? "in-memory snapshot module" : "in-memory module";
+        IsPreinitialized = isPreinitialized;
+    }
+
+    private WasmModuleSource(string path, bool isPreinitialized, WasmModuleSource? fallback)
+        : this(path, isPreinitialized)
+    {
+        _isPrecompiled = true;
+        _fallback = fallback;
+        _description = $"precompiled file://{_path}";
     }
 
-    public static WasmModuleSource FromPath(string path)
+    /// <summary>
+    /// True when the module is a snapshot produced by <c>build.sh --snapshot</c>:
+    /// the runtime, host bridge and core bootstrap are already initialized in its
+    /// linear memory, so the host must not prepend the core bootstrap again.
+    /// </summary>
+    public bool IsPreinitialized { get; }
+
+    /// <summary>
+    /// Identifies the code this source loads, for sharing one compiled module between executors:
+    /// a hash of in-memory bytes, or the path with the file's size and write time, so a rebuilt
+    /// file is compiled again.
+    /// </summary>
+    public string CacheKey => _cacheKey ??= CreateCacheKey();
+
+    public static WasmModuleSource FromPath(string path, bool isPreinitialized = false)
     {
         if (string.IsNullOrWhiteSpace(path))
         {
             throw new ArgumentException("WASM path cannot be null or empty", nameof(path));
         }
 
-        return new WasmModuleSource(path);
+        return new WasmModuleSource(path, isPreinitialized);
     }
 
-    public static WasmModuleSource FromBytes(ReadOnlyMemory<byte> bytes)
+    /// <summary>
+    /// Loads a module precompiled with <c>wasmtime compile</c>. <paramref name="path"/> may be a
+    /// <c>.cwasm</c> file or a <c>build.sh --precompile</c> output directory, in which case the
+    /// artifact for the current OS and architecture is picked.
+    /// </summary>
+    /// <param name="path">Precompiled file or directory.</param>
+    /// <param name="fallback">
+    /// Loaded instead when the artifact is missing or was produced by an incompatible Wasmtime
+    /// version or target. Without a fallback those cases throw.
+    /// </param>
+    /// <param name="isPreinitialized">The artifact was compiled from a snapshot module.</param>
+    public static WasmModuleSource FromPrecompiledPath(string path, WasmModuleSource? fallback = null, bool isPreinitialized = false)
+    {
+        if (string.IsNullOrWhiteSpace(path))
+        {
+            throw new ArgumentException("Precompiled module path cannot be null or empty", nameof(path));
+        }
+
+        if (fallback is not null && fallback.IsPreinitialized != isPreinitialized)
+        {
+            throw new ArgumentException("Fallback module must match the precompiled module's pre-initialization", nameof(fallback));
+        }
+
+        if (Directory.Exists(path))
+        {
+            var triple = GetHostTargetTriple();
+            var format = isPreinitialized ? PrecompiledSnapshotFileNameFormat : PrecompiledFileNameFormat;
+            path = Path.Combine(path, string.Format(format, triple ?? "unknown"));
+        }
+
+        return new WasmModuleSource(path, isPreinitialized, fallback);
+    }
+
+    public static WasmModuleSource FromBytes(ReadOnlyMemory<byte> bytes, bool isPreinitialized = false)
     {
         if (bytes.IsEmpty)
         {
             throw new ArgumentException("WASM module bytes cannot be empty", nameof(bytes));
         }
 
-        return new WasmModuleSource(bytes.ToArray());
+        return new WasmModuleSource(bytes.ToArray(), isPreinitialized);
     }
 
     public Module CreateModule(Engine engine)
@@ -53,6 +122,11 @@ internal sealed class WasmModuleSource
             throw new ArgumentNullException(nameof(engine));
         }
 
+        if (_isPrecompiled)
+        {
+            return DeserializeModule(engine);
+        }
+
         if (_path is not null)
         {
             if (!File.Exists(_path))
@@ -72,4 +146,80 @@ internal sealed class WasmModuleSource
     }
 
     public override string ToString() => _description;
+
+    private string CreateCacheKey()
+    {
+        if (_moduleBytes is not null)
+        {
+            using var sha = SHA256.Create();
+            return "sha256:" + BitConverter.ToString(sha.ComputeHash(_moduleBytes)).Replace("-", string.Empty);
+        }
+
+        var file = new FileInfo(_path!);
+        var stamp = file.Exists ? $"{file.Length}:{file.LastWriteTimeUtc.Ticks}" : "missing";
+        var key = $"{(_isPrecompiled ? "precompiled" : "file")}:{_path}@{stamp}";
+        return _fallback is null ? key : $"{key}|{_fallback.CacheKey}";
+    }
+
+    /// <summary>
+    /// The Wasmtime (Rust) target triple of the current process, as passed to
+    /// <c>wasmtime compile --target</c>, or null on platforms without a prebuilt artifact.
+    /// </summary>
+    internal static string? GetHostTargetTriple()
+    {
+        var arch = RuntimeInformation.ProcessArchitecture switch
+        {
+            Architecture.X64 => "x86_64",
+            Architecture.Arm64 => "aarch64",
+            _ => null
+        };
+
+        if (arch is null)
+        {
+            return null;
+        }
+
+        if (RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
+        {
+            return $"{arch}-unknown-linux-gnu";
+        }
+
+        if (RuntimeInformation.IsOSPlatform(OSPlatform.OSX))
+        {
+            return $"{arch}-apple-darwin";
+        }
+
+        if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+        {
+            return $"{arch}-pc-windows-msvc";
+        }
+
+        return null;
+    }
+
+    /// <summary>
+    /// Maps precompiled native code instead of compiling. Wasmtime rejects artifacts from another
+    /// Wasmtime version, target or engine configuration; those fall back to the WebAssembly module.
+    /// </summary>
+    private Module DeserializeModule(Engine engine)
+    {
+        if (!File.Exists(_path))
+        {
+            if (_fallback is not null)
+            {
+                return _fallback.CreateModule(engine);
+            }
+
+            throw new FileNotFoundException($"Precompiled WASM module not found at {_path}");
+        }
+
+        try
+        {
+            return Module.DeserializeFile(engine, "scriptbox", _path!);
+        }
+        catch (WasmtimeException) when (_fallback is not null)
+        {
+            return _fallback.CreateModule(engine);
+        }
+    }
 }
@@ -0,0 +1,158 @@
+using System.Threading;
+using Wasmtime;
+
+namespace ScriptBox.Core.WasmExecution;
+
+/// <summary>
+/// Engine, compiled module and epoch ticker used by one or more executors. With
+/// <see cref="WasmExecutorOptions.ShareModule"/> executors that load the same module with the same
+/// engine settings get the same runtime, so the module is compiled once per process and every
+/// <see cref="ScriptBoxBuilder.Build"/> after the first only creates its host bridge and pool.
+/// Instances stay per executor: each has its own store, linker and linear memory.
+/// </summary>
+internal sealed class WasmRuntime : IDisposable
+{
+    private static readonly Dictionary<string, WasmRuntime> Shared = new(StringComparer.Ordinal);
+    private static readonly object SharedLock = new();
+
+    private readonly string? _key;
+    private readonly Timer? _epochTicker;
+    private int _references = 1;
+
+    private WasmRuntime(Engine engine, Module module, int? epochTickMs, string? key)
+    {
+        Engine = engine;
+        Module = module;
+        _key = key;
+        _epochTicker = epochTickMs is { } tickMs
+            ? new Timer(_ => engine.IncrementEpoch(), null, tickMs, tickMs)
+            : null;
+    }
+
+    public Engine Engine { get; }
+
+    public Module Module { get; }
+
+    /// <summary>
+    /// Runtimes alive in the process that were created for sharing.
+    /// </summary>
+    internal static int SharedCount
+    {
+        get
+        {
+            lock (SharedLock)
+            {
+                return Shared.Count;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns a runtime for <paramref name="source"/>; dispose it when done. Shared runtimes are
+    /// freed with their last user.
+    /// </summary>
+    public static WasmRuntime Acquire(WasmModuleSource source, WasmExecutorOptions options)
+    {
+        if (!options.ShareModule)
+        {
+            return Create(source, options, null);
+        }
+
+        var key = CreateKey(source, options);
+        // Compiling under the lock makes concurrent first builds of a module wait for one compile
+        lock (SharedLock)
+        {
+            if (Shared.TryGetValue(key, out var runtime))
+            {
+                runtime._references++;
+                return runtime;
+            }
+
+            runtime = Create(source, options, key);
+            Shared[key] = runtime;
+            return runtime;
+        }
+    }
+
+    public void Dispose()
+    {
+        if (_key is not null)
+        {
+            lock (SharedLock)
+            {
+                if (_references == 0 || --_references > 0)
+                {
+                    return;
+                }
+
+                Shared.Remove(_key);
+            }
+        }
+        else if (Interlocked.Exchange(ref _references, 0) == 0)
+        {
+            return;
+        }
+
+        _epochTicker?.Dispose();
+        Module.Dispose();
+        Engine.Dispose();
+    }
+
+    private static WasmRuntime Create(WasmModuleSource source, WasmExecutorOptions options, string? key)
+    {
+        var engine = CreateEngine(options);
+        try
+        {
+            var module = source.CreateModule(engine);
+            return new WasmRuntime(engine, module, options.EpochInterruption ? options.EpochTickMs : null, key);
+        }
+        catch
+        {
+            engine.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Creates the engine. Codegen settings stay at Wasmtime's defaults apart from epoch
+    /// interruption and fuel, which artifacts from <c>wasmtime compile</c> (build.sh --precompile)
+    /// must match to remain loadable with this engine.
+    /// </summary>
+    private static Engine CreateEngine(WasmExecutorOptions options)
+    {
+        if (!options.UseCompilationCache && !options.EpochInterruption && options.FuelPerScript is null)
+        {
+            return new Engine();
+        }
+
+        var config = new Config();
+        if (options.UseCompilationCache)
+        {
+            config = config.WithCacheConfig(options.CompilationCacheConfigPath);
+        }
+
+        if (options.EpochInterruption)
+        {
+            config = config.WithEpochInterruption(true);
+        }
+
+        if (options.FuelPerScript is not null)
+        {
+            config = config.WithFuelConsumption(true);
+        }
+
+        return new Engine(config);
+    }
+
+    /// <summary>
+    /// Everything that shapes the engine or the compiled code. The epoch tick is included because
+    /// executors turn their timeouts into tick counts of the shared ticker.
+    /// </summary>
+    private static string CreateKey(WasmModuleSource source, WasmExecutorOptions options)
+    {
+        var cache = options.UseCompilationCache ? options.CompilationCacheConfigPath ?? "default" : "none";
+        var epoch = options.EpochInterruption ? options.EpochTickMs.ToString(System.Globalization.CultureInfo.InvariantCulture) : "off";
+        var fuel = options.FuelPerScript is null ? "off" : "on";
+        return $"cache={cache};epoch={epoch};fuel={fuel};module={source.CacheKey}";
+    }
+}
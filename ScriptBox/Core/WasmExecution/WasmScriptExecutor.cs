@@ -1,6 +1,8 @@
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Text;
 using System.Text.Json;
+using System.Threading;
 using Wasmtime;
 using ScriptBox.Core.Configuration;
 using ScriptBox.Core.HostApi;
@@ -11,6 +13,10 @@ namespace ScriptBox.Core.WasmExecution;
 /// <summary>
 /// Executes JavaScript code within a QuickJS-in-WASM sandbox.
 /// Manages WASM module lifecycle, memory operations, and error handling.
+/// Module instances are pooled (<see cref="WasmInstancePool"/>); each script still
+/// runs in a fresh QuickJS context, see the isolation notes in ScriptBox.Wasm/README.md.
+/// On modules with the bytecode ABI, bootstrap code is compiled once into a
+/// <see cref="BootstrapArtifact"/> and user scripts are replayed from <see cref="BytecodeCache"/>.
 /// </summary>
 #if NET6_0_OR_GREATER
 internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IAsyncDisposable
@@ -19,20 +25,39 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IAsyncDisposable
 internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
 {
 #endif
+    /// <summary>
+    /// Methods answered by <see cref="HandleHostCall"/> itself; keep in step with its switch.
+    /// Host calls to anything else that is not registered are traced as unknown.
+    /// </summary>
+    private static readonly HashSet<string> BuiltInHostMethods = new(StringComparer.Ordinal)
+    {
+        "Log", "Add", "Subtract",
+        "FileSystemReadFile", "FileSystemWriteFile", "FileSystemListFiles", "FileSystemExists",
+        "FileSystemDelete", "FileSystemCreateDirectory", "FileSystemOpenRead",
+        "HttpGet", "HttpPost", "HttpRequest", "HttpOpen",
+        "StreamRead", "StreamClose",
+        "tool.invoke", "host.batch"
+    };
+
     private readonly IHostApi _hostApi;
     private readonly SandboxConfiguration _config;
     private readonly Dictionary<string, Func<HostCallContext, Task<object?>>> _jsonHandlers;
-    private readonly Engine _engine;
-    private readonly Module _module;
+    private readonly HostMethodTable _methodTable;
+    private readonly WasmRuntime _runtime;
     private readonly JsonSerializerOptions _jsonOptions;
     private readonly WasmModuleSource _moduleSource;
+    private readonly WasmExecutorOptions _options;
+    private readonly WasmInstancePool _instancePool;
+    private readonly BytecodeCache? _scriptBytecode;
+    private readonly Lazy<BootstrapArtifact> _startup;
     private bool _disposed;
 
     public WasmScriptExecutor(
         IHostApi? hostApi = null,
         SandboxConfiguration? config = null,
         IReadOnlyDictionary<string, Func<HostCallContext, Task<object?>>>? jsonHandlers = null,
-        WasmModuleSource? moduleSource = null)
+        WasmModuleSource? moduleSource = null,
+        WasmExecutorOptions? options = null)
     {
         _config = config ?? SandboxConfiguration.CreateDefault();
         _hostApi = hostApi ?? new HostApiImpl(_config);
@@ -44,9 +69,21 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
                 _jsonHandlers[kvp.Key] = kvp.Value;
             }
         }
+        _methodTable = HostMethodTable.Create(_jsonHandlers);
         _moduleSource = moduleSource ?? WasmModuleSource.FromBytes(DefaultRuntimeResources.LoadEmbeddedWasm());
-        _engine = new Engine();
-        _module = _moduleSource.CreateModule(_engine);
+        _options = options ?? WasmExecutorOptions.CreateDefault();
+        _options.Validate();
+        _scriptBytecode = _options.ScriptBytecodeCacheSize > 0
+            ? new BytecodeCache(_options.ScriptBytecodeCacheSize)
+            : null;
+        _startup = new Lazy<BootstrapArtifact>(LoadStartupJs);
+        _runtime = WasmRuntime.Acquire(_moduleSource, _options);
+        // Without reuse every instance runs one script; the pool then only pre-warms
+        _instancePool = new WasmInstancePool(
+            CreateInstance,
+            _options.MinIdleInstances,
+            _options.MaxIdleInstances,
+            _options.ReuseInstances ? _options.MaxUsesPerInstance : 1);
         
         // Initialize JSON serializer options with appropriate settings for the target framework
 #if NET6_0_OR_GREATER
@@ -60,6 +97,8 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
             PropertyNameCaseInsensitive = true
         };
 #endif
+
+        _instancePool.RequestRefill();
     }
 
     public WasmScriptExecutor(SandboxConfiguration? config)
@@ -67,77 +106,687 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
     {
     }
 
+    /// <summary>
+    /// IDs of the registered handlers; <see cref="HostMethodTable.BuildBootstrap"/> publishes them to scripts.
+    /// </summary>
+    internal HostMethodTable MethodTable => _methodTable;
+
+    /// <summary>
+    /// Features reported by the module's <c>get_abi_features</c>, read from a pooled instance.
+    /// </summary>
+    internal WasmAbiFeatures AbiFeatures
+    {
+        get
+        {
+            var instance = _instancePool.Rent();
+            try
+            {
+                return instance.AbiFeatures;
+            }
+            finally
+            {
+                _instancePool.Return(instance);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Fixes <paramref name="code"/> as a bootstrap for sessions of this executor and compiles it
+    /// on a pooled instance, so syntax errors surface here and no run compiles it again.
+    /// </summary>
+    /// <exception cref="InvalidOperationException">The code has a syntax error.</exception>
+    internal BootstrapArtifact CreateBootstrap(string? code)
+    {
+        if (string.IsNullOrWhiteSpace(code))
+        {
+            return BootstrapArtifact.Empty;
+        }
+
+        var artifact = new BootstrapArtifact(code!);
+        var instance = _instancePool.Rent();
+        try
+        {
+            if (instance.SupportsBytecode)
+            {
+                artifact.Compile(instance);
+            }
+        }
+        finally
+        {
+            _instancePool.Return(instance);
+        }
+
+        return artifact;
+    }
+
     /// <inheritdoc />
+    /// <remarks>
+    /// Runs the async pipeline on the thread pool, so waiting for it cannot deadlock a caller
+    /// that has a <see cref="SynchronizationContext"/>.
+    /// </remarks>
     public WasmExecutionResult ExecuteScript(string jsCode, int? timeoutMs = null)
+    {
+        return Task.Run(() => ExecuteScriptAsync(jsCode, timeoutMs)).GetAwaiter().GetResult();
+    }
+
+    /// <inheritdoc />
+    /// <remarks>
+    /// Runs the async pipeline on the thread pool, so waiting for it cannot deadlock a caller
+    /// that has a <see cref="SynchronizationContext"/>.
+    /// </remarks>
+    public WasmExecutionResult ExecuteScript(WasmInstanceLease lease, BootstrapArtifact? bootstrap, string jsCode, int? timeoutMs = null)
+    {
+        return Task.Run(() => ExecuteScriptAsync(lease, bootstrap, jsCode, timeoutMs)).GetAwaiter().GetResult();
+    }
+
+    /// <inheritdoc />
+    public async Task<WasmExecutionResult> ExecuteScriptAsync(string jsCode, int? timeoutMs = null, CancellationToken cancellationToken = default)
     {
         if (string.IsNullOrEmpty(jsCode))
         {
             throw new ArgumentException("JavaScript code cannot be null or empty.", nameof(jsCode));
         }
 
-        var effectiveTimeout = timeoutMs ?? WasmConfiguration.DefaultTimeoutMs;
+        var telemetry = ScriptBoxDiagnostics.StartScript();
+        var instance = _instancePool.Rent();
+        try
+        {
+            var result = await ExecuteOnInstanceAsync(instance, null, new UserScript(jsCode), timeoutMs, cancellationToken).ConfigureAwait(false);
+            telemetry.SetTag("success");
+            return result;
+        }
+        catch (Exception ex)
+        {
+            RecordFailure(ref telemetry, ex);
+            throw;
+        }
+        finally
+        {
+            _instancePool.Return(instance);
+            telemetry.Dispose();
+        }
+    }
+
+    /// <inheritdoc />
+    public async Task<WasmExecutionResult> ExecuteScriptAsync(
+        WasmInstanceLease lease,
+        BootstrapArtifact? bootstrap,
+        string jsCode,
+        int? timeoutMs = null,
+        CancellationToken cancellationToken = default)
+    {
+        if (lease is null)
+        {
+            throw new ArgumentNullException(nameof(lease));
+        }
+
+        if (string.IsNullOrEmpty(jsCode) && (bootstrap is null || bootstrap.IsEmpty))
+        {
+            throw new ArgumentException("JavaScript code cannot be null or empty.", nameof(jsCode));
+        }
+
+        return await ExecuteOnLeaseAsync(lease, bootstrap, new UserScript(jsCode), timeoutMs, cancellationToken).ConfigureAwait(false);
+    }
+
+    /// <inheritdoc />
+    public async Task<WasmExecutionResult> ExecuteScriptAsync(
+        WasmInstanceLease lease,
+        BootstrapArtifact? bootstrap,
+        PreparedScript script,
+        object? input,
+        int? timeoutMs = null,
+        CancellationToken cancellationToken = default)
+    {
+        if (lease is null)
+        {
+            throw new ArgumentNullException(nameof(lease));
+        }
+
+        if (script is null)
+        {
+            throw new ArgumentNullException(nameof(script));
+        }
+
+        var argumentJson = JsonSerializer.Serialize(input, _jsonOptions);
+        return await ExecuteOnLeaseAsync(lease, bootstrap, new UserScript(script, argumentJson), timeoutMs, cancellationToken).ConfigureAwait(false);
+    }
+
+    private async Task<WasmExecutionResult> ExecuteOnLeaseAsync(
+        WasmInstanceLease lease,
+        BootstrapArtifact? bootstrap,
+        UserScript script,
+        int? timeoutMs,
+        CancellationToken cancellationToken)
+    {
+        await lease.Gate.WaitAsync(cancellationToken).ConfigureAwait(false);
+        var telemetry = ScriptBoxDiagnostics.StartScript();
+        try
+        {
+            var instance = lease.Acquire();
+            try
+            {
+                var result = lease.PersistsState
+                    ? await ExecuteStatefulAsync(lease, instance, bootstrap, script, timeoutMs, cancellationToken).ConfigureAwait(false)
+                    : await ExecuteOnInstanceAsync(instance, bootstrap, script, timeoutMs, cancellationToken).ConfigureAwait(false);
+                telemetry.SetTag("success");
+                return result;
+            }
+            finally
+            {
+                lease.Release(instance);
+            }
+        }
+        catch (Exception ex)
+        {
+            RecordFailure(ref telemetry, ex);
+            throw;
+        }
+        finally
+        {
+            telemetry.Dispose();
+            lease.Gate.Release();
+        }
+    }
+
+    private static void RecordFailure(ref TelemetryScope telemetry, Exception exception)
+    {
+        telemetry.SetTag(exception switch
+        {
+            TimeoutException => "timeout",
+            OperationCanceledException => "cancelled",
+            _ => "error"
+        });
+        telemetry.SetError(exception);
+    }
+
+    /// <inheritdoc />
+    public WasmInstanceLease CreateLease(bool persistState = false, long? maxMemoryBytes = null) =>
+        _instancePool.CreateLease(persistState, maxMemoryBytes);
+
+    /// <summary>
+    /// Runs a script on a rented instance, enforcing the timeout.
+    /// Guest code runs in steps: the evaluation itself, then one step per async host call
+    /// response. No thread is held while the script waits on host calls.
+    /// A step that times out keeps running in the background, so its instance is abandoned.
+    /// </summary>
+    private async Task<WasmExecutionResult> ExecuteOnInstanceAsync(
+        WasmInstance instance,
+        BootstrapArtifact? bootstrap,
+        UserScript script,
+        int? timeoutMs,
+        CancellationToken cancellationToken)
+    {
+        cancellationToken.ThrowIfCancellationRequested();
+
+        var budget = new ExecutionBudget(timeoutMs ?? WasmConfiguration.DefaultTimeoutMs, _options.FuelPerScript);
+        var logs = new ScriptLog(_config.MaxLogEntries, _config.LogSampleRate);
+        using var hostCalls = new AsyncHostCalls(cancellationToken);
+        using var streams = new HostStreamTable(_config.MaxOpenStreams, _config.MaxStreamReadSize);
+        instance.LogSink = logs;
+        instance.HostCalls = hostCalls;
+        instance.Streams = streams;
+        var profiling = StartProfiling(instance);
 
-        if (effectiveTimeout > 0)
+        try
         {
-            // Use Task-based timeout for compatible timeout handling
-            var task = Task.Run(() => ExecuteScriptInternal(jsCode));
+            var startup = _startup.Value;
+            if (!instance.SupportsBytecode)
+            {
+                var result = await RunGuestAsync(
+                    instance,
+                    () =>
+                    {
+                        using var phase = ScriptBoxDiagnostics.StartPhase("evaluate");
+                        return instance.Evaluate(BuildFullScript(startup.Source, bootstrap?.Source, script.ToSource(async: false)));
+                    },
+                    budget).ConfigureAwait(false);
+                return new WasmExecutionResult(result, logs.Complete()) { Memory = CollectMemoryStats(instance) };
+            }
 
             try
             {
-                if (!task.Wait(effectiveTimeout))
+                var step = await RunGuestAsync(
+                    instance,
+                    () => EvaluateSegments(instance, startup, bootstrap, script),
+                    budget).ConfigureAwait(false);
+
+                while (!step.Completed)
                 {
-                    throw new TimeoutException(
-                        $"Script execution exceeded timeout limit of {effectiveTimeout}ms. " +
-                        "The script may have an infinite loop or is taking too long to complete.");
+                    var next = await hostCalls.WaitForNextAsync(budget.RemainingMs).ConfigureAwait(false)
+                               ?? throw budget.CreateTimeoutException();
+                    step = await RunGuestAsync(
+                        instance,
+                        () => ResumeAfterHostCall(instance, next),
+                        budget).ConfigureAwait(false);
                 }
-                return task.Result;
+
+                return new WasmExecutionResult(step.Result, logs.Complete())
+                {
+                    Memory = CollectMemoryStats(instance),
+                    Profile = StopProfiling(instance, ref profiling)
+                };
+            }
+            finally
+            {
+                // Skipped when a timed-out step still runs on the instance (it is faulted then)
+                instance.EndContext();
+            }
+        }
+        finally
+        {
+            StopProfiling(instance, ref profiling);
+            instance.LogSink = null;
+            instance.HostCalls = null;
+            instance.Streams = null;
+        }
+    }
+
+    /// <summary>
+    /// Runs a script of a state-persisting lease. The first script opens a context and runs the
+    /// startup and bootstrap segments; later ones evaluate only the user script in that context.
+    /// The context survives script errors; it is dropped on timeouts, cancellation, traps and
+    /// when the instance grows past <see cref="WasmInstanceLease.MaxMemoryBytes"/>.
+    /// </summary>
+    private async Task<WasmExecutionResult> ExecuteStatefulAsync(
+        WasmInstanceLease lease,
+        WasmInstance instance,
+        BootstrapArtifact? bootstrap,
+        UserScript script,
+        int? timeoutMs,
+        CancellationToken cancellationToken)
+    {
+        if (!instance.SupportsBytecode)
+        {
+            throw new NotSupportedException(
+                "Sessions that persist state need a WASM module with the context and bytecode APIs; rebuild ScriptBox.Wasm");
+        }
+
+        cancellationToken.ThrowIfCancellationRequested();
+
+        var budget = new ExecutionBudget(timeoutMs ?? WasmConfiguration.DefaultTimeoutMs, _options.FuelPerScript);
+        var logs = new ScriptLog(_config.MaxLogEntries, _config.LogSampleRate);
+        using var hostCalls = new AsyncHostCalls(cancellationToken);
+        using var streams = new HostStreamTable(_config.MaxOpenStreams, _config.MaxStreamReadSize);
+        instance.LogSink = logs;
+        instance.HostCalls = hostCalls;
+        instance.Streams = streams;
+
+        var resumed = ReferenceEquals(lease.StateInstance, instance);
+        lease.StateInstance = null;
+        var keepState = false;
+        var profiling = StartProfiling(instance);
+        try
+        {
+            var step = await RunGuestAsync(
+                instance,
+                () => resumed
+                    ? EvaluateUserScript(instance, script)
+                    : EvaluateSegments(instance, _startup.Value, bootstrap, script),
+                budget).ConfigureAwait(false);
+
+            while (!step.Completed)
+            {
+                var next = await hostCalls.WaitForNextAsync(budget.RemainingMs).ConfigureAwait(false)
+                           ?? throw budget.CreateTimeoutException();
+                step = await RunGuestAsync(
+                    instance,
+                    () => ResumeAfterHostCall(instance, next),
+                    budget).ConfigureAwait(false);
+            }
+
+            if (ExceedsMemoryLimit(lease, instance))
+            {
+                throw new InvalidOperationException(
+                    $"Session exceeded its memory limit of {lease.MaxMemoryBytes} bytes; its state was discarded");
+            }
+
+            keepState = true;
+            return new WasmExecutionResult(step.Result, logs.Complete())
+            {
+                Memory = CollectMemoryStats(instance),
+                Profile = StopProfiling(instance, ref profiling)
+            };
+        }
+        catch (InvalidOperationException) when (!instance.IsFaulted && hostCalls.Count == 0)
+        {
+            // The script threw; what it set up before that stays, as in a REPL
+            keepState = !ExceedsMemoryLimit(lease, instance);
+            throw;
+        }
+        finally
+        {
+            StopProfiling(instance, ref profiling);
+            instance.LogSink = null;
+            instance.HostCalls = null;
+            instance.Streams = null;
+
+            if (keepState)
+            {
+                lease.StateInstance = instance;
+            }
+            else
+            {
+                instance.EndContext();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Retires the instance when it grew past the lease's limit. Linear memory never shrinks,
+    /// so the instance could not get back under it.
+    /// </summary>
+    private static bool ExceedsMemoryLimit(WasmInstanceLease lease, WasmInstance instance)
+    {
+        if (lease.MaxMemoryBytes is not { } limit || instance.Memory.GetLength() <= limit)
+        {
+            return false;
+        }
+
+        instance.Retire();
+        return true;
+    }
+
+    /// <summary>
+    /// Runs one synchronous guest step within the remaining timeout. Modules with cooperative
+    /// deadlines stop the script themselves; with epoch interruption the guest traps once the
+    /// timeout passes. The watchdog still covers host calls that block it.
+    /// </summary>
+    private async Task<T> RunGuestAsync<T>(WasmInstance instance, Func<T> step, ExecutionBudget budget)
+    {
+        if (budget.IsUnlimited)
+        {
+            // Host calls block the guest thread on their handlers; on a thread whose context or
+            // scheduler those handlers' continuations would need, that wait could never finish
+            return SynchronizationContext.Current is null && TaskScheduler.Current == TaskScheduler.Default
+                ? RunMetered(instance, step, budget)
+                : await Task.Run(() => RunMetered(instance, step, budget)).ConfigureAwait(false);
+        }
+
+        var remaining = budget.RemainingMs;
+        if (remaining == 0)
+        {
+            throw budget.CreateTimeoutException();
+        }
+
+        var task = Task.Run(() => RunMetered(instance, step, budget));
+        var watchdogMs = instance.SupportsCooperativeTimeouts ? remaining + WasmConfiguration.CooperativeTimeoutGraceMs : remaining;
+        using (var delayCts = new CancellationTokenSource())
+        {
+            if (await Task.WhenAny(task, Task.Delay(watchdogMs, delayCts.Token)).ConfigureAwait(false) != task)
+            {
+                instance.Abandon(task);
+                throw budget.CreateTimeoutException();
+            }
+
+            delayCts.Cancel();
+        }
+
+        return await task.ConfigureAwait(false);
+    }
+
+    /// <summary>
+    /// Arms the deadlines and fuel for one guest step and disarms them afterwards, so guest
+    /// calls made outside script steps (<c>context_free</c>, compilation) are never interrupted.
+    /// A script stopped by the guest's own deadline leaves its instance reusable; one stopped
+    /// by an epoch or fuel trap faults the instance, which is never reused.
+    /// </summary>
+    private T RunMetered<T>(WasmInstance instance, Func<T> step, ExecutionBudget budget)
+    {
+        var cooperative = instance.SupportsCooperativeTimeouts && !budget.IsUnlimited;
+        if (cooperative)
+        {
+            instance.SetInterruptDeadline(Math.Max(1, budget.RemainingMs));
+        }
+
+        if (_options.EpochInterruption)
+        {
+            // Leave the guest's deadline time to fire first
+            var graceMs = cooperative ? WasmConfiguration.CooperativeTimeoutGraceMs : 0;
+            instance.SetEpochDeadline(budget.IsUnlimited
+                ? WasmConfiguration.UnboundedEpochDeadline
+                : (ulong)((budget.RemainingMs + graceMs) / _options.EpochTickMs) + 1);
+        }
+
+        var fuel = budget.RemainingFuel;
+        if (fuel is not null)
+        {
+            instance.Fuel = fuel.Value;
+        }
+
+        try
+        {
+            return step();
+        }
+        catch (TrapException ex) when (ex.Type == TrapCode.Interrupt)
+        {
+            throw budget.CreateTimeoutException();
+        }
+        catch (TrapException ex) when (ex.Type == TrapCode.OutOfFuel)
+        {
+            throw budget.CreateOutOfFuelException();
+        }
+        catch (InvalidOperationException) when (cooperative && !instance.IsFaulted && instance.WasInterrupted)
+        {
+            throw budget.CreateTimeoutException();
+        }
+        finally
+        {
+            if (cooperative && !instance.IsFaulted)
+            {
+                instance.SetInterruptDeadline(0);
+            }
+
+            if (fuel is not null)
+            {
+                budget.RemainingFuel = instance.Fuel;
+                instance.Fuel = WasmConfiguration.UnboundedFuel;
+            }
+
+            if (_options.EpochInterruption)
+            {
+                instance.SetEpochDeadline(WasmConfiguration.UnboundedEpochDeadline);
             }
-            catch (AggregateException ae)
+        }
+    }
+
+    /// <summary>
+    /// Runs startup and bootstrap code as separate global scripts in one context, then the user IIFE.
+    /// Both bootstrap segments replay their precompiled bytecode; the user script cache can be disabled.
+    /// The context stays open for <see cref="WasmInstance.TryCompleteHostCall"/> and is freed by the caller.
+    /// </summary>
+    private GuestStep EvaluateSegments(WasmInstance instance, BootstrapArtifact startup, BootstrapArtifact? bootstrap, UserScript script)
+    {
+        using (ScriptBoxDiagnostics.StartPhase("bootstrap"))
+        {
+            instance.BeginContext();
+            EvaluateBootstrap(instance, startup);
+            if (bootstrap is not null)
             {
-                // Unwrap AggregateException from Task.Wait
-                throw ae.InnerException ?? ae;
+                EvaluateBootstrap(instance, bootstrap);
             }
         }
-        else
+
+        return EvaluateUserScript(instance, script);
+    }
+
+    private static void EvaluateBootstrap(WasmInstance instance, BootstrapArtifact bootstrap)
+    {
+        if (!bootstrap.IsEmpty)
+        {
+            instance.EvaluateBytecode(bootstrap.Compile(instance), discardResult: true);
+        }
+    }
+
+    /// <summary>
+    /// Runs the user script IIFE in the open context. Prepared scripts are called with their
+    /// argument instead when the module supports it, reusing one bytecode blob for every input.
+    /// </summary>
+    private GuestStep EvaluateUserScript(WasmInstance instance, UserScript script)
+    {
+        using var phase = ScriptBoxDiagnostics.StartPhase("evaluate");
+        object? result;
+        bool completed;
+        if (script.Prepared is { } prepared && instance.SupportsPreparedCalls)
+        {
+            var function = instance.SupportsAsyncHostCalls ? prepared.AsyncFunctionSource : prepared.FunctionSource;
+            var bytecode = _scriptBytecode?.GetOrAdd(function, instance.Compile) ?? instance.Compile(function);
+            completed = instance.TryCall(bytecode, script.ArgumentJson!, out result);
+            return new GuestStep(completed, result);
+        }
+
+        var source = script.ToSource(instance.SupportsAsyncHostCalls);
+        var userScript = instance.SupportsAsyncHostCalls
+            ? WrapUserScriptInAsyncIife(source)
+            : WrapUserScriptInIife(source);
+        completed = _scriptBytecode is null
+            ? instance.TryEvaluate(userScript, out result)
+            : instance.TryEvaluate(_scriptBytecode.GetOrAdd(userScript, instance.Compile), out result);
+        return new GuestStep(completed, result);
+    }
+
+    /// <summary>
+    /// Passes an async host call response back to the guest, which runs the script on until it
+    /// finishes or waits again.
+    /// </summary>
+    private static GuestStep ResumeAfterHostCall(WasmInstance instance, (int CallId, string Response) next)
+    {
+        using var phase = ScriptBoxDiagnostics.StartPhase("evaluate");
+        var completed = instance.TryCompleteHostCall(next.CallId, next.Response, out var result);
+        return new GuestStep(completed, result);
+    }
+
+    /// <summary>
+    /// Reads the guest heap statistics when enabled and records the heap size metric.
+    /// Called while the script's context is still open.
+    /// </summary>
+    private GuestMemoryStats? CollectMemoryStats(WasmInstance instance)
+    {
+        var stats = _options.CollectMemoryStats ? instance.ReadMemoryStats() : null;
+        if (ScriptBoxDiagnostics.GuestHeapSize.Enabled && (stats?.HeapBytesInUse ?? instance.HeapBytesInUse) is { } heapBytes)
+        {
+            ScriptBoxDiagnostics.GuestHeapSize.Record(heapBytes);
+        }
+
+        return stats;
+    }
+
+    /// <summary>
+    /// Starts sampling the script's stacks when profiling is enabled and the module supports it.
+    /// </summary>
+    /// <returns>True when the instance is now profiling.</returns>
+    private bool StartProfiling(WasmInstance instance)
+    {
+        if (_options.ProfileSampleInterval is not { } interval || !instance.SupportsProfiling)
         {
-            // No timeout - execute directly
-            return ExecuteScriptInternal(jsCode);
+            return false;
         }
+
+        instance.StartProfiling(interval);
+        return true;
     }
 
     /// <summary>
-    /// Internal method that performs the actual script execution without timeout handling.
+    /// Stops a profile started by <see cref="StartProfiling"/> and returns its samples. Does not touch
+    /// faulted instances, which may still run an abandoned step.
     /// </summary>
-    private WasmExecutionResult ExecuteScriptInternal(string jsCode)
+    private ScriptProfile? StopProfiling(WasmInstance instance, ref bool profiling)
     {
-        var logs = new List<string>();
-        using var linker = new Linker(_engine);
-        using var store = new Store(_engine);
+        if (!profiling)
+        {
+            return null;
+        }
 
-        ConfigureWasi(store);
-        DefineHostBridge(store, linker, logs.Add);
+        profiling = false;
+        return instance.IsFaulted ? null : instance.StopProfiling(_options.ProfileSampleInterval!.Value);
+    }
 
-        var instance = linker.Instantiate(store, _module);
-        var memory = instance.GetMemory(WasmConfiguration.MemoryExportName)
-                    ?? throw new InvalidOperationException($"No {WasmConfiguration.MemoryExportName} export found");
+    /// <summary>
+    /// Builds the single script evaluated by modules without the context API.
+    /// </summary>
+    private static string BuildFullScript(string startupJs, string? bootstrapCode, string jsCode)
+    {
+        var userScript = string.IsNullOrWhiteSpace(bootstrapCode)
+            ? jsCode
+            : string.Concat(bootstrapCode, "\n", jsCode);
 
-        // Prepend bootstrap JS before user code
-        // Add void expression to discard bootstrap result, then evaluate user code
-        var startupJs = LoadStartupJs();
-        string fullScript;
         if (string.IsNullOrWhiteSpace(startupJs))
         {
-            fullScript = WrapUserScriptInIife(jsCode);
+            return WrapUserScriptInIife(userScript);
+        }
+
+        // Terminate bootstrap, add void 0 to discard any bootstrap return value,
+        // then wrap user code in an IIFE to support return statements at the top level
+        return $"{startupJs};\nvoid 0;\n{WrapUserScriptInIife(userScript)}";
+    }
+
+    /// <summary>
+    /// Creates and links a new module instance for the pool.
+    /// </summary>
+    private WasmInstance CreateInstance()
+    {
+        using var phase = ScriptBoxDiagnostics.StartPhase("instantiate");
+        var instance = new WasmInstance(
+            _runtime.Engine,
+            _runtime.Module,
+            (store, linker, owner) =>
+            {
+                // Both default to zero, which would trap during instantiation
+                if (_options.EpochInterruption)
+                {
+                    store.SetEpochDeadline(WasmConfiguration.UnboundedEpochDeadline);
+                }
+
+                if (_options.FuelPerScript is not null)
+                {
+                    store.Fuel = WasmConfiguration.UnboundedFuel;
+                }
+
+                if (_config.MaxGuestMemoryBytes is { } maxMemory)
+                {
+                    store.SetLimits(memorySize: maxMemory);
+                }
+
+                ConfigureWasi(store);
+                DefineHostBridge(store, linker, owner);
+            },
+            preferSharedRuntime: _options.ReuseInstances);
+
+        if (_config.ScriptHeapLimitBytes is not null || _config.GcThresholdBytes is not null)
+        {
+            instance.SetMemoryLimits(_config.ScriptHeapLimitBytes, _config.GcThresholdBytes);
         }
-        else
+
+        instance.StructuredResults = _options.StructuredResults;
+
+        if (_moduleSource.IsPreinitialized)
         {
-            // Terminate bootstrap, add void 0 to discard any bootstrap return value,
-            // then wrap user code in an IIFE to support return statements at the top level
-            fullScript = $"{startupJs};\nvoid 0;\n{WrapUserScriptInIife(jsCode)}";
+            try
+            {
+                EnsurePreinitialized(instance.Instance);
+            }
+            catch
+            {
+                instance.Dispose();
+                throw;
+            }
         }
 
-        var result = ExecuteEvalFunction(instance, memory, fullScript);
-        return new WasmExecutionResult(result, logs);
+        return instance;
+    }
+
+    /// <summary>
+    /// Verifies that a module configured as pre-initialized really carries a snapshot.
+    /// Without this check a regular module would run user code without the core bootstrap.
+    /// </summary>
+    private void EnsurePreinitialized(Instance instance)
+    {
+        var isPreinitialized = instance.GetFunction<int>(WasmConfiguration.IsPreinitializedFunctionName);
+        if (isPreinitialized is null || isPreinitialized() == 0)
+        {
+            throw new InvalidOperationException(
+                $"WASM module ({_moduleSource}) is not pre-initialized. Build it with 'ScriptBox.Wasm/build.sh --snapshot' " +
+                "or load it with WithWasmModuleFromPath instead.");
+        }
     }
 
     /// <summary>
@@ -152,6 +801,15 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
         return $"(function() {{\n{jsCode}\n}})()";
     }
 
+    /// <summary>
+    /// Async variant for modules that await promise results, so scripts can use top-level
+    /// <c>await</c> on <c>hostCallAsync</c>.
+    /// </summary>
+    private static string WrapUserScriptInAsyncIife(string jsCode)
+    {
+        return $"(async function() {{\n{jsCode}\n}})()";
+    }
+
     /// <summary>
     /// Configures WASI for the sandbox environment.
     /// </summary>
@@ -168,7 +826,8 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
     /// <summary>
     /// Defines the host.call bridge that allows QuickJS to invoke host methods.
     /// </summary>
-    private void DefineHostBridge(Store store, Linker linker, Action<string>? onLog = null)
+    /// <param name="owner">Instance the imports belong to; receives console output and grows the response buffer.</param>
+    private void DefineHostBridge(Store store, Linker linker, WasmInstance owner)
     {
         linker.DefineWasi();
         linker.Define(
@@ -177,55 +836,123 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
             Function.FromCallback(
                 store,
                 (Caller caller, int inPtr, int inLen, int outPtr, int outCap) =>
-                    HandleHostCallCallback(caller, inPtr, inLen, outPtr, outCap)
+                    HandleHostCallCallback(caller, owner, inPtr, inLen, outPtr, outCap)
             )
         );
 
-        // host.log: used by console.log inside QuickJS
+        // host.log: one console entry (older modules, and entries too large to buffer)
         linker.Define(
             "host",
             "log",
             Function.FromCallback(
                 store,
                 (Caller caller, int ptr, int len) =>
-                    HandleHostLogCallback(caller, ptr, len, onLog)
+                    HandleHostLogCallback(caller, ptr, len, owner)
+            )
+        );
+
+        // host.log_batch: console entries buffered by the guest
+        linker.Define(
+            "host",
+            "log_batch",
+            Function.FromCallback(
+                store,
+                (Caller caller, int ptr, int len) =>
+                    HandleHostLogBatchCallback(caller, ptr, len, owner)
             )
         );
     }
 
-    private void HandleHostLogCallback(Caller caller, int ptr, int len, Action<string>? onLog)
+    private void HandleHostLogCallback(Caller caller, int ptr, int len, WasmInstance owner)
+    {
+        var memory = caller.GetMemory(WasmConfiguration.MemoryExportName)
+                    ?? throw new InvalidOperationException("No memory export");
+
+        WriteLog(memory, ptr, len, owner.LogSink);
+    }
+
+    /// <summary>
+    /// Delivers a batch of <c>[uint32 length][UTF-8]</c> entries. Entries the run's log does not
+    /// admit are skipped without being decoded.
+    /// </summary>
+    private void HandleHostLogBatchCallback(Caller caller, int ptr, int len, WasmInstance owner)
     {
         var memory = caller.GetMemory(WasmConfiguration.MemoryExportName)
                     ?? throw new InvalidOperationException("No memory export");
 
-        var message = ReadStringFromMemory(memory, ptr, len);
+        var offset = 0;
+        while (len - offset >= WasmConfiguration.LogEntryHeaderSize)
+        {
+            var entryLength = memory.ReadInt32(ptr + offset);
+            offset += WasmConfiguration.LogEntryHeaderSize;
+            if (entryLength < 0 || entryLength > len - offset)
+            {
+                throw new InvalidOperationException("Malformed log batch from the guest");
+            }
+
+            WriteLog(memory, ptr + offset, entryLength, owner.LogSink);
+            offset += entryLength;
+        }
+    }
+
+    private void WriteLog(Memory memory, int ptr, int len, ScriptLog? log)
+    {
+        if (log is not null && !log.Admit())
+        {
+            return;
+        }
+
+        var message = WasmMemory.ReadUtf8(memory, ptr, len);
         _hostApi.Log(message);
-        onLog?.Invoke(message);
+        log?.Add(message);
     }
 
     /// <summary>
     /// Callback invoked when QuickJS calls a host method.
     /// Reads the request, dispatches it, and writes the response back to WASM memory.
+    /// Responses larger than the guest buffer are written into a buffer the guest grows on
+    /// request (<c>grow_response_buffer</c>); the return value is always the full length.
+    /// Older modules cannot grow the buffer and receive the response truncated to its capacity.
     /// </summary>
-    private int HandleHostCallCallback(Caller caller, int inPtr, int inLen, int outPtr, int outCap)
+    private int HandleHostCallCallback(Caller caller, WasmInstance owner, int inPtr, int inLen, int outPtr, int outCap)
     {
         try
         {
             var memory = caller.GetMemory(WasmConfiguration.MemoryExportName)
                         ?? throw new InvalidOperationException("No memory export");
 
-            var jsonRequest = ReadStringFromMemory(memory, inPtr, inLen);
-            var jsonResponse = HandleHostCall(jsonRequest);
-            var responseBytes = Encoding.UTF8.GetBytes(jsonResponse);
+            if (inLen > 0 && memory.GetSpan(inPtr, 1)[0] == WasmConfiguration.BinaryHostCallMarker)
+            {
+                var binaryResponse = HandleBinaryHostCall(memory.GetSpan(inPtr, inLen).ToArray());
+                return WriteBinaryResponse(owner, memory, outPtr, outCap, binaryResponse.WrittenSpan);
+            }
+
+            var jsonRequest = WasmMemory.ReadUtf8(memory, inPtr, inLen);
+            var jsonResponse = DispatchHostCall(owner, jsonRequest);
 
             // Write response JSON to WASM memory
-            int bytesToWrite = Math.Min(responseBytes.Length, outCap);
-            for (var i = 0; i < bytesToWrite; i++)
+            var byteCount = Encoding.UTF8.GetByteCount(jsonResponse);
+            if (byteCount > outCap)
             {
-                memory.Write(outPtr + i, responseBytes[i]);
+                if (!owner.CanGrowResponseBuffer)
+                {
+                    var truncated = Encoding.UTF8.GetBytes(jsonResponse).AsSpan(0, outCap);
+                    WasmMemory.Write(memory, outPtr, truncated);
+                    return outCap;
+                }
+
+                // Phase two: the guest allocates a buffer of the required size
+                outPtr = owner.GrowResponseBuffer(byteCount);
+                if (outPtr == 0)
+                {
+                    // Guest is out of memory; it reports the oversized response as an error
+                    return byteCount;
+                }
             }
 
-            return bytesToWrite;
+            // Growing may have grown linear memory; WriteUtf8 takes a fresh span
+            WasmMemory.WriteUtf8(memory, outPtr, jsonResponse, byteCount);
+            return byteCount;
         }
         catch (Exception)
         {
@@ -235,170 +962,160 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
     }
 
     /// <summary>
-    /// Executes the eval_js WASM function and checks for errors.
-    /// </summary>
-    private string ExecuteEvalFunction(Instance instance, Memory memory, string jsCode)
-    {
-        var (ptr, len) = WriteStringToMemory(instance, memory, jsCode);
-
-        var eval = instance.GetFunction<int, int, int>(WasmConfiguration.EvalFunctionName)
-                  ?? throw new InvalidOperationException(
-                      $"{WasmConfiguration.EvalFunctionName} function not found");
-
-        var status = eval(ptr, len);
-
-        if (status != WasmConfiguration.SuccessStatusCode)
-        {
-            var errorMessage = ReadErrorMessage(instance, memory);
-            System.Console.Error.WriteLine($"WASM eval_js status={status}: {errorMessage}");
-            throw new InvalidOperationException(
-                $"eval_js failed with status {status}. Error: {errorMessage}");
-        }
-
-        // Success - read the result
-        return ReadResultMessage(instance, memory);
-    }
-
-    /// <summary>
-    /// Reads the error message from WASM memory after evaluation.
+    /// Writes a binary host call response, growing the guest buffer when it does not fit.
+    /// Only modules with <c>grow_response_buffer</c> send binary calls.
     /// </summary>
-    private string ReadErrorMessage(Instance instance, Memory memory)
+    private static int WriteBinaryResponse(WasmInstance owner, Memory memory, int outPtr, int outCap, ReadOnlySpan<byte> response)
     {
-        var getErrorPtr = instance.GetFunction<int>(WasmConfiguration.GetErrorPtrFunctionName)
-                         ?? throw new InvalidOperationException(
-                             $"{WasmConfiguration.GetErrorPtrFunctionName} function not found");
-        var getErrorLen = instance.GetFunction<int>(WasmConfiguration.GetErrorLenFunctionName)
-                         ?? throw new InvalidOperationException(
-                             $"{WasmConfiguration.GetErrorLenFunctionName} function not found");
-
-        int errorPtr = getErrorPtr();
-        int errorLen = getErrorLen();
-
-        if (errorLen <= 0)
+        if (response.Length > outCap)
         {
-            return string.Empty;
+            outPtr = owner.CanGrowResponseBuffer ? owner.GrowResponseBuffer(response.Length) : 0;
+            if (outPtr == 0)
+            {
+                // The guest reports the oversized response as an error
+                return response.Length;
+            }
         }
 
-        return ReadStringFromMemory(memory, errorPtr, errorLen);
+        WasmMemory.Write(memory, outPtr, response);
+        return response.Length;
     }
 
     /// <summary>
-    /// Reads the result value from WASM memory after successful evaluation.
+    /// Handles a <c>__host.bridgeBinary</c> call: <c>0xC1 [target, args]</c> where target is a
+    /// method ID or the name of a registered handler. Responds with <c>0xC1 [ok, value]</c>,
+    /// value being the handler result or the error message.
     /// </summary>
-    private string ReadResultMessage(Instance instance, Memory memory)
+    private MessagePackWriter HandleBinaryHostCall(byte[] request)
     {
-        var getResultPtr = instance.GetFunction<int>(WasmConfiguration.GetResultPtrFunctionName)
-                          ?? throw new InvalidOperationException(
-                              $"{WasmConfiguration.GetResultPtrFunctionName} function not found");
-        var getResultLen = instance.GetFunction<int>(WasmConfiguration.GetResultLenFunctionName)
-                          ?? throw new InvalidOperationException(
-                              $"{WasmConfiguration.GetResultLenFunctionName} function not found");
-
-        int resultPtr = getResultPtr();
-        int resultLen = getResultLen();
-
-        if (resultLen <= 0)
+        var writer = new MessagePackWriter();
+        try
         {
-            return string.Empty;
-        }
+            var reader = new MessagePackReader(request, 1);
+            if (reader.ReadArrayHeader() != 2)
+            {
+                return BinaryError(writer, "Malformed binary host call");
+            }
 
-        return ReadStringFromMemory(memory, resultPtr, resultLen);
-    }
+            string method;
+            Func<HostCallContext, Task<object?>>? handler;
+            if (reader.TryReadInt64(out var id))
+            {
+                if (id is < 0 or > int.MaxValue || !_methodTable.TryGet((int)id, out method, out handler))
+                {
+                    return BinaryError(writer, $"Unknown method id: {id}");
+                }
+            }
+            else if (!reader.TryReadString(out var name) || string.IsNullOrWhiteSpace(name))
+            {
+                return BinaryError(writer, "Host call missing method");
+            }
+            else if (!_jsonHandlers.TryGetValue(name!, out handler))
+            {
+                return BinaryError(writer, $"Unknown method: {name}");
+            }
+            else
+            {
+                method = name!;
+            }
 
-    /// <summary>
-    /// Writes JavaScript source code into WASM linear memory.
-    /// </summary>
-    /// <returns>A tuple of (memory offset, byte length).</returns>
-    private static (int ptr, int len) WriteStringToMemory(Instance instance, Memory memory, string jsCode)
-    {
-        var bytes = Encoding.UTF8.GetBytes(jsCode);
-        var (scriptPtr, maxScriptSize) = GetScriptBufferLocation(instance);
+            using var call = ScriptBoxDiagnostics.StartHostCall(method);
+            var context = HostCallContext.FromMessagePack(method, request, reader.Position, CancellationToken.None);
+            var result = handler(context).GetAwaiter().GetResult();
 
-        if (bytes.Length > maxScriptSize)
-        {
-            throw new InvalidOperationException(
-                $"Script too large ({bytes.Length} bytes) for available WASM memory " +
-                $"(max {maxScriptSize} bytes)");
+            writer.WriteRaw(WasmConfiguration.BinaryHostCallMarker);
+            writer.WriteArrayHeader(2);
+            writer.WriteBoolean(true);
+            writer.WriteObject(result, _jsonOptions);
+            return writer;
         }
-
-        for (var i = 0; i < bytes.Length; i++)
+        catch (Exception ex)
         {
-            memory.Write(scriptPtr + i, bytes[i]);
+            return BinaryError(writer, $"Error processing host call: {ex.Message}");
         }
+    }
 
-        return (scriptPtr, bytes.Length);
+    private static MessagePackWriter BinaryError(MessagePackWriter writer, string message)
+    {
+        writer.Reset();
+        writer.WriteRaw(WasmConfiguration.BinaryHostCallMarker);
+        writer.WriteArrayHeader(2);
+        writer.WriteBoolean(false);
+        writer.WriteString(message);
+        return writer;
     }
 
     /// <summary>
-    /// Determines the location and size of the script buffer in WASM memory.
-    /// Prefers dynamic lookup via exported functions, falls back to hardcoded defaults.
+    /// Loads the configured startup files from disk, once per executor on the first run.
+    /// They run before every user script.
     /// </summary>
-    private static (int ptr, int len) GetScriptBufferLocation(Instance instance)
+    private BootstrapArtifact LoadStartupJs()
     {
-        // Try to get the dynamic script buffer from the WASM module
-        var getScriptBufferPtr = instance.GetFunction<int>(WasmConfiguration.GetScriptBufferPtrFunctionName);
-        var getScriptBufferLen = instance.GetFunction<int>(WasmConfiguration.GetScriptBufferLenFunctionName);
-
-        if (getScriptBufferPtr != null && getScriptBufferLen != null)
-        {
-            return (getScriptBufferPtr(), getScriptBufferLen());
-        }
-
-        // Fallback to hardcoded offset for backward compatibility with older WASM modules
-        return (WasmConfiguration.ScriptMemoryOffset, 
-                WasmConfiguration.MaxScriptSize - WasmConfiguration.ScriptMemoryOffset);
+        var scripts = _config.StartupScripts;
+        return scripts is null || scripts.Count == 0
+            ? BootstrapArtifact.Empty
+            : new BootstrapArtifact(BootstrapScriptLoader.LoadScripts(scripts));
     }
 
-    private static string ReadStringFromMemory(Memory memory, int ptr, int length)
+    /// <summary>
+    /// Answers a host call from the guest. <c>__host.bridge</c> calls are handled inline.
+    /// <c>__host.bridgeAsync</c> calls arrive as <c>{"callId":N,"request":{...}}</c>; when they do not
+    /// finish synchronously they are tracked in <see cref="WasmInstance.HostCalls"/> and the empty
+    /// response tells the guest the call is pending.
+    /// </summary>
+    private string DispatchHostCall(WasmInstance owner, string json)
     {
-#if NETSTANDARD2_0
-        var buffer = new byte[length];
-        for (var i = 0; i < length; i++)
+        var hostCalls = owner.HostCalls;
+        if (hostCalls is null || !json.StartsWith("{\"callId\":", StringComparison.Ordinal))
         {
-            buffer[i] = memory.Read<byte>(ptr + i);
+            return HandleHostCall(json, owner.Streams);
         }
-        return Encoding.UTF8.GetString(buffer);
-#else
-        if (length == 0)
+
+        Task<string> response;
+        int callId;
+        try
         {
-            return string.Empty;
+            using var doc = JsonDocument.Parse(json);
+            var root = doc.RootElement;
+            callId = root.GetProperty("callId").GetInt32();
+            response = HandleHostCallAsync(root.GetProperty("request"), owner.Streams, hostCalls.Token);
         }
-
-        Span<byte> buffer = length <= 1024 ? stackalloc byte[length] : new byte[length];
-        for (var i = 0; i < length; i++)
+        catch (Exception ex)
         {
-            buffer[i] = memory.Read<byte>(ptr + i);
+            return CreateErrorResponse($"Error processing host call: {ex.Message}");
         }
 
-        return Encoding.UTF8.GetString(buffer);
-#endif
-    }
-
-    /// <summary>
-    /// Loads configured bootstrap JavaScript files from disk.
-    /// These are prepended before every user script.
-    /// </summary>
-    /// <returns>The bootstrap JavaScript code as a string.</returns>
-    private string LoadStartupJs()
-    {
-        var scripts = _config.StartupScripts ?? new List<string>();
-        if (scripts.Count == 0)
+        if (response.IsCompleted)
         {
-            return string.Empty;
+            return response.GetAwaiter().GetResult();
         }
 
-        return BootstrapScriptLoader.LoadScripts(scripts);
+        hostCalls.Add(callId, response);
+        return string.Empty;
     }
 
     /// <summary>
     /// Dispatches a host method call from the sandbox and returns the JSON response.
     /// </summary>
-    private string HandleHostCall(string json)
+    /// <param name="streams">Stream handles of the running script; null outside a run.</param>
+    private string HandleHostCall(string json, HostStreamTable? streams)
     {
         try
         {
             using var doc = JsonDocument.Parse(json);
             var root = doc.RootElement;
+            if (root.TryGetProperty("id", out var idElement))
+            {
+                if (!TryGetHandlerById(idElement, out var name, out var byId))
+                {
+                    return CreateErrorResponse($"Unknown method id: {idElement.GetRawText()}");
+                }
+
+                using var byIdCall = ScriptBoxDiagnostics.StartHostCall(name);
+                var result = byId(HostCallContext.FromJson(name, root, CancellationToken.None)).GetAwaiter().GetResult();
+                return JsonSerializer.Serialize(new { result }, _jsonOptions);
+            }
+
             if (!root.TryGetProperty("method", out var methodElement))
             {
                 return "{\"error\":\"Host call missing method\"}";
@@ -410,7 +1127,11 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
                 return "{\"error\":\"Host call missing method\"}";
             }
 
-            if (_jsonHandlers.Count > 0 && _jsonHandlers.TryGetValue(method!, out var handler))
+            Func<HostCallContext, Task<object?>>? handler = null;
+            var known = (_jsonHandlers.Count > 0 && _jsonHandlers.TryGetValue(method!, out handler))
+                        || BuiltInHostMethods.Contains(method!);
+            using var call = ScriptBoxDiagnostics.StartHostCall(known ? method! : ScriptBoxDiagnostics.UnknownHostMethod);
+            if (handler is not null)
             {
                 var context = HostCallContext.FromJson(method!, root, CancellationToken.None);
                 var result = handler(context).GetAwaiter().GetResult();
@@ -420,7 +1141,7 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
 
             if (!root.TryGetProperty("args", out var args))
             {
-                return $"{{\"error\":\"Host call '{method}' missing args array\"}}";
+                return CreateErrorResponse($"Host call '{method}' missing args array");
             }
 
             return method switch
@@ -436,21 +1157,214 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
                 "FileSystemExists" => HandleFileSystemExistsCall(args),
                 "FileSystemDelete" => HandleFileSystemDeleteCall(args),
                 "FileSystemCreateDirectory" => HandleFileSystemCreateDirectoryCall(args),
+                "FileSystemOpenRead" => HandleFileSystemOpenReadCall(args, streams),
 
                 // HTTP Client API
                 "HttpGet" => HandleHttpGetCall(args),
                 "HttpPost" => HandleHttpPostCall(args),
                 "HttpRequest" => HandleHttpRequestCall(args),
-                
+                "HttpOpen" => HandleHttpOpenCallAsync(args, streams, CancellationToken.None).GetAwaiter().GetResult(),
+
+                // Stream API
+                "StreamRead" => HandleStreamReadCall(args, streams),
+                "StreamClose" => HandleStreamCloseCall(args, streams),
+
                 // Tool Invocation Protocol
                 "tool.invoke" => HandleToolInvoke(args),
 
-                _ => $"{{\"error\":\"Unknown method: {method}\"}}"
+                // Batches still run concurrently; only this guest thread waits for all of them
+                "host.batch" => HandleBatchCallAsync(args, streams, CancellationToken.None).GetAwaiter().GetResult(),
+
+                _ => CreateErrorResponse($"Unknown method: {method}")
+            };
+        }
+        catch (Exception ex)
+        {
+            return CreateErrorResponse($"Error processing host call: {ex.Message}");
+        }
+    }
+
+    /// <summary>
+    /// Starts an async host call. Everything read from <paramref name="request"/> is extracted
+    /// before the first await, so the caller may dispose the document once this returns.
+    /// Failures are reported as <c>{"error":...}</c> responses, like synchronous calls.
+    /// </summary>
+    private Task<string> HandleHostCallAsync(JsonElement request, HostStreamTable? streams, CancellationToken cancellationToken)
+    {
+        try
+        {
+            if (request.TryGetProperty("id", out var idElement))
+            {
+                return TryGetHandlerById(idElement, out var name, out var byId)
+                    ? TraceHostCall(name, () => SerializeHandlerResultAsync(byId(HostCallContext.FromJson(name, request, cancellationToken))))
+                    : Task.FromResult(CreateErrorResponse($"Unknown method id: {idElement.GetRawText()}"));
+            }
+
+            if (!request.TryGetProperty("method", out var methodElement))
+            {
+                return Task.FromResult("{\"error\":\"Host call missing method\"}");
+            }
+
+            var method = methodElement.GetString();
+            if (string.IsNullOrWhiteSpace(method))
+            {
+                return Task.FromResult("{\"error\":\"Host call missing method\"}");
+            }
+
+            if (_jsonHandlers.Count > 0 && _jsonHandlers.TryGetValue(method!, out var handler))
+            {
+                return TraceHostCall(method!, () => SerializeHandlerResultAsync(handler(HostCallContext.FromJson(method!, request, cancellationToken))));
+            }
+
+            if (!request.TryGetProperty("args", out var args))
+            {
+                return Task.FromResult(CreateErrorResponse($"Host call '{method}' missing args array"));
+            }
+
+            Func<Task<string>>? start = method switch
+            {
+                "HttpGet" => () => HandleHttpGetCallAsync(args, cancellationToken),
+                "HttpPost" => () => HandleHttpPostCallAsync(args, cancellationToken),
+                "HttpRequest" => () => HandleHttpRequestCallAsync(args, cancellationToken),
+                "HttpOpen" => () => HandleHttpOpenCallAsync(args, streams, cancellationToken),
+                "StreamRead" => () => HandleStreamReadCallAsync(args, streams, cancellationToken),
+                "tool.invoke" => () => HandleToolInvokeAsync(args, cancellationToken),
+                "host.batch" => () => HandleBatchCallAsync(args, streams, cancellationToken),
+                _ => null
             };
+
+            // Everything else is local and cheap; answer it inline (traced there)
+            return start is null
+                ? Task.FromResult(HandleHostCall(request.GetRawText(), streams))
+                : TraceHostCall(method!, start);
+        }
+        catch (Exception ex)
+        {
+            return Task.FromResult(CreateErrorResponse($"Error processing host call: {ex.Message}"));
+        }
+    }
+
+    /// <summary>
+    /// Starts an async host call inside its telemetry scope, which ends when the call finishes.
+    /// </summary>
+    private static Task<string> TraceHostCall(string method, Func<Task<string>> start)
+    {
+        var scope = ScriptBoxDiagnostics.StartHostCall(method);
+        try
+        {
+            return scope.Observe(start());
+        }
+        catch
+        {
+            scope.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Handles <c>__scriptbox.hostCallAll</c>: <paramref name="args"/> holds one host call request per
+    /// element. All calls are started before any is awaited and the response is
+    /// <c>{"result":[...]}</c> with each call's own <c>{"result"}</c>/<c>{"error"}</c> object in order.
+    /// </summary>
+    private Task<string> HandleBatchCallAsync(JsonElement args, HostStreamTable? streams, CancellationToken cancellationToken)
+    {
+        if (args.ValueKind != JsonValueKind.Array)
+        {
+            return Task.FromResult("{\"error\":\"host.batch expects an array of host calls\"}");
+        }
+
+        var responses = new Task<string>[args.GetArrayLength()];
+        var index = 0;
+        foreach (var request in args.EnumerateArray())
+        {
+            var isNested = request.ValueKind == JsonValueKind.Object &&
+                           request.TryGetProperty("method", out var method) &&
+                           method.ValueKind == JsonValueKind.String &&
+                           method.ValueEquals("host.batch");
+            responses[index++] = isNested
+                ? Task.FromResult("{\"error\":\"host.batch calls cannot be nested\"}")
+                : HandleHostCallAsync(request, streams, cancellationToken);
+        }
+
+        return CombineBatchResponsesAsync(responses);
+    }
+
+    private static async Task<string> CombineBatchResponsesAsync(Task<string>[] responses)
+    {
+        // Every response is already a JSON object (failures are escaped too), so they are spliced as-is
+        await Task.WhenAll(responses).ConfigureAwait(false);
+
+        var builder = new StringBuilder("{\"result\":[");
+        for (var i = 0; i < responses.Length; i++)
+        {
+            if (i > 0)
+            {
+                builder.Append(',');
+            }
+
+            builder.Append(responses[i].Result);
+        }
+
+        return builder.Append("]}").ToString();
+    }
+
+    /// <summary>
+    /// Builds a <c>{"error":...}</c> host call response. Messages can hold exception text and
+    /// script-chosen names, so they are escaped; the guest parses the response as JSON, and batches
+    /// splice it into theirs.
+    /// </summary>
+    private static string CreateErrorResponse(string message)
+    {
+        return "{\"error\":\"" + JsonEncodedText.Encode(message) + "\"}";
+    }
+
+    private bool TryGetHandlerById(
+        JsonElement idElement,
+        out string name,
+        out Func<HostCallContext, Task<object?>> handler)
+    {
+        if (idElement.ValueKind == JsonValueKind.Number && idElement.TryGetInt32(out var id))
+        {
+            return _methodTable.TryGet(id, out name, out handler);
+        }
+
+        name = string.Empty;
+        handler = null!;
+        return false;
+    }
+
+    /// <summary>
+    /// Awaits a JSON handler and serializes its result as <c>{"result":...}</c>.
+    /// </summary>
+    private async Task<string> SerializeHandlerResultAsync(Task<object?> pending)
+    {
+        try
+        {
+            var result = await pending.ConfigureAwait(false);
+            return JsonSerializer.Serialize(new { result }, _jsonOptions);
+        }
+        catch (Exception ex)
+        {
+            return CreateErrorResponse($"Error processing host call: {ex.Message}");
+        }
+    }
+
+    /// <summary>
+    /// Awaits a host API call and wraps its JSON in <c>{"result":...}</c>.
+    /// </summary>
+    /// <param name="isJson">The result is JSON already; otherwise it is serialized as a string.</param>
+    private static async Task<string> WrapHostResultAsync(Task<string> pending, bool isJson)
+    {
+        try
+        {
+            var result = await pending.ConfigureAwait(false);
+            return isJson
+                ? $"{{\"result\":{result}}}"
+                : JsonSerializer.Serialize(new { result });
         }
         catch (Exception ex)
         {
-            return $"{{\"error\":\"Error processing host call: {ex.Message}\"}}";
+            return CreateErrorResponse($"Error processing host call: {ex.Message}");
         }
     }
 
@@ -460,15 +1374,12 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
     /// </summary>
     private string HandleToolInvoke(JsonElement args)
     {
-        // args[0] is the JSON string of the request
-        var requestJson = args[0].GetString();
-        if (string.IsNullOrEmpty(requestJson))
+        var root = GetToolRequest(args, out var parsed);
+        using var doc = parsed;
+        if (root.ValueKind != JsonValueKind.Object)
         {
              return "{\"error\":\"Missing request JSON\"}";
         }
-
-        using var doc = JsonDocument.Parse(requestJson);
-        var root = doc.RootElement;
         
         if (!root.TryGetProperty("toolId", out var toolIdElement))
         {
@@ -490,7 +1401,59 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
              return JsonSerializer.Serialize(new { result }, _jsonOptions);
         }
         
-        return $"{{\"error\":\"Unknown tool: {toolId}\"}}";
+        return CreateErrorResponse($"Unknown tool: {toolId}");
+    }
+
+    /// <summary>
+    /// Async counterpart of <see cref="HandleToolInvoke"/> for <c>__host.bridgeAsync</c>.
+    /// </summary>
+    private Task<string> HandleToolInvokeAsync(JsonElement args, CancellationToken cancellationToken)
+    {
+        var root = GetToolRequest(args, out var parsed);
+        using var doc = parsed;
+        if (root.ValueKind != JsonValueKind.Object)
+        {
+            return Task.FromResult("{\"error\":\"Missing request JSON\"}");
+        }
+
+        var toolId = root.TryGetProperty("toolId", out var toolIdElement) ? toolIdElement.GetString() : null;
+        if (string.IsNullOrEmpty(toolId) || !_jsonHandlers.TryGetValue(toolId!, out var handler))
+        {
+            // Missing and unknown tools produce the same errors as the synchronous path
+            return Task.FromResult(HandleToolInvoke(args));
+        }
+
+        var context = HostCallContext.FromJson(toolId!, root, cancellationToken);
+        return SerializeHandlerResultAsync(handler(context));
+    }
+
+    /// <summary>
+    /// Returns the tool.invoke request in <c>args[0]</c>. It is passed as an object; older proxies
+    /// send the same object encoded as a JSON string, which is parsed into <paramref name="parsed"/>.
+    /// Returns <c>default</c> when the request is missing.
+    /// </summary>
+    private static JsonElement GetToolRequest(JsonElement args, out JsonDocument? parsed)
+    {
+        parsed = null;
+        if (args.ValueKind != JsonValueKind.Array || args.GetArrayLength() == 0)
+        {
+            return default;
+        }
+
+        var request = args[0];
+        if (request.ValueKind != JsonValueKind.String)
+        {
+            return request;
+        }
+
+        var requestJson = request.GetString();
+        if (string.IsNullOrEmpty(requestJson))
+        {
+            return default;
+        }
+
+        parsed = JsonDocument.Parse(requestJson);
+        return parsed.RootElement;
     }
 
     /// <summary>
@@ -588,6 +1551,17 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
         return "{\"result\":null}";
     }
 
+    /// <summary>
+    /// Handles the FileSystemOpenRead host call from the sandbox; the result is a stream handle.
+    /// </summary>
+    private string HandleFileSystemOpenReadCall(JsonElement args, HostStreamTable? streams)
+    {
+        var table = RequireStreams(streams);
+        var path = args[0].GetString() ?? throw new ArgumentException("path is required");
+        var handle = table.Add(_hostApi.FileSystemOpenRead(path));
+        return $"{{\"result\":{handle}}}";
+    }
+
     #endregion
 
     #region HTTP Client API Handlers
@@ -623,7 +1597,189 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
         return $"{{\"result\":{responseJson}}}";
     }
 
+    /// <summary>
+    /// Handles an async HttpGet host call from the sandbox.
+    /// </summary>
+    private Task<string> HandleHttpGetCallAsync(JsonElement args, CancellationToken cancellationToken)
+    {
+        var url = args[0].GetString() ?? throw new ArgumentException("url is required");
+        return WrapHostResultAsync(_hostApi.HttpGetAsync(url, cancellationToken), isJson: false);
+    }
+
+    /// <summary>
+    /// Handles an async HttpPost host call from the sandbox.
+    /// </summary>
+    private Task<string> HandleHttpPostCallAsync(JsonElement args, CancellationToken cancellationToken)
+    {
+        var url = args[0].GetString() ?? throw new ArgumentException("url is required");
+        var dataJson = args[1].GetString() ?? "{}";
+        return WrapHostResultAsync(_hostApi.HttpPostAsync(url, dataJson, cancellationToken), isJson: false);
+    }
+
+    /// <summary>
+    /// Handles an async HttpRequest host call from the sandbox.
+    /// </summary>
+    private Task<string> HandleHttpRequestCallAsync(JsonElement args, CancellationToken cancellationToken)
+    {
+        var optionsJson = args[0].GetString() ?? throw new ArgumentException("options is required");
+        return WrapHostResultAsync(_hostApi.HttpRequestAsync(optionsJson, cancellationToken), isJson: true);
+    }
+
+    /// <summary>
+    /// Handles the HttpOpen host call from the sandbox: sends the request, registers the unread
+    /// body and answers <c>{ handle, status, headers }</c>.
+    /// </summary>
+    private async Task<string> HandleHttpOpenCallAsync(JsonElement args, HostStreamTable? streams, CancellationToken cancellationToken)
+    {
+        try
+        {
+            var table = RequireStreams(streams);
+            var optionsJson = args[0].GetString() ?? throw new ArgumentException("options is required");
+            var opened = await _hostApi.HttpOpenAsync(optionsJson, cancellationToken).ConfigureAwait(false);
+            var handle = table.Add(opened.Body, opened.Response);
+            return JsonSerializer.Serialize(new { result = new { handle, status = opened.Status, headers = opened.Headers } });
+        }
+        catch (Exception ex)
+        {
+            return CreateErrorResponse($"Error processing host call: {ex.Message}");
+        }
+    }
+
+    #endregion
+
+    #region Stream API Handlers
+
+    private static HostStreamTable RequireStreams(HostStreamTable? streams) =>
+        streams ?? throw new InvalidOperationException("Stream handles are only available while a script runs");
+
+    /// <summary>
+    /// Handles the StreamRead host call: <c>[handle, maxBytes]</c>, answering the next chunk or null at the end.
+    /// </summary>
+    private string HandleStreamReadCall(JsonElement args, HostStreamTable? streams)
+    {
+        var table = RequireStreams(streams);
+        var chunk = table.Read(args[0].GetInt32(), args[1].GetInt32());
+        return JsonSerializer.Serialize(new { result = chunk });
+    }
+
+    /// <summary>
+    /// Handles an async StreamRead host call from the sandbox.
+    /// </summary>
+    private static async Task<string> HandleStreamReadCallAsync(JsonElement args, HostStreamTable? streams, CancellationToken cancellationToken)
+    {
+        try
+        {
+            var table = RequireStreams(streams);
+            var chunk = await table.ReadAsync(args[0].GetInt32(), args[1].GetInt32(), cancellationToken).ConfigureAwait(false);
+            return JsonSerializer.Serialize(new { result = chunk });
+        }
+        catch (Exception ex)
+        {
+            return CreateErrorResponse($"Error processing host call: {ex.Message}");
+        }
+    }
+
+    /// <summary>
+    /// Handles the StreamClose host call; closing an unknown or already closed handle is not an error.
+    /// </summary>
+    private static string HandleStreamCloseCall(JsonElement args, HostStreamTable? streams)
+    {
+        var closed = RequireStreams(streams).Close(args[0].GetInt32());
+        return $"{{\"result\":{(closed ? "true" : "false")}}}";
+    }
+
     #endregion
+
+    /// <summary>
+    /// What a run evaluates after the bootstrap: plain source, or a prepared script and its argument.
+    /// </summary>
+    private readonly struct UserScript
+    {
+        public UserScript(string code)
+        {
+            Code = code;
+            Prepared = null;
+            ArgumentJson = null;
+        }
+
+        public UserScript(PreparedScript prepared, string argumentJson)
+        {
+            Code = prepared.Body;
+            Prepared = prepared;
+            ArgumentJson = argumentJson;
+        }
+
+        public string Code { get; }
+
+        public PreparedScript? Prepared { get; }
+
+        public string? ArgumentJson { get; }
+
+        /// <summary>
+        /// The script as a body for the user IIFE. A prepared script becomes a call of its function
+        /// with the argument inlined, for modules that cannot pass it separately.
+        /// </summary>
+        public string ToSource(bool async) => Prepared is null
+            ? Code
+            : $"return {(async ? Prepared.AsyncFunctionSource : Prepared.FunctionSource)}({ArgumentJson});";
+    }
+
+    /// <summary>
+    /// Outcome of one guest step: the script result, or not completed while host calls are pending.
+    /// </summary>
+    private readonly struct GuestStep
+    {
+        public GuestStep(bool completed, object? result)
+        {
+            Completed = completed;
+            Result = result;
+        }
+
+        public bool Completed { get; }
+
+        public object? Result { get; }
+    }
+
+    /// <summary>
+    /// Timeout and fuel shared by all guest steps and host-call waits of one script.
+    /// </summary>
+    private sealed class ExecutionBudget
+    {
+        private readonly int _timeoutMs;
+        private readonly ulong? _fuel;
+        private readonly Stopwatch _elapsed = Stopwatch.StartNew();
+
+        public ExecutionBudget(int timeoutMs, ulong? fuel)
+        {
+            _timeoutMs = timeoutMs;
+            _fuel = fuel;
+            RemainingFuel = fuel;
+        }
+
+        /// <summary>
+        /// Fuel the next guest step may consume, or null without fuel metering.
+        /// </summary>
+        public ulong? RemainingFuel { get; set; }
+
+        /// <summary>
+        /// A timeout of 0 disables the limit.
+        /// </summary>
+        public bool IsUnlimited => _timeoutMs <= 0;
+
+        /// <summary>
+        /// Milliseconds left, or <see cref="Timeout.Infinite"/> when unlimited.
+        /// </summary>
+        public int RemainingMs => IsUnlimited
+            ? Timeout.Infinite
+            : (int)Math.Max(0, _timeoutMs - _elapsed.ElapsedMilliseconds);
+
+        public TimeoutException CreateTimeoutException() => new(
+            $"Script execution exceeded timeout limit of {_timeoutMs}ms. " +
+            "The script may have an infinite loop or is taking too long to complete.");
+
+        public InvalidOperationException CreateOutOfFuelException() => new(
+            $"Script execution exceeded its fuel budget of {_fuel} units.");
+    }
 #if NET6_0_OR_GREATER
     public ValueTask DisposeAsync()
     {
@@ -632,8 +1788,8 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
             return default(ValueTask);
         }
 
-        _module.Dispose();
-        _engine.Dispose();
+        _instancePool.Dispose();
+        _runtime.Dispose();
         _disposed = true;
         return default(ValueTask);
     }
@@ -645,8 +1801,8 @@ internal sealed class WasmScriptExecutor : IWasmScriptExecutor, IDisposable
             return;
         }
 
-        _module.Dispose();
-        _engine.Dispose();
+        _instancePool.Dispose();
+        _runtime.Dispose();
         _disposed = true;
     }
 #endif
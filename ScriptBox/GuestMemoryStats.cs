@@ -0,0 +1,24 @@
+namespace ScriptBox;
+
+/// <summary>
+/// QuickJS heap statistics of the instance that ran a script, taken when the script finished
+/// (<c>JS_ComputeMemoryUsage</c>). Collected only when enabled with
+/// <see cref="ScriptBoxBuilder.WithGuestMemoryStats"/>, since computing them walks the whole heap.
+/// </summary>
+/// <param name="HeapBytesInUse">Bytes QuickJS had allocated when the script finished.</param>
+/// <param name="PeakHeapBytes">Highest allocation total during the run (since the previous stats of the instance).</param>
+/// <param name="AllocationCount">Live allocations.</param>
+/// <param name="MemoryUsedBytes">Bytes used by QuickJS structures, as QuickJS accounts them.</param>
+/// <param name="ObjectCount">Live JavaScript objects.</param>
+/// <param name="StringCount">Live strings.</param>
+/// <param name="AtomCount">Interned atoms (property names, identifiers).</param>
+/// <param name="FunctionCount">Compiled JavaScript functions.</param>
+public readonly record struct GuestMemoryStats(
+    long HeapBytesInUse,
+    long PeakHeapBytes,
+    long AllocationCount,
+    long MemoryUsedBytes,
+    long ObjectCount,
+    long StringCount,
+    long AtomCount,
+    long FunctionCount);
@@ -1,4 +1,5 @@
 using System;
+using System.Threading;
 
 namespace ScriptBox;
 
@@ -20,6 +21,38 @@ public interface IScriptBox : IDisposable
     /// <returns>A new script session.</returns>
     ScriptSession CreateSession(TimeSpan? timeout = null);
 
+    /// <summary>
+    /// Creates a new session with the given options, e.g. one that keeps script state
+    /// between runs (<see cref="ScriptSessionOptions.PersistState"/>).
+    /// </summary>
+    /// <param name="options">Session options.</param>
+    /// <returns>A new script session.</returns>
+    ScriptSession CreateSession(ScriptSessionOptions options);
+
+    /// <summary>
+    /// Runs many independent scripts, spread over up to <paramref name="maxParallelism"/> warm
+    /// instances that each run their share one after another. Every script still starts from a
+    /// fresh global scope. A script that fails does not stop the batch; its result carries the
+    /// exception in <see cref="ScriptExecutionResult.Error"/>.
+    /// </summary>
+    /// <param name="scripts">The scripts to run.</param>
+    /// <param name="maxParallelism">Scripts running at once; defaults to the processor count.</param>
+    /// <param name="cancellationToken">Stops the batch; scripts not yet started are not run.</param>
+    /// <returns>One result per script, in the order of <paramref name="scripts"/>.</returns>
+    Task<IReadOnlyList<ScriptExecutionResult>> ExecuteBatchAsync(
+        IEnumerable<string> scripts,
+        int? maxParallelism = null,
+        CancellationToken cancellationToken = default);
+
+    /// <summary>
+    /// Prepares a script that takes one argument, for running many times with different inputs
+    /// through <see cref="ScriptSession.RunAsync(PreparedScript, object?, CancellationToken)"/>.
+    /// The function is compiled once per box and the input is passed as data, not spliced into the source.
+    /// </summary>
+    /// <param name="functionBody">The body of the function, e.g. <c>return input.a + input.b;</c>.</param>
+    /// <param name="parameterName">The name the body uses for the argument.</param>
+    PreparedScript Prepare(string functionBody, string parameterName = "input");
+
     /// <summary>
     /// Gets metadata associated with this ScriptBox instance.
     /// </summary>
@@ -12,9 +12,24 @@ public interface IScriptBoxConfigurator
 {
     IScriptBoxConfigurator WithWasmModuleFromPath(string path);
     IScriptBoxConfigurator WithWasmModule(ReadOnlyMemory<byte> moduleBytes);
+    IScriptBoxConfigurator WithPreinitializedWasmModule();
+    IScriptBoxConfigurator WithPreinitializedWasmModuleFromPath(string path);
+    IScriptBoxConfigurator WithPrecompiledWasmModuleFromPath(string path, bool preinitialized = false);
+    IScriptBoxConfigurator WithCompilationCache(string? configPath = null);
+    IScriptBoxConfigurator WithSharedModule(bool enabled = true);
+    IScriptBoxConfigurator WithBuildProfile(WasmBuildProfile profile);
     IScriptBoxConfigurator WithStartupFile(string path);
     IScriptBoxConfigurator WithStartupScript(Func<CancellationToken, Task<string>> loader);
     IScriptBoxConfigurator WithExecutionTimeout(TimeSpan timeout);
+    IScriptBoxConfigurator WithInstanceReuse(bool enabled = true);
+    IScriptBoxConfigurator WithInstancePool(int minSize, int maxSize);
+    IScriptBoxConfigurator WithBytecodeCache(int maxScripts);
+    IScriptBoxConfigurator WithBinaryHostCalls(bool enabled = true);
+    IScriptBoxConfigurator WithStructuredResults(bool enabled = true);
+    IScriptBoxConfigurator WithGuestMemoryStats(bool enabled = true);
+    IScriptBoxConfigurator WithProfiling(bool enabled = true, TimeSpan? sampleInterval = null);
+    IScriptBoxConfigurator WithEpochInterruption(bool enabled = true, TimeSpan? tickInterval = null);
+    IScriptBoxConfigurator WithFuelLimit(ulong fuelPerScript);
     IScriptBoxConfigurator RegisterApisFrom<T>(string? name = null);
     IScriptBoxConfigurator RegisterApisFrom(Type type, string? name = null);
     IScriptBoxConfigurator AddFromType<T>(string? name = null);
@@ -24,4 +39,5 @@ public interface IScriptBoxConfigurator
     IScriptBoxConfigurator WithSandboxConfiguration(SandboxConfiguration configuration);
     IScriptBoxConfigurator ConfigureFileSystem(Action<ScriptBoxBuilder.FileSystemConfigurationBuilder> configure);
     IScriptBoxConfigurator ConfigureNetwork(Action<ScriptBoxBuilder.NetworkConfigurationBuilder> configure);
+    IScriptBoxConfigurator ConfigureMemory(Action<ScriptBoxBuilder.MemoryConfigurationBuilder> configure);
 }
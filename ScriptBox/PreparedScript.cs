@@ -0,0 +1,54 @@
+using System;
+using System.Text.RegularExpressions;
+using System.Threading;
+
+namespace ScriptBox;
+
+/// <summary>
+/// A script body that is compiled once and then run with different inputs through
+/// <see cref="ScriptSession.RunAsync(PreparedScript, object?, CancellationToken)"/>. The input is
+/// passed to the guest as data and bound to <see cref="ParameterName"/>, so it never becomes part
+/// of the source and every run reuses the same bytecode. Create one with <see cref="IScriptBox.Prepare"/>.
+/// </summary>
+public sealed class PreparedScript
+{
+    private static readonly Regex IdentifierPattern = new("^[A-Za-z_$][A-Za-z0-9_$]*$", RegexOptions.CultureInvariant);
+
+    internal PreparedScript(string body, string parameterName)
+    {
+        if (body is null)
+        {
+            throw new ArgumentNullException(nameof(body));
+        }
+
+        if (parameterName is null || !IdentifierPattern.IsMatch(parameterName))
+        {
+            throw new ArgumentException("Parameter name must be a JavaScript identifier", nameof(parameterName));
+        }
+
+        Body = body;
+        ParameterName = parameterName;
+        FunctionSource = $"(function ({parameterName}) {{\n{body}\n}})";
+        AsyncFunctionSource = $"(async function ({parameterName}) {{\n{body}\n}})";
+    }
+
+    /// <summary>
+    /// The script body; like a regular script it may <c>return</c> a value.
+    /// </summary>
+    public string Body { get; }
+
+    /// <summary>
+    /// Name under which the body sees the input of each run.
+    /// </summary>
+    public string ParameterName { get; }
+
+    /// <summary>
+    /// The body as a function expression, for modules without async host calls.
+    /// </summary>
+    internal string FunctionSource { get; }
+
+    /// <summary>
+    /// The body as an async function expression, so it can <c>await</c> host calls.
+    /// </summary>
+    internal string AsyncFunctionSource { get; }
+}
@@ -1,4 +1,5 @@
 using System;
+using System.Threading;
 using ScriptBox.Core.WasmExecution;
 
 namespace ScriptBox;
@@ -15,19 +16,19 @@ public sealed class ScriptBox : IScriptBox, IDisposable
 {
 #endif
     private readonly WasmScriptExecutor _executor;
-    private readonly string _startupCode;
+    private readonly BootstrapArtifact _startup;
     private readonly TimeSpan _defaultTimeout;
 
     public IReadOnlyDictionary<string, object> Metadata { get; }
 
     internal ScriptBox(
         WasmScriptExecutor executor,
-        string startupCode,
+        BootstrapArtifact startup,
         TimeSpan defaultTimeout,
         IReadOnlyDictionary<string, object> metadata)
     {
         _executor = executor ?? throw new ArgumentNullException(nameof(executor));
-        _startupCode = startupCode ?? string.Empty;
+        _startup = startup ?? BootstrapArtifact.Empty;
         _defaultTimeout = defaultTimeout;
         Metadata = metadata ?? new Dictionary<string, object>();
     }
@@ -36,10 +37,99 @@ public sealed class ScriptBox : IScriptBox, IDisposable
     {
         return new ScriptSession(
             _executor,
-            _startupCode,
+            _startup,
             timeout ?? _defaultTimeout);
     }
 
+    public ScriptSession CreateSession(ScriptSessionOptions options)
+    {
+        if (options is null)
+        {
+            throw new ArgumentNullException(nameof(options));
+        }
+
+        options.Validate();
+        return new ScriptSession(
+            _executor,
+            _startup,
+            options.Timeout ?? _defaultTimeout,
+            options.PersistState,
+            options.PersistState ? options.MaxMemoryBytes : null);
+    }
+
+    public PreparedScript Prepare(string functionBody, string parameterName = "input")
+    {
+        return new PreparedScript(functionBody, parameterName);
+    }
+
+    public async Task<IReadOnlyList<ScriptExecutionResult>> ExecuteBatchAsync(
+        IEnumerable<string> scripts,
+        int? maxParallelism = null,
+        CancellationToken cancellationToken = default)
+    {
+        if (scripts is null)
+        {
+            throw new ArgumentNullException(nameof(scripts));
+        }
+
+        if (maxParallelism <= 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxParallelism), "Parallelism must be positive");
+        }
+
+        var batch = scripts as IReadOnlyList<string> ?? scripts.ToList();
+        var results = new ScriptExecutionResult[batch.Count];
+        if (batch.Count == 0)
+        {
+            return results;
+        }
+
+        // Workers claim the next script as they finish one, so slow scripts do not hold up a shard
+        var next = -1;
+        var workers = new Task[Math.Min(batch.Count, maxParallelism ?? Environment.ProcessorCount)];
+        for (var i = 0; i < workers.Length; i++)
+        {
+            workers[i] = Task.Run(
+                () => RunBatchWorkerAsync(batch, results, () => Interlocked.Increment(ref next), cancellationToken),
+                cancellationToken);
+        }
+
+        await Task.WhenAll(workers).ConfigureAwait(false);
+        return results;
+    }
+
+    /// <summary>
+    /// Runs scripts of a batch on one session, i.e. one warm instance, until none are left.
+    /// </summary>
+    private async Task RunBatchWorkerAsync(
+        IReadOnlyList<string> batch,
+        ScriptExecutionResult[] results,
+        Func<int> claimNext,
+        CancellationToken cancellationToken)
+    {
+        var session = CreateSession();
+        try
+        {
+            int index;
+            while ((index = claimNext()) < batch.Count)
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                try
+                {
+                    results[index] = await session.ExecuteAsync(batch[index], cancellationToken).ConfigureAwait(false);
+                }
+                catch (Exception ex) when (!cancellationToken.IsCancellationRequested)
+                {
+                    results[index] = new ScriptExecutionResult { Error = ex };
+                }
+            }
+        }
+        finally
+        {
+            await session.DisposeAsync().ConfigureAwait(false);
+        }
+    }
+
 #if NET6_0_OR_GREATER
     public ValueTask DisposeAsync()
     {
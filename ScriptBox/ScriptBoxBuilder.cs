@@ -43,13 +43,18 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
     private readonly List<ISandboxApiScanner> _apiScanners = new();
     private string? _wasmModulePath;
     private byte[]? _wasmModuleBytes;
+    private bool _usePreinitializedModule;
+    private bool _useEmbeddedSnapshot;
+    private string? _precompiledModulePath;
+    private WasmBuildProfile? _buildProfile;
+    private bool _binaryHostCalls;
     private TimeSpan _executionTimeout = TimeSpan.FromMilliseconds(WasmConfiguration.DefaultTimeoutMs);
     private SandboxConfiguration? _sandboxConfiguration;
     private Func<Type, object?>? _apiFactory;
+    private readonly WasmExecutorOptions _executorOptions = WasmExecutorOptions.CreateDefault();
 
     private ScriptBoxBuilder()
     {
-        _startupScriptLoaders.Add(_ => Task.FromResult(DefaultRuntimeResources.LoadCoreBootstrap()));
         _apiScanners.Add(new AttributedSandboxApiScanner());
     }
 
@@ -126,6 +131,9 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
 
         _wasmModulePath = path;
         _wasmModuleBytes = null;
+        _precompiledModulePath = null;
+        _usePreinitializedModule = false;
+        _useEmbeddedSnapshot = false;
         return this;
     }
 
@@ -138,6 +146,106 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
 
         _wasmModuleBytes = moduleBytes.ToArray();
         _wasmModulePath = null;
+        _precompiledModulePath = null;
+        _usePreinitializedModule = false;
+        _useEmbeddedSnapshot = false;
+        return this;
+    }
+
+    /// <summary>
+    /// Uses the pre-initialized snapshot module embedded in the package
+    /// (built with <c>build.sh --snapshot</c>). The QuickJS runtime and core bootstrap
+    /// are already initialized in its linear memory, so each execution only evaluates
+    /// registered APIs, custom startup scripts and the user script.
+    /// </summary>
+    public ScriptBoxBuilder WithPreinitializedWasmModule()
+    {
+        _wasmModuleBytes = null;
+        _wasmModulePath = null;
+        _precompiledModulePath = null;
+        _usePreinitializedModule = true;
+        _useEmbeddedSnapshot = true;
+        return this;
+    }
+
+    /// <summary>
+    /// Uses a pre-initialized snapshot module (output of <c>build.sh --snapshot</c>) from disk.
+    /// </summary>
+    public ScriptBoxBuilder WithPreinitializedWasmModuleFromPath(string path)
+    {
+        WithWasmModuleFromPath(path);
+        _usePreinitializedModule = true;
+        return this;
+    }
+
+    /// <summary>
+    /// Loads native code precompiled by <c>build.sh --precompile</c> instead of compiling the
+    /// WebAssembly module at startup. <paramref name="path"/> is a <c>.cwasm</c> file or the
+    /// precompiled output directory, from which the artifact for the current platform is chosen.
+    /// If the artifact is missing or was built by a different Wasmtime version, the embedded
+    /// module is compiled instead (the embedded snapshot when <paramref name="preinitialized"/> is set).
+    /// </summary>
+    /// <param name="path">Precompiled file or directory.</param>
+    /// <param name="preinitialized">The artifact was compiled from <c>scriptbox.snapshot.wasm</c>.</param>
+    public ScriptBoxBuilder WithPrecompiledWasmModuleFromPath(string path, bool preinitialized = false)
+    {
+        if (string.IsNullOrWhiteSpace(path))
+        {
+            throw new ArgumentException("Precompiled module path cannot be null or empty", nameof(path));
+        }
+
+        _precompiledModulePath = path;
+        _wasmModulePath = null;
+        _wasmModuleBytes = null;
+        _usePreinitializedModule = preinitialized;
+        _useEmbeddedSnapshot = false;
+        return this;
+    }
+
+    /// <summary>
+    /// Selects which embedded module build runs scripts. By default the release build is used
+    /// when the package contains it (<c>build.sh --release</c>), otherwise the debug build.
+    /// Only applies to the embedded module, not to modules loaded from a path or bytes.
+    /// </summary>
+    /// <exception cref="InvalidOperationException">
+    /// Raised by <see cref="Build"/> when <see cref="WasmBuildProfile.Release"/> is requested
+    /// but no release module is embedded.
+    /// </exception>
+    public ScriptBoxBuilder WithBuildProfile(WasmBuildProfile profile)
+    {
+        _buildProfile = profile;
+        return this;
+    }
+
+    /// <summary>
+    /// Enables Wasmtime's on-disk compilation cache: machine code for the module is stored
+    /// after the first compile and reused by later processes.
+    /// </summary>
+    /// <param name="configPath">
+    /// Optional Wasmtime cache configuration file (TOML). When null, Wasmtime's defaults
+    /// and platform cache directory are used.
+    /// </param>
+    public ScriptBoxBuilder WithCompilationCache(string? configPath = null)
+    {
+        if (configPath is not null && !File.Exists(configPath))
+        {
+            throw new FileNotFoundException($"Wasmtime cache configuration not found at {configPath}", configPath);
+        }
+
+        _executorOptions.UseCompilationCache = true;
+        _executorOptions.CompilationCacheConfigPath = configPath;
+        return this;
+    }
+
+    /// <summary>
+    /// Controls whether the compiled module is shared with other ScriptBox instances in the process
+    /// (default: enabled). Builders that load the same module with the same engine settings then
+    /// compile it once, and every later <see cref="Build"/> costs only its host bridge and pool.
+    /// Instances, their memory and the registered APIs are never shared.
+    /// </summary>
+    public ScriptBoxBuilder WithSharedModule(bool enabled = true)
+    {
+        _executorOptions.ShareModule = enabled;
         return this;
     }
 
@@ -162,6 +270,12 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
         return this;
     }
 
+    /// <summary>
+    /// Sets the default timeout of a script run (default: 5 seconds; zero disables it).
+    /// Modules built with cooperative deadlines stop a script that runs past it from the QuickJS
+    /// interrupt handler and keep the instance. Otherwise epoch interruption (see
+    /// <see cref="WithEpochInterruption"/>) stops it inside the guest and its instance is discarded.
+    /// </summary>
     public ScriptBoxBuilder WithExecutionTimeout(TimeSpan timeout)
     {
         if (timeout < TimeSpan.Zero)
@@ -173,6 +287,157 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
         return this;
     }
 
+    /// <summary>
+    /// Controls whether WASM instances are kept warm and reused between scripts (default: enabled).
+    /// Reused instances keep their QuickJS runtime but give every script a fresh context,
+    /// so globals never carry over. Disable to instantiate the module for every script.
+    /// </summary>
+    public ScriptBoxBuilder WithInstanceReuse(bool enabled = true)
+    {
+        _executorOptions.ReuseInstances = enabled;
+        return this;
+    }
+
+    /// <summary>
+    /// Sends calls to registered host handlers as MessagePack instead of JSON (default: disabled).
+    /// The guest encodes arguments natively from JS values, and typed
+    /// <c>[SandboxMethod]</c> parameters are read without boxing. Results arrive in the guest as
+    /// they would through JSON. Built-in methods (Log, FileSystem*, Http*) and modules built
+    /// without <c>__host.bridgeBinary</c> keep using JSON.
+    /// </summary>
+    public ScriptBoxBuilder WithBinaryHostCalls(bool enabled = true)
+    {
+        _binaryHostCalls = enabled;
+        return this;
+    }
+
+    /// <summary>
+    /// Returns script results as .NET values instead of JSON text (default: disabled). The guest
+    /// encodes the returned value as MessagePack directly into its result buffer and the host
+    /// decodes it without building a string: objects become case-insensitive
+    /// <c>Dictionary&lt;string, object?&gt;</c>, arrays <c>List&lt;object?&gt;</c>, integers
+    /// <see cref="long"/> and other numbers <see cref="double"/>. <c>undefined</c> becomes null.
+    /// Modules built without binary results keep returning JSON text.
+    /// </summary>
+    public ScriptBoxBuilder WithStructuredResults(bool enabled = true)
+    {
+        _executorOptions.StructuredResults = enabled;
+        return this;
+    }
+
+    /// <summary>
+    /// Fills <see cref="ScriptExecutionResult.Memory"/> with QuickJS heap statistics after every
+    /// script (default: disabled). Computing them walks the whole guest heap, so this adds time
+    /// proportional to what the script allocated. Modules built without memory stats leave it null.
+    /// Timings are always published through <see cref="ScriptBoxDiagnostics"/>.
+    /// </summary>
+    public ScriptBoxBuilder WithGuestMemoryStats(bool enabled = true)
+    {
+        _executorOptions.CollectMemoryStats = enabled;
+        return this;
+    }
+
+    /// <summary>
+    /// Samples the JavaScript stack of every script every <paramref name="sampleInterval"/>
+    /// (default: 1ms) and attaches the result to <see cref="ScriptExecutionResult.Profile"/>
+    /// (default: disabled). Sampling captures an <c>Error</c> backtrace each time, so it slows
+    /// scripts down roughly in proportion to the sampling rate. Modules built without the
+    /// profiler leave the profile null.
+    /// </summary>
+    public ScriptBoxBuilder WithProfiling(bool enabled = true, TimeSpan? sampleInterval = null)
+    {
+        if (sampleInterval is { } interval && interval.Ticks < 10)
+        {
+            throw new ArgumentOutOfRangeException(nameof(sampleInterval), "Sample interval must be at least 1 microsecond");
+        }
+
+        _executorOptions.ProfileSampleInterval = enabled
+            ? sampleInterval ?? WasmConfiguration.DefaultProfileSampleInterval
+            : null;
+        return this;
+    }
+
+    /// <summary>
+    /// Sizes the pool of ready-to-run WASM instances. <paramref name="minSize"/> instances are
+    /// created in the background when the ScriptBox is built and topped up after each rent;
+    /// at most <paramref name="maxSize"/> idle instances are retained. Instances needed beyond
+    /// that during a burst are still created on demand and disposed when returned.
+    /// </summary>
+    public ScriptBoxBuilder WithInstancePool(int minSize, int maxSize)
+    {
+        if (minSize < 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(minSize), "Minimum pool size must be non-negative");
+        }
+
+        if (maxSize < 1 || maxSize < minSize)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxSize), "Maximum pool size must be positive and at least the minimum size");
+        }
+
+        _executorOptions.MinIdleInstances = minSize;
+        _executorOptions.MaxIdleInstances = maxSize;
+        return this;
+    }
+
+    /// <summary>
+    /// Sets how many distinct user scripts keep their compiled QuickJS bytecode
+    /// (default: 128, least recently used evicted first). Repeated scripts then skip parsing.
+    /// Pass 0 to compile every user script afresh; bootstrap code is cached regardless.
+    /// Has no effect with WASM modules built before the bytecode exports existed.
+    /// </summary>
+    public ScriptBoxBuilder WithBytecodeCache(int maxScripts)
+    {
+        if (maxScripts < 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(maxScripts), "Bytecode cache size must be non-negative");
+        }
+
+        _executorOptions.ScriptBytecodeCacheSize = maxScripts;
+        return this;
+    }
+
+    /// <summary>
+    /// Controls Wasmtime epoch interruption (default: enabled). The engine ticks every
+    /// <paramref name="tickInterval"/> (default: 10ms) and a guest step that outlives its timeout
+    /// traps within about one tick, so timed-out scripts stop using CPU. Precompiled modules must be
+    /// compiled with the same setting (<c>build.sh --precompile</c> does); mismatched ones fall back
+    /// to the WebAssembly module. When disabled, timed-out scripts keep running in the background.
+    /// </summary>
+    public ScriptBoxBuilder WithEpochInterruption(bool enabled = true, TimeSpan? tickInterval = null)
+    {
+        if (tickInterval is { } interval)
+        {
+            if (interval.TotalMilliseconds < 1 || interval.TotalMilliseconds > int.MaxValue)
+            {
+                throw new ArgumentOutOfRangeException(nameof(tickInterval), "Tick interval must be at least 1ms");
+            }
+
+            _executorOptions.EpochTickMs = (int)interval.TotalMilliseconds;
+        }
+
+        _executorOptions.EpochInterruption = enabled;
+        return this;
+    }
+
+    /// <summary>
+    /// Limits every script run to <paramref name="fuelPerScript"/> units of Wasmtime fuel, roughly one
+    /// per WASM instruction including the bootstrap. Unlike timeouts the limit does not depend on
+    /// machine load, so the same script always passes or fails the same way. Scripts over budget fail
+    /// with <see cref="InvalidOperationException"/> and their instance is discarded. Fuel metering
+    /// slows guest code down; precompiled modules need <c>PRECOMPILE_FLAGS</c> with <c>consume-fuel=y</c>.
+    /// </summary>
+    public ScriptBoxBuilder WithFuelLimit(ulong fuelPerScript)
+    {
+        if (fuelPerScript == 0 || fuelPerScript > WasmConfiguration.UnboundedFuel)
+        {
+            throw new ArgumentOutOfRangeException(nameof(fuelPerScript), $"Fuel limit must be between 1 and {WasmConfiguration.UnboundedFuel}");
+        }
+
+        _executorOptions.FuelPerScript = fuelPerScript;
+        return this;
+    }
+
     public ScriptBoxBuilder RegisterApisFrom<T>(string? name = null)
     {
         return RegisterApisFrom(typeof(T), name);
@@ -237,7 +502,6 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
 
         var moduleSource = ResolveModuleSource();
         var configStartupScripts = _sandboxConfiguration?.StartupScripts?.ToList();
-        var startupCode = LoadStartupCode(configStartupScripts);
         var hostHandlers = _hostApiBuilder.Build();
 
         var config = _sandboxConfiguration ?? SandboxConfiguration.CreateDefault();
@@ -247,13 +511,58 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
             hostApi: null,
             config: config,
             jsonHandlers: hostHandlers,
-            moduleSource: moduleSource);
+            moduleSource: moduleSource,
+            options: _executorOptions);
 
-        return new ScriptBox(executor, startupCode, _executionTimeout, _metadata);
+        // Read and compiled once here; runs replay the bytecode
+        BootstrapArtifact startup;
+        try
+        {
+            var startupCode = LoadStartupCode(executor.MethodTable.BuildBootstrap(_binaryHostCalls), configStartupScripts);
+            startup = executor.CreateBootstrap(startupCode);
+        }
+        catch
+        {
+#if NET6_0_OR_GREATER
+            executor.DisposeAsync().GetAwaiter().GetResult();
+#else
+            executor.Dispose();
+#endif
+            throw;
+        }
+
+        return new ScriptBox(executor, startup, _executionTimeout, _metadata);
     }
 
     private WasmModuleSource ResolveModuleSource()
     {
+        if (_precompiledModulePath is not null)
+        {
+            WasmModuleSource? fallback = null;
+            if (!_usePreinitializedModule)
+            {
+                fallback = WasmModuleSource.FromBytes(LoadEmbeddedWasm());
+            }
+            else if (DefaultRuntimeResources.TryLoadEmbeddedSnapshotWasm(out var snapshotFallback))
+            {
+                fallback = WasmModuleSource.FromBytes(snapshotFallback, isPreinitialized: true);
+            }
+
+            return WasmModuleSource.FromPrecompiledPath(_precompiledModulePath, fallback, _usePreinitializedModule);
+        }
+
+        if (_useEmbeddedSnapshot)
+        {
+            if (!DefaultRuntimeResources.TryLoadEmbeddedSnapshotWasm(out var snapshot))
+            {
+                throw new InvalidOperationException(
+                    "No pre-initialized WASM module is embedded in this build. Run 'ScriptBox.Wasm/build.sh --snapshot' " +
+                    "before packing, or use WithPreinitializedWasmModuleFromPath.");
+            }
+
+            return WasmModuleSource.FromBytes(snapshot, isPreinitialized: true);
+        }
+
         if (_wasmModuleBytes is not null)
         {
             return WasmModuleSource.FromBytes(_wasmModuleBytes);
@@ -261,17 +570,42 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
 
         if (!string.IsNullOrWhiteSpace(_wasmModulePath))
         {
-            return WasmModuleSource.FromPath(_wasmModulePath!);
+            return WasmModuleSource.FromPath(_wasmModulePath!, _usePreinitializedModule);
         }
 
-        var embedded = DefaultRuntimeResources.LoadEmbeddedWasm();
-        return WasmModuleSource.FromBytes(embedded);
+        return WasmModuleSource.FromBytes(LoadEmbeddedWasm());
     }
 
-    private string LoadStartupCode(IEnumerable<string>? configScripts)
+    private ReadOnlyMemory<byte> LoadEmbeddedWasm()
+    {
+        if (_buildProfile is null)
+        {
+            return DefaultRuntimeResources.LoadEmbeddedWasm();
+        }
+
+        if (!DefaultRuntimeResources.TryLoadEmbeddedWasm(_buildProfile.Value, out var moduleBytes))
+        {
+            throw new InvalidOperationException(
+                $"No {_buildProfile.Value} WASM module is embedded in this build. " +
+                "Run 'ScriptBox.Wasm/build.sh --release' before packing, or use WithWasmModuleFromPath.");
+        }
+
+        return moduleBytes;
+    }
+
+    private string LoadStartupCode(string methodIdBootstrap, IEnumerable<string>? configScripts)
     {
         var builder = new StringBuilder();
 
+        // A pre-initialized module already evaluated the core bootstrap at build time.
+        if (!_usePreinitializedModule)
+        {
+            AppendStartupScript(builder, DefaultRuntimeResources.LoadCoreBootstrap());
+        }
+
+        // Before any proxies are created, so they resolve their IDs on the first call
+        AppendStartupScript(builder, methodIdBootstrap);
+
         foreach (var loader in _startupScriptLoaders)
         {
             var code = loader(CancellationToken.None).GetAwaiter().GetResult();
@@ -323,9 +657,17 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
         EnsureDefaultScannersLoaded();
 
         var descriptorsAndInstances = new List<(SandboxApiDescriptor Descriptor, object? Instance)>();
+        var bootstrap = new StringBuilder();
 
         foreach (var (type, ns) in _registeredApiTypes)
         {
+            // Source-generated bindings need no reflection scan
+            if (GeneratedSandboxApiRegistry.TryGet(type, out var generated))
+            {
+                RegisterGeneratedApi(generated, ns, null, bootstrap);
+                continue;
+            }
+
             SandboxApiDescriptor? descriptor = null;
             foreach (var scanner in _apiScanners)
             {
@@ -342,11 +684,18 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
             }
 
             descriptorsAndInstances.Add((descriptor, null));
+            bootstrap.Append(AttributedSandboxApiRegistry.BuildBootstrap(new[] { descriptor }));
         }
 
         foreach (var (instance, ns) in _registeredApiInstances)
         {
             var type = instance.GetType();
+            if (GeneratedSandboxApiRegistry.TryGet(type, out var generated))
+            {
+                RegisterGeneratedApi(generated, ns, instance, bootstrap);
+                continue;
+            }
+
             SandboxApiDescriptor? descriptor = null;
             foreach (var scanner in _apiScanners)
             {
@@ -363,17 +712,18 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
             }
 
             descriptorsAndInstances.Add((descriptor, instance));
+            bootstrap.Append(AttributedSandboxApiRegistry.BuildBootstrap(new[] { descriptor }));
         }
 
-        if (descriptorsAndInstances.Count == 0)
+        if (bootstrap.Length > 0)
         {
-            return;
+            var bootstrapCode = bootstrap.ToString();
+            _startupScriptLoaders.Add(_ => Task.FromResult(bootstrapCode));
         }
 
-        var bootstrap = AttributedSandboxApiRegistry.BuildBootstrap(descriptorsAndInstances.Select(x => x.Descriptor));
-        if (!string.IsNullOrWhiteSpace(bootstrap))
+        if (descriptorsAndInstances.Count == 0)
         {
-            _startupScriptLoaders.Add(_ => Task.FromResult(bootstrap));
+            return;
         }
 
         AttributedSandboxApiRegistry.RegisterHandlers(
@@ -382,7 +732,25 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
             ResolveApiInstance);
     }
 
-    private object ResolveApiInstance(Type apiType)
+    private void RegisterGeneratedApi(GeneratedSandboxApi api, string? ns, object? instance, StringBuilder bootstrap)
+    {
+        var jsNamespace = ns ?? api.JsNamespace;
+        if (api.RequiresInstance && instance is null)
+        {
+            instance = ResolveApiInstance(api.ApiType, api.CreateInstance);
+        }
+
+        // The generated proxy is only valid for the attribute's namespace
+        bootstrap.Append(jsNamespace == api.JsNamespace
+            ? api.Bootstrap
+            : AttributedSandboxApiRegistry.BuildApiBootstrap(jsNamespace, api.Methods.Select(m => m.JsMethodName)));
+
+        AttributedSandboxApiRegistry.RegisterGeneratedHandlers(api, jsNamespace, instance, _hostApiBuilder);
+    }
+
+    private object ResolveApiInstance(Type apiType) => ResolveApiInstance(apiType, null);
+
+    private object ResolveApiInstance(Type apiType, Func<object>? createInstance)
     {
         if (apiType is null)
         {
@@ -397,7 +765,7 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
 
         if (instance is null)
         {
-            instance = Activator.CreateInstance(apiType);
+            instance = createInstance is not null ? createInstance() : Activator.CreateInstance(apiType);
         }
 
         if (instance is null)
@@ -433,13 +801,42 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
         return this;
     }
 
+    /// <summary>
+    /// Sets per-instance memory limits: the Wasmtime cap on linear memory and the QuickJS heap
+    /// limit and GC threshold. Scripts that hit a limit fail with an "out of memory" error instead
+    /// of growing the host process, so more sandboxes fit on a node safely.
+    /// </summary>
+    public ScriptBoxBuilder ConfigureMemory(Action<MemoryConfigurationBuilder> configure)
+    {
+        if (configure is null) throw new ArgumentNullException(nameof(configure));
+        var config = _sandboxConfiguration ??= SandboxConfiguration.CreateDefault();
+        var builder = new MemoryConfigurationBuilder(config);
+        configure(builder);
+        return this;
+    }
+
     #region IScriptBoxConfigurator Explicit Implementation
 
     IScriptBoxConfigurator IScriptBoxConfigurator.WithWasmModuleFromPath(string path) => WithWasmModuleFromPath(path);
     IScriptBoxConfigurator IScriptBoxConfigurator.WithWasmModule(ReadOnlyMemory<byte> moduleBytes) => WithWasmModule(moduleBytes);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithPreinitializedWasmModule() => WithPreinitializedWasmModule();
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithPreinitializedWasmModuleFromPath(string path) => WithPreinitializedWasmModuleFromPath(path);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithPrecompiledWasmModuleFromPath(string path, bool preinitialized) => WithPrecompiledWasmModuleFromPath(path, preinitialized);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithCompilationCache(string? configPath) => WithCompilationCache(configPath);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithSharedModule(bool enabled) => WithSharedModule(enabled);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithBuildProfile(WasmBuildProfile profile) => WithBuildProfile(profile);
     IScriptBoxConfigurator IScriptBoxConfigurator.WithStartupFile(string path) => WithStartupFile(path);
     IScriptBoxConfigurator IScriptBoxConfigurator.WithStartupScript(Func<CancellationToken, Task<string>> loader) => WithStartupScript(loader);
     IScriptBoxConfigurator IScriptBoxConfigurator.WithExecutionTimeout(TimeSpan timeout) => WithExecutionTimeout(timeout);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithInstanceReuse(bool enabled) => WithInstanceReuse(enabled);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithInstancePool(int minSize, int maxSize) => WithInstancePool(minSize, maxSize);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithBytecodeCache(int maxScripts) => WithBytecodeCache(maxScripts);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithBinaryHostCalls(bool enabled) => WithBinaryHostCalls(enabled);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithStructuredResults(bool enabled) => WithStructuredResults(enabled);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithGuestMemoryStats(bool enabled) => WithGuestMemoryStats(enabled);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithProfiling(bool enabled, TimeSpan? sampleInterval) => WithProfiling(enabled, sampleInterval);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithEpochInterruption(bool enabled, TimeSpan? tickInterval) => WithEpochInterruption(enabled, tickInterval);
+    IScriptBoxConfigurator IScriptBoxConfigurator.WithFuelLimit(ulong fuelPerScript) => WithFuelLimit(fuelPerScript);
     IScriptBoxConfigurator IScriptBoxConfigurator.RegisterApisFrom<T>(string? name) => RegisterApisFrom<T>(name);
     IScriptBoxConfigurator IScriptBoxConfigurator.RegisterApisFrom(Type type, string? name) => RegisterApisFrom(type, name);
     IScriptBoxConfigurator IScriptBoxConfigurator.AddFromType<T>(string? name) => AddFromType<T>(name);
@@ -449,6 +846,7 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
     IScriptBoxConfigurator IScriptBoxConfigurator.WithSandboxConfiguration(SandboxConfiguration configuration) => WithSandboxConfiguration(configuration);
     IScriptBoxConfigurator IScriptBoxConfigurator.ConfigureFileSystem(Action<FileSystemConfigurationBuilder> configure) => ConfigureFileSystem(configure);
     IScriptBoxConfigurator IScriptBoxConfigurator.ConfigureNetwork(Action<NetworkConfigurationBuilder> configure) => ConfigureNetwork(configure);
+    IScriptBoxConfigurator IScriptBoxConfigurator.ConfigureMemory(Action<MemoryConfigurationBuilder> configure) => ConfigureMemory(configure);
 
     #endregion
 
@@ -509,6 +907,21 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
             return this;
         }
 
+        /// <summary>
+        /// Sends HTTP calls through a process-wide pooled handler shared with every ScriptBox that
+        /// uses the same options, so repeated calls to the same backends reuse open connections
+        /// (and HTTP/2 streams) instead of a new TCP and TLS handshake per ScriptBox.
+        /// Reuse counters are available from <see cref="Core.HostApi.SharedHttpHandlers.GetMetrics"/>.
+        /// </summary>
+        public NetworkConfigurationBuilder UseSharedHttpHandler(Action<SharedHttpHandlerOptions>? configure = null)
+        {
+            var options = new SharedHttpHandlerOptions();
+            configure?.Invoke(options);
+            options.Validate();
+            _config.SharedHttpHandler = options;
+            return this;
+        }
+
         public NetworkConfigurationBuilder WithConsentHook(Func<NetworkConsentContext, bool> hook)
         {
             _config.NetworkConsentHook = hook;
@@ -535,4 +948,53 @@ public sealed class ScriptBoxBuilder : IScriptBoxConfigurator
             return this;
         }
     }
+
+    public sealed class MemoryConfigurationBuilder
+    {
+        private readonly SandboxConfiguration _config;
+
+        internal MemoryConfigurationBuilder(SandboxConfiguration config)
+        {
+            _config = config;
+        }
+
+        /// <summary>
+        /// Caps the linear memory of each WebAssembly instance (Wasmtime store limits).
+        /// </summary>
+        public MemoryConfigurationBuilder WithMaxGuestMemory(long maxBytes)
+        {
+            if (maxBytes <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maxBytes), "Size must be positive");
+            }
+            _config.MaxGuestMemoryBytes = maxBytes;
+            return this;
+        }
+
+        /// <summary>
+        /// Caps the live QuickJS heap of each instance (<c>JS_SetMemoryLimit</c>).
+        /// </summary>
+        public MemoryConfigurationBuilder WithScriptHeapLimit(long maxBytes)
+        {
+            if (maxBytes <= 0 || maxBytes > uint.MaxValue)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maxBytes), $"Size must be between 1 and {uint.MaxValue}");
+            }
+            _config.ScriptHeapLimitBytes = maxBytes;
+            return this;
+        }
+
+        /// <summary>
+        /// Sets how many bytes QuickJS allocates between automatic GC runs (<c>JS_SetGCThreshold</c>).
+        /// </summary>
+        public MemoryConfigurationBuilder WithGcThreshold(long bytes)
+        {
+            if (bytes <= 0 || bytes > uint.MaxValue)
+            {
+                throw new ArgumentOutOfRangeException(nameof(bytes), $"Size must be between 1 and {uint.MaxValue}");
+            }
+            _config.GcThresholdBytes = bytes;
+            return this;
+        }
+    }
 }
@@ -0,0 +1,151 @@
+using System.Diagnostics;
+using System.Diagnostics.Metrics;
+using System.Reflection;
+
+namespace ScriptBox;
+
+/// <summary>
+/// Names under which ScriptBox publishes metrics (<see cref="Meter"/>) and traces
+/// (<see cref="ActivitySource"/>). Subscribe to them with OpenTelemetry
+/// (<c>AddMeter(ScriptBoxDiagnostics.MeterName)</c>, <c>AddSource(ScriptBoxDiagnostics.ActivitySourceName)</c>)
+/// or any other listener; nothing is recorded while no one listens.
+/// </summary>
+/// <remarks>
+/// Instruments:
+/// <list type="bullet">
+/// <item><c>scriptbox.script.duration</c> (ms): whole script runs, tagged <c>outcome</c>
+/// (<c>success</c>, <c>error</c>, <c>timeout</c>, <c>cancelled</c>).</item>
+/// <item><c>scriptbox.phase.duration</c> (ms): <c>phase</c> is <c>instantiate</c>, <c>bootstrap</c>,
+/// <c>evaluate</c> (user code, including resumptions after async host calls) or <c>result</c>
+/// (reading and decoding the result on the host).</item>
+/// <item><c>scriptbox.host_call.duration</c> (ms): host calls tagged with their <c>method</c>;
+/// calls to methods that do not exist are tagged <c>unknown</c>.</item>
+/// <item><c>scriptbox.guest.heap_size</c> (bytes): QuickJS heap after each run, on modules
+/// that track allocations.</item>
+/// </list>
+/// Every run is a <c>scriptbox.script</c> activity with one child per phase and host call.
+/// </remarks>
+public static class ScriptBoxDiagnostics
+{
+    public const string MeterName = "ScriptBox";
+
+    public const string ActivitySourceName = "ScriptBox";
+
+    private static readonly string? Version = typeof(ScriptBoxDiagnostics).Assembly
+        .GetCustomAttribute<AssemblyInformationalVersionAttribute>()?.InformationalVersion;
+
+    internal static readonly ActivitySource ActivitySource = new(ActivitySourceName, Version);
+
+    internal static readonly Meter Meter = new(MeterName, Version);
+
+    internal static readonly Histogram<double> ScriptDuration = Meter.CreateHistogram<double>(
+        "scriptbox.script.duration", "ms", "Duration of script runs");
+
+    internal static readonly Histogram<double> PhaseDuration = Meter.CreateHistogram<double>(
+        "scriptbox.phase.duration", "ms", "Time spent in each phase of a script run");
+
+    internal static readonly Histogram<double> HostCallDuration = Meter.CreateHistogram<double>(
+        "scriptbox.host_call.duration", "ms", "Duration of host calls made by scripts");
+
+    internal static readonly Histogram<long> GuestHeapSize = Meter.CreateHistogram<long>(
+        "scriptbox.guest.heap_size", "By", "QuickJS heap in use after a script run");
+
+    internal static TelemetryScope StartPhase(string phase) =>
+        new(PhaseDuration, "phase", phase, "scriptbox." + phase);
+
+    /// <summary>
+    /// Tag for host calls to methods that are neither registered nor built in. Scripts choose the
+    /// method names they call, so tagging them as given would let a script create any number of series.
+    /// </summary>
+    internal const string UnknownHostMethod = "unknown";
+
+    internal static TelemetryScope StartHostCall(string method) =>
+        new(HostCallDuration, "method", method, "scriptbox.host_call");
+
+    internal static TelemetryScope StartScript() =>
+        new(ScriptDuration, "outcome", null, "scriptbox.script");
+}
+
+/// <summary>
+/// Times one span of work into a histogram and, when someone traces, an activity.
+/// Costs a timestamp when nothing listens.
+/// </summary>
+internal struct TelemetryScope : IDisposable
+{
+    private readonly Histogram<double> _histogram;
+    private readonly string _tagName;
+    private string? _tagValue;
+    private readonly Activity? _activity;
+    private readonly long _started;
+
+    public TelemetryScope(Histogram<double> histogram, string tagName, string? tagValue, string activityName)
+    {
+        _histogram = histogram;
+        _tagName = tagName;
+        _tagValue = tagValue;
+        _activity = ScriptBoxDiagnostics.ActivitySource.StartActivity(activityName);
+        if (tagValue is not null)
+        {
+            _activity?.SetTag("scriptbox." + tagName, tagValue);
+        }
+
+        _started = Stopwatch.GetTimestamp();
+    }
+
+    /// <summary>
+    /// Sets the tag given later, such as the outcome of a script.
+    /// </summary>
+    public void SetTag(string value)
+    {
+        _tagValue = value;
+        _activity?.SetTag("scriptbox." + _tagName, value);
+    }
+
+    public void SetError(Exception exception)
+    {
+        _activity?.SetStatus(ActivityStatusCode.Error, exception.Message);
+    }
+
+    /// <summary>
+    /// Ends the scope when <paramref name="call"/> finishes. While the call is pending its
+    /// activity stays current only within the call, not in the code that started it.
+    /// </summary>
+    public Task<string> Observe(Task<string> call)
+    {
+        if (call.IsCompleted)
+        {
+            Dispose();
+            return call;
+        }
+
+        if (_activity is not null && Activity.Current == _activity)
+        {
+            Activity.Current = _activity.Parent;
+        }
+
+        return ObserveAsync(this, call);
+    }
+
+    public void Dispose()
+    {
+        if (_histogram is not null && _histogram.Enabled)
+        {
+            var elapsedMs = (Stopwatch.GetTimestamp() - _started) * 1000.0 / Stopwatch.Frequency;
+            _histogram.Record(elapsedMs, new KeyValuePair<string, object?>(_tagName, _tagValue));
+        }
+
+        _activity?.Dispose();
+    }
+
+    private static async Task<string> ObserveAsync(TelemetryScope scope, Task<string> call)
+    {
+        try
+        {
+            return await call.ConfigureAwait(false);
+        }
+        finally
+        {
+            scope.Dispose();
+        }
+    }
+}
@@ -16,4 +16,22 @@ public class ScriptExecutionResult
     /// The console logs captured during execution.
     /// </summary>
     public IList<string> Logs { get; set; } = new List<string>();
+
+    /// <summary>
+    /// Why the script failed, for results of <see cref="IScriptBox.ExecuteBatchAsync"/>;
+    /// <see cref="Result"/> is null then. Single executions throw instead and leave this null.
+    /// </summary>
+    public Exception? Error { get; set; }
+
+    /// <summary>
+    /// QuickJS heap statistics when the script finished. Null unless enabled with
+    /// <see cref="ScriptBoxBuilder.WithGuestMemoryStats"/> and supported by the WASM module.
+    /// </summary>
+    public GuestMemoryStats? Memory { get; set; }
+
+    /// <summary>
+    /// Sampled JavaScript call stacks of the run. Null unless enabled with
+    /// <see cref="ScriptBoxBuilder.WithProfiling"/> and supported by the WASM module.
+    /// </summary>
+    public ScriptProfile? Profile { get; set; }
 }
@@ -0,0 +1,144 @@
+using System.IO;
+using System.Text;
+
+namespace ScriptBox;
+
+/// <summary>
+/// Sampled JavaScript call stacks of one script run, collected when enabled with
+/// <see cref="ScriptBoxBuilder.WithProfiling"/>. <see cref="WriteFolded"/> writes the collapsed
+/// stack format read by flamegraph.pl, inferno and speedscope.
+/// </summary>
+/// <remarks>
+/// Frames are <c>function (file:line)</c>, outermost first. Stacks hold as many frames as
+/// QuickJS records for an <c>Error</c>, so very deep recursion loses its outermost frames.
+/// </remarks>
+public sealed class ScriptProfile
+{
+    internal ScriptProfile(TimeSpan sampleInterval, IReadOnlyDictionary<string, int> stacks, int sampleCount, int droppedSamples)
+    {
+        SampleInterval = sampleInterval;
+        Stacks = stacks;
+        SampleCount = sampleCount;
+        DroppedSamples = droppedSamples;
+    }
+
+    /// <summary>
+    /// Requested time between samples. Samples are taken at interpreter interrupt checks,
+    /// so the actual spacing is at least this.
+    /// </summary>
+    public TimeSpan SampleInterval { get; }
+
+    /// <summary>
+    /// Samples per stack, keyed by the <c>;</c>-separated frames of the stack.
+    /// </summary>
+    public IReadOnlyDictionary<string, int> Stacks { get; }
+
+    /// <summary>
+    /// Samples recorded in <see cref="Stacks"/>.
+    /// </summary>
+    public int SampleCount { get; }
+
+    /// <summary>
+    /// Samples lost because the guest's sample buffer was full or a stack could not be captured.
+    /// </summary>
+    public int DroppedSamples { get; }
+
+    /// <summary>
+    /// Writes one <c>frames count</c> line per stack.
+    /// </summary>
+    public void WriteFolded(TextWriter writer)
+    {
+        if (writer is null)
+        {
+            throw new ArgumentNullException(nameof(writer));
+        }
+
+        foreach (var stack in Stacks.OrderBy(entry => entry.Key, StringComparer.Ordinal))
+        {
+            writer.Write(stack.Key);
+            writer.Write(' ');
+            writer.WriteLine(stack.Value);
+        }
+    }
+
+    /// <summary>
+    /// The profile in collapsed stack format; see <see cref="WriteFolded"/>.
+    /// </summary>
+    public string ToFoldedString()
+    {
+        using var writer = new StringWriter();
+        WriteFolded(writer);
+        return writer.ToString();
+    }
+
+    /// <summary>
+    /// Folds the guest's sample records: NUL-terminated <c>Error().stack</c> texts, where an
+    /// empty record repeats the previous stack.
+    /// </summary>
+    internal static ScriptProfile Parse(byte[] records, TimeSpan sampleInterval, int droppedSamples)
+    {
+        var stacks = new Dictionary<string, int>(StringComparer.Ordinal);
+        var sampleCount = 0;
+        string? previous = null;
+        var start = 0;
+        for (var i = 0; i < records.Length; i++)
+        {
+            if (records[i] != 0)
+            {
+                continue;
+            }
+
+            var stack = i == start ? previous : Fold(Encoding.UTF8.GetString(records, start, i - start));
+            start = i + 1;
+            if (stack is null)
+            {
+                continue;
+            }
+
+            stacks[stack] = stacks.TryGetValue(stack, out var count) ? count + 1 : 1;
+            sampleCount++;
+            previous = stack;
+        }
+
+        return new ScriptProfile(sampleInterval, stacks, sampleCount, droppedSamples);
+    }
+
+    /// <summary>
+    /// Turns QuickJS backtrace lines (<c>    at name (file:line:column)</c>, innermost first)
+    /// into <c>;</c>-separated frames, outermost first.
+    /// </summary>
+    internal static string Fold(string backtrace)
+    {
+        var frames = new List<string>();
+        foreach (var rawLine in backtrace.Split('\n'))
+        {
+            var line = rawLine.Trim();
+            if (line.Length == 0)
+            {
+                continue;
+            }
+
+            if (line.StartsWith("at ", StringComparison.Ordinal))
+            {
+                line = line.Substring(3);
+            }
+
+            // Drop the column, so samples anywhere on a line share one frame
+            var open = line.LastIndexOf('(');
+            if (open >= 0 && line.EndsWith(")", StringComparison.Ordinal))
+            {
+                var location = line.Substring(open + 1, line.Length - open - 2);
+                var lastColon = location.LastIndexOf(':');
+                if (lastColon > 0 && location.IndexOf(':') != lastColon)
+                {
+                    line = line.Substring(0, open + 1) + location.Substring(0, lastColon) + ")";
+                }
+            }
+
+            frames.Add(line.Replace(';', ','));
+        }
+
+        frames.Reverse();
+        return frames.Count == 0 ? "(unknown)" : string.Join(";", frames);
+    }
+}
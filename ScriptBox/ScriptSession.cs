@@ -7,24 +7,42 @@ namespace ScriptBox;
 
 /// <summary>
 /// Represents an isolated execution context for running user scripts.
+/// A session leases a warm WASM instance from the pool for its lifetime; every
+/// script still starts from a fresh JavaScript global scope, unless the session was
+/// created with <see cref="ScriptSessionOptions.PersistState"/>.
 /// </summary>
 public sealed class ScriptSession : IAsyncDisposable
 {
     private readonly IWasmScriptExecutor _executor;
-    private readonly string _bootstrapCode;
+    private readonly WasmInstanceLease _lease;
+    private readonly BootstrapArtifact _bootstrap;
     private readonly TimeSpan _timeout;
 
     internal ScriptSession(
         IWasmScriptExecutor executor,
-        string bootstrapCode,
-        TimeSpan timeout)
+        BootstrapArtifact bootstrap,
+        TimeSpan timeout,
+        bool persistState = false,
+        long? maxMemoryBytes = null)
     {
         _executor = executor ?? throw new ArgumentNullException(nameof(executor));
-        _bootstrapCode = bootstrapCode ?? string.Empty;
+        _lease = executor.CreateLease(persistState, maxMemoryBytes);
+        _bootstrap = bootstrap ?? BootstrapArtifact.Empty;
         _timeout = timeout;
     }
 
-    public Task<object?> RunAsync(string userScript, CancellationToken cancellationToken = default)
+    /// <summary>
+    /// True when scripts in this session share one JavaScript context.
+    /// </summary>
+    public bool PersistsState => _lease.PersistsState;
+
+    /// <summary>
+    /// Executes a script and returns its result. No thread is blocked while the script
+    /// awaits host calls made through <c>__scriptbox.hostCallAsync</c>.
+    /// </summary>
+    /// <param name="userScript">The script to execute.</param>
+    /// <param name="cancellationToken">Cancels waiting on host calls and is passed to their handlers.</param>
+    public async Task<object?> RunAsync(string userScript, CancellationToken cancellationToken = default)
     {
         if (userScript is null)
         {
@@ -33,15 +51,13 @@ public sealed class ScriptSession : IAsyncDisposable
 
         cancellationToken.ThrowIfCancellationRequested();
 
-        var script = string.IsNullOrWhiteSpace(_bootstrapCode)
-            ? userScript
-            : string.Concat(_bootstrapCode, "\n", userScript);
-
         var timeoutMs = ConvertTimeoutToMilliseconds(_timeout);
-        var executionResult = _executor.ExecuteScript(script, timeoutMs);
+        var executionResult = await _executor
+            .ExecuteScriptAsync(_lease, _bootstrap, userScript, timeoutMs, cancellationToken)
+            .ConfigureAwait(false);
 
         cancellationToken.ThrowIfCancellationRequested();
-        return Task.FromResult<object?>(executionResult.Result);
+        return executionResult.Value;
     }
 
     /// <summary>
@@ -50,7 +66,7 @@ public sealed class ScriptSession : IAsyncDisposable
     /// <param name="userScript">The script to execute.</param>
     /// <param name="cancellationToken">Cancellation token.</param>
     /// <returns>A result containing the return value and logs.</returns>
-    public Task<ScriptExecutionResult> ExecuteAsync(string userScript, CancellationToken cancellationToken = default)
+    public async Task<ScriptExecutionResult> ExecuteAsync(string userScript, CancellationToken cancellationToken = default)
     {
         if (userScript is null)
         {
@@ -59,30 +75,76 @@ public sealed class ScriptSession : IAsyncDisposable
 
         cancellationToken.ThrowIfCancellationRequested();
 
-        var script = string.IsNullOrWhiteSpace(_bootstrapCode)
-            ? userScript
-            : string.Concat(_bootstrapCode, "\n", userScript);
-
         var timeoutMs = ConvertTimeoutToMilliseconds(_timeout);
-        var executionResult = _executor.ExecuteScript(script, timeoutMs);
+        var executionResult = await _executor
+            .ExecuteScriptAsync(_lease, _bootstrap, userScript, timeoutMs, cancellationToken)
+            .ConfigureAwait(false);
 
         cancellationToken.ThrowIfCancellationRequested();
-        return Task.FromResult(new ScriptExecutionResult
+        return new ScriptExecutionResult
         {
-            Result = executionResult.Result,
-            Logs = executionResult.Logs
-        });
+            Result = executionResult.Value,
+            Logs = executionResult.Logs,
+            Memory = executionResult.Memory,
+            Profile = executionResult.Profile
+        };
     }
 
+    /// <summary>
+    /// Runs a prepared script with <paramref name="input"/> as its argument. The input is
+    /// serialized to JSON and parsed in the guest, so it never becomes part of the script source.
+    /// </summary>
+    /// <param name="script">A script from <see cref="IScriptBox.Prepare"/>.</param>
+    /// <param name="input">The argument passed to the script; must be JSON serializable.</param>
+    /// <param name="cancellationToken">Cancels waiting on host calls and is passed to their handlers.</param>
+    public async Task<object?> RunAsync(PreparedScript script, object? input = null, CancellationToken cancellationToken = default)
+    {
+        var executionResult = await ExecutePreparedAsync(script, input, cancellationToken).ConfigureAwait(false);
+        return executionResult.Value;
+    }
+
+    /// <summary>
+    /// Runs a prepared script with <paramref name="input"/> and returns the result along with any console logs.
+    /// </summary>
+    /// <param name="script">A script from <see cref="IScriptBox.Prepare"/>.</param>
+    /// <param name="input">The argument passed to the script; must be JSON serializable.</param>
+    /// <param name="cancellationToken">Cancellation token.</param>
+    public async Task<ScriptExecutionResult> ExecuteAsync(PreparedScript script, object? input = null, CancellationToken cancellationToken = default)
+    {
+        var executionResult = await ExecutePreparedAsync(script, input, cancellationToken).ConfigureAwait(false);
+        return new ScriptExecutionResult
+        {
+            Result = executionResult.Value,
+            Logs = executionResult.Logs,
+            Memory = executionResult.Memory,
+            Profile = executionResult.Profile
+        };
+    }
+
+    /// <summary>
+    /// Returns the leased instance to the pool, freeing any state kept by the session.
+    /// </summary>
     public ValueTask DisposeAsync()
     {
-#if NETSTANDARD2_0
-        return default;
-#elif NETSTANDARD2_1
-        return new ValueTask(Task.CompletedTask);
-#else
-        return ValueTask.CompletedTask;
-#endif
+        return new ValueTask(_lease.DisposeAsync());
+    }
+
+    private async Task<WasmExecutionResult> ExecutePreparedAsync(PreparedScript script, object? input, CancellationToken cancellationToken)
+    {
+        if (script is null)
+        {
+            throw new ArgumentNullException(nameof(script));
+        }
+
+        cancellationToken.ThrowIfCancellationRequested();
+
+        var timeoutMs = ConvertTimeoutToMilliseconds(_timeout);
+        var executionResult = await _executor
+            .ExecuteScriptAsync(_lease, _bootstrap, script, input, timeoutMs, cancellationToken)
+            .ConfigureAwait(false);
+
+        cancellationToken.ThrowIfCancellationRequested();
+        return executionResult;
     }
 
     private static int? ConvertTimeoutToMilliseconds(TimeSpan timeout)
@@ -0,0 +1,40 @@
+using System;
+
+namespace ScriptBox;
+
+/// <summary>
+/// Options for <see cref="IScriptBox.CreateSession(ScriptSessionOptions)"/>.
+/// </summary>
+public sealed class ScriptSessionOptions
+{
+    /// <summary>
+    /// Timeout for each script run in the session. Null uses the ScriptBox default.
+    /// </summary>
+    public TimeSpan? Timeout { get; set; }
+
+    /// <summary>
+    /// Keep one JavaScript context for the lifetime of the session instead of a fresh one per script.
+    /// The bootstrap runs once, in the first script's context, and values a script stores on
+    /// <c>globalThis</c> are visible to the scripts after it. Each script still runs in its own
+    /// function, so its <c>let</c>/<c>const</c> declarations stay local to it.
+    /// A timeout, cancellation or host trap discards the state and the next script starts over;
+    /// an exception thrown by the script does not. The state is freed when the session is disposed.
+    /// Requires a WASM module built with the context and bytecode APIs.
+    /// </summary>
+    public bool PersistState { get; set; }
+
+    /// <summary>
+    /// With <see cref="PersistState"/>, the most WASM linear memory (in bytes) the session's instance
+    /// may use. A script that leaves the instance above it fails and the session state is discarded.
+    /// Linear memory includes the QuickJS runtime itself and never shrinks. Null means no limit.
+    /// </summary>
+    public long? MaxMemoryBytes { get; set; }
+
+    internal void Validate()
+    {
+        if (MaxMemoryBytes is <= 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(MaxMemoryBytes), "MaxMemoryBytes must be positive");
+        }
+    }
+}
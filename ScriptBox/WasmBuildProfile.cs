@@ -0,0 +1,17 @@
+namespace ScriptBox;
+
+/// <summary>
+/// Optimization profile of the embedded QuickJS WASM module.
+/// </summary>
+public enum WasmBuildProfile
+{
+    /// <summary>
+    /// Built with <c>-O0</c> (<c>build.sh</c>). Slower, but easiest to diagnose.
+    /// </summary>
+    Debug,
+
+    /// <summary>
+    /// Built with <c>-O3</c>, LTO and <c>wasm-opt</c> (<c>build.sh --release</c>).
+    /// </summary>
+    Release
+}
@@ -12,9 +12,45 @@ function createToolProxy(toolId) {
     }
     return function () { throw new Error("ScriptBox not initialized"); };
 }
+const hasOwn = (obj, key) => Object.prototype.hasOwnProperty.call(obj, key);
+/**
+ * Wraps target so each tool proxy is created the first time the script touches it.
+ * toolIds maps tool names to tool IDs; enumerating the namespace creates the rest.
+ */
+function createLazyNamespace(target, toolIds) {
+    const isPending = (name) => typeof name === "string" && hasOwn(toolIds, name) && !hasOwn(target, name);
+    const materialize = (name) => {
+        const proxy = createToolProxy(toolIds[name]);
+        target[name] = proxy;
+        return proxy;
+    };
+    return new Proxy(target, {
+        get(t, name, receiver) {
+            return isPending(name) ? materialize(name) : Reflect.get(t, name, receiver);
+        },
+        has(t, name) {
+            return isPending(name) || Reflect.has(t, name);
+        },
+        getOwnPropertyDescriptor(t, name) {
+            if (isPending(name)) {
+                materialize(name);
+            }
+            return Reflect.getOwnPropertyDescriptor(t, name);
+        },
+        ownKeys(t) {
+            for (const name of Object.keys(toolIds)) {
+                if (isPending(name)) {
+                    materialize(name);
+                }
+            }
+            return Reflect.ownKeys(t);
+        }
+    });
+}
 /**
  * Initialize __scriptbox.utils namespace and populate it with tool proxies.
  * This function should be called after scriptBoxInput is defined.
+ * Proxies are created lazily, so startup does not pay for tools a script never calls.
  */
 function initializeTools() {
     try {
@@ -35,24 +71,23 @@ function initializeTools() {
         }
         if (!Array.isArray(descriptors) || descriptors.length === 0)
             return;
-        if (!root.__scriptbox.utils) {
-            root.__scriptbox.utils = {};
-        }
+        const utilsIds = Object.create(null);
+        const pluginIds = Object.create(null);
         for (const descriptor of descriptors) {
             const toolId = descriptor.id;
             const toolName = descriptor.name;
             const pluginName = descriptor.plugin;
             if (!toolId || !toolName)
                 continue;
-            const proxy = createToolProxy(toolId);
-            root.__scriptbox.utils[toolName] = proxy;
+            utilsIds[toolName] = toolId;
             if (pluginName) {
-                if (!root[pluginName]) {
-                    root[pluginName] = {};
-                }
-                root[pluginName][toolName] = proxy;
+                (pluginIds[pluginName] || (pluginIds[pluginName] = Object.create(null)))[toolName] = toolId;
             }
         }
+        root.__scriptbox.utils = createLazyNamespace(root.__scriptbox.utils || {}, utilsIds);
+        for (const pluginName of Object.keys(pluginIds)) {
+            root[pluginName] = createLazyNamespace(root[pluginName] || {}, pluginIds[pluginName]);
+        }
         // Alias assistantApi.utils
         root.assistantApi = root.assistantApi || {};
         root.assistantApi.utils = root.__scriptbox.utils;
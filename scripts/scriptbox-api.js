@@ -6,6 +6,28 @@
   }
 
   var make = __scriptbox.createMethod;
+  var makeAsync = __scriptbox.createAsyncMethod;
+
+  // Host-side reads are clamped to SandboxConfiguration.MaxStreamReadSize
+  var DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+  function wrapStream(handle, stream) {
+    stream.handle = handle;
+    stream.read = function (maxBytes) {
+      return __scriptbox.hostCall('StreamRead', [handle, maxBytes || DEFAULT_CHUNK_SIZE]);
+    };
+    stream.readAsync = function (maxBytes) {
+      return __scriptbox.hostCallAsync('StreamRead', [handle, maxBytes || DEFAULT_CHUNK_SIZE]);
+    };
+    stream.close = function () {
+      return __scriptbox.hostCall('StreamClose', [handle]);
+    };
+    return Object.freeze(stream);
+  }
+
+  function wrapHttpStream(opened) {
+    return wrapStream(opened.handle, { status: opened.status, headers: opened.headers });
+  }
 
   var api = {
     add: make('Add'),
@@ -16,7 +38,10 @@
       listFiles: make('FileSystemListFiles'),
       exists: make('FileSystemExists'),
       delete: make('FileSystemDelete'),
-      createDirectory: make('FileSystemCreateDirectory')
+      createDirectory: make('FileSystemCreateDirectory'),
+      open: function (path) {
+        return wrapStream(__scriptbox.hostCall('FileSystemOpenRead', [path]), {});
+      }
     },
     http: {
       get: make('HttpGet'),
@@ -26,6 +51,20 @@
       },
       request: function (options) {
         return __scriptbox.hostCall('HttpRequest', [JSON.stringify(options)]);
+      },
+      getAsync: makeAsync('HttpGet'),
+      postAsync: function (url, data) {
+        var dataJson = typeof data === 'string' ? data : JSON.stringify(data);
+        return __scriptbox.hostCallAsync('HttpPost', [url, dataJson]);
+      },
+      requestAsync: function (options) {
+        return __scriptbox.hostCallAsync('HttpRequest', [JSON.stringify(options)]);
+      },
+      open: function (options) {
+        return wrapHttpStream(__scriptbox.hostCall('HttpOpen', [JSON.stringify(options)]));
+      },
+      openAsync: function (options) {
+        return __scriptbox.hostCallAsync('HttpOpen', [JSON.stringify(options)]).then(wrapHttpStream);
       }
     }
   };
@@ -4,10 +4,38 @@ interface ScriptBoxBridge {
    */
   hostCall(method: string, args: unknown[]): unknown;
 
+  /**
+   * Invoke a host method without blocking; resolves with the result once the host finishes.
+   */
+  hostCallAsync(method: string, args: unknown[]): Promise<unknown>;
+
+  /**
+   * Invoke several host methods in one round trip. The host runs them concurrently;
+   * resolves with the results in order, or rejects with the first call's error.
+   */
+  hostCallAll(calls: ScriptBoxHostCall[]): Promise<unknown[]>;
+
   /**
    * Create a function that forwards calls to the specified host method.
    */
   createMethod(method: string): (...args: unknown[]) => unknown;
+
+  /**
+   * Create a function that forwards calls to the specified host method asynchronously.
+   */
+  createAsyncMethod(method: string): (...args: unknown[]) => Promise<unknown>;
+
+  /**
+   * Register numeric IDs for host methods (keys are lower-cased method names).
+   * Called by the host bootstrap; later calls to those methods are sent by ID,
+   * as MessagePack through __host.bridgeBinary when options.binary is set.
+   */
+  registerMethodIds(table: Record<string, number>, options?: { binary?: boolean }): void;
+}
+
+interface ScriptBoxHostCall {
+  method: string;
+  args?: unknown[];
 }
 
 declare const __scriptbox: ScriptBoxBridge;
@@ -27,6 +55,25 @@ interface FileSystemApi {
   exists(path: string): boolean;
   delete(path: string): void;
   createDirectory(path: string): void;
+  /** Opens a file for chunked reading; close the stream when done. */
+  open(path: string): HostStream;
+}
+
+/**
+ * A host file or HTTP body read in chunks. Reads return UTF-8 text of at most `maxBytes`
+ * bytes (default 64KB, clamped by the host) and `null` once the end is reached.
+ * Streams still open when the script finishes are closed by the host.
+ */
+interface HostStream {
+  readonly handle: number;
+  read(maxBytes?: number): string | null;
+  readAsync(maxBytes?: number): Promise<string | null>;
+  close(): boolean;
+}
+
+interface HttpStream extends HostStream {
+  readonly status: number;
+  readonly headers: Record<string, string>;
 }
 
 interface HttpRequestOptions {
@@ -46,6 +93,12 @@ interface HttpApi {
   get(url: string): string;
   post(url: string, data: any): string;
   request(options: HttpRequestOptions): HttpResponse;
+  getAsync(url: string): Promise<string>;
+  postAsync(url: string, data: any): Promise<string>;
+  requestAsync(options: HttpRequestOptions): Promise<HttpResponse>;
+  /** Like request, but returns once the headers arrive and leaves the body to be read in chunks. */
+  open(options: HttpRequestOptions): HttpStream;
+  openAsync(options: HttpRequestOptions): Promise<HttpStream>;
 }
 
 interface ScriptBoxApi {
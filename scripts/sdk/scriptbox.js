@@ -22,10 +22,7 @@
     return result;
   }
 
-  function callHost(method, args) {
-    var payload = JSON.stringify({ method: method, args: toArgsArray(args) });
-    var response = __host.bridge(payload);
-
+  function parseResponse(method, response) {
     if (response === null || typeof response === 'undefined') {
       throw new Error('Host returned null response for method ' + method);
     }
@@ -38,19 +35,148 @@
     return parsed ? parsed.result : null;
   }
 
+  // Lower-cased method name -> numeric ID, published by the host at startup.
+  // Calls by ID skip the name lookup on the host; unknown names still go by name.
+  var methodIds = Object.create(null);
+
+  // Set by the host (WithBinaryHostCalls): calls by ID go through __host.bridgeBinary,
+  // which encodes the arguments natively instead of through JSON.stringify/JSON.parse.
+  var binaryCalls = false;
+
+  // Modules with __host.invoke build the request and unwrap the response envelope in C, and
+  // take array-likes such as `arguments` as they are. Older modules go through JSON here.
+  var nativeCalls = typeof __host.invoke === 'function';
+
+  function registerMethodIds(table, options) {
+    binaryCalls = !!(options && options.binary) && typeof __host.bridgeBinary === 'function';
+    for (var name in table) {
+      if (Object.prototype.hasOwnProperty.call(table, name)) {
+        methodIds[name] = table[name];
+      }
+    }
+  }
+
+  function lookupMethodId(method) {
+    var id = methodIds[method.toLowerCase()];
+    return typeof id === 'number' ? id : -1;
+  }
+
+  function encodeCall(method, args, id) {
+    if (id >= 0) {
+      return '{"id":' + id + ',"args":' + JSON.stringify(toArgsArray(args)) + '}';
+    }
+
+    return JSON.stringify({ method: method, args: toArgsArray(args) });
+  }
+
+  function sendCall(method, args, id) {
+    if (binaryCalls && id >= 0) {
+      return __host.bridgeBinary(id, nativeCalls ? args : toArgsArray(args));
+    }
+    if (nativeCalls) {
+      return __host.invoke(id >= 0 ? id : method, args);
+    }
+    return parseResponse(method, __host.bridge(encodeCall(method, args, id)));
+  }
+
+  // Resolves once the host finished the call; the script keeps running meanwhile,
+  // and the host does not block a thread while the call is in flight.
+  function sendCallAsync(method, args, id) {
+    var payload = encodeCall(method, args, id);
+
+    if (typeof __host.bridgeAsync !== 'function') {
+      // Older WASM modules: run synchronously, still hand back a promise
+      return new Promise(function (resolve) {
+        resolve(parseResponse(method, __host.bridge(payload)));
+      });
+    }
+
+    return __host.bridgeAsync(payload).then(function (response) {
+      return parseResponse(method, response);
+    });
+  }
+
+  function callHost(method, args) {
+    return sendCall(method, args, lookupMethodId(method));
+  }
+
+  function callHostAsync(method, args) {
+    return sendCallAsync(method, args, lookupMethodId(method));
+  }
+
+  // Sends every call in one host.batch request. The host dispatches them concurrently,
+  // so the batch takes about as long as its slowest call. Resolves with the results in
+  // order, or rejects with the first failing call's error.
+  function callHostAll(calls) {
+    if (!calls || typeof calls.length === 'undefined') {
+      throw new Error('hostCallAll expects an array of { method, args } objects');
+    }
+
+    var requests = new Array(calls.length >>> 0);
+    for (var i = 0; i < requests.length; i++) {
+      var call = calls[i];
+      if (!call || typeof call.method !== 'string' || call.method.length === 0) {
+        throw new Error('hostCallAll entry ' + i + ' must have a non-empty method');
+      }
+      var id = lookupMethodId(call.method);
+      requests[i] = id >= 0
+        ? { id: id, args: toArgsArray(call.args) }
+        : { method: call.method, args: toArgsArray(call.args) };
+    }
+
+    if (requests.length === 0) {
+      return Promise.resolve([]);
+    }
+
+    return callHostAsync('host.batch', requests).then(function (responses) {
+      var results = new Array(responses.length);
+      for (var j = 0; j < responses.length; j++) {
+        var response = responses[j];
+        if (response && typeof response === 'object' && response.error) {
+          throw new Error(response.error);
+        }
+        results[j] = response ? response.result : null;
+      }
+      return results;
+    });
+  }
+
   function createMethod(methodName) {
     if (typeof methodName !== 'string' || methodName.length === 0) {
       throw new Error('Method name must be a non-empty string');
     }
 
+    // Resolved on the first call, so proxies created before registerMethodIds still use IDs
+    var id = -1;
+    return function () {
+      if (id < 0) {
+        id = lookupMethodId(methodName);
+      }
+      return sendCall(methodName, arguments, id);
+    };
+  }
+
+  function createAsyncMethod(methodName) {
+    if (typeof methodName !== 'string' || methodName.length === 0) {
+      throw new Error('Method name must be a non-empty string');
+    }
+
+    var id = -1;
     return function () {
-      return callHost(methodName, arguments);
+      if (id < 0) {
+        id = lookupMethodId(methodName);
+      }
+      return sendCallAsync(methodName, arguments, id);
     };
   }
 
   root.__scriptbox = {
     hostCall: callHost,
-    createMethod: createMethod
+    hostCallAsync: callHostAsync,
+    hostCallAll: callHostAll,
+    createMethod: createMethod,
+    createAsyncMethod: createAsyncMethod,
+    registerMethodIds: registerMethodIds
   };
 })(typeof globalThis !== 'undefined'
   ? globalThis